@@ -5,9 +5,10 @@ Controller::Controller() {
 
   // Set the callback in the facade
   facade_->SetSceneUpdateCallback(
-      [this](const std::shared_ptr<DrawSceneData> &sceneData) {
+      [this](const std::shared_ptr<DrawSceneData> &sceneData,
+             SceneChange change) {
         if (sceneUpdateCallback_) {
-          sceneUpdateCallback_(sceneData);
+          sceneUpdateCallback_(sceneData, change);
         }
       });
 }
@@ -17,15 +18,36 @@ std::shared_ptr<Controller> Controller::GetInstance() {
   return instance;
 }
 
-void Controller::SetSceneUpdateCallback(
-    std::function<void(const std::shared_ptr<DrawSceneData> &)> callback) {
+void Controller::SetSceneUpdateCallback(Facade::SceneUpdateCallback callback) {
   sceneUpdateCallback_ = callback;
 }
 
+void Controller::SetLodReadyCallback(Facade::LodReadyCallback callback) {
+  facade_->SetLodReadyCallback(std::move(callback));
+}
+
 std::shared_ptr<DrawSceneData> Controller::LoadScene(const char *filename) {
   return facade_->LoadScene(filename);
 }
 
+void Controller::LoadSceneAsync(const char *filename,
+                                Facade::Dispatcher dispatch,
+                                Facade::LoadProgressCallback on_progress,
+                                Facade::LoadFinishedCallback on_finished) {
+  facade_->LoadSceneAsync(filename, std::move(dispatch), std::move(on_progress),
+                          std::move(on_finished));
+}
+
+void Controller::CancelLoad() { facade_->CancelLoad(); }
+
+void Controller::SetSpatialOrder(bool spatial) {
+  facade_->SetVertexOrder(spatial ? VertexOrder::kMorton : VertexOrder::kFile);
+}
+
+void Controller::SetQuantizedPositions(bool quantized) {
+  facade_->SetQuantizedPositions(quantized);
+}
+
 void Controller::ResetScene() { facade_->resetScenePosition(); }
 
 void Controller::SetScaleX(const int value) {
@@ -64,6 +86,20 @@ void Controller::SetRotationZ(const int value) {
   facade_->RotateZ(value / kRotationCorrection);
 }
 
+void Controller::ApplyTransform(const TransformValues &values) {
+  SceneParameters parameters;
+  parameters.SetScaleX(values.scale / kScaleCorrection);
+  parameters.SetScaleY(values.scale / kScaleCorrection);
+  parameters.SetScaleZ(values.scale / kScaleCorrection);
+  parameters.SetRotationX(values.rotation_x / kRotationCorrection);
+  parameters.SetRotationY(values.rotation_y / kRotationCorrection);
+  parameters.SetRotationZ(values.rotation_z / kRotationCorrection);
+  parameters.SetLocationX(values.location_x / kMoveCorrection);
+  parameters.SetLocationY(values.location_y / kMoveCorrection);
+  parameters.SetLocationZ(values.location_z / kMoveCorrection);
+  facade_->ApplyTransform(parameters);
+}
+
 std::tuple<float, float, float, float, float, float, float, float, float>
 Controller::GetSceneParameters() {
   return facade_->GetSceneParameters();
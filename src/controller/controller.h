@@ -10,6 +10,21 @@
 
 namespace s21 {
 
+/**
+ * @struct TransformValues
+ * @brief A full set of raw transformation values, in the units of the
+ * single-axis Controller setters.
+ */
+struct TransformValues {
+  float scale = 100;     ///< Uniform scale in percent.
+  float rotation_x = 0;  ///< Rotation around the X-axis in degrees.
+  float rotation_y = 0;  ///< Rotation around the Y-axis in degrees.
+  float rotation_z = 0;  ///< Rotation around the Z-axis in degrees.
+  float location_x = 0;  ///< Translation along the X-axis.
+  float location_y = 0;  ///< Translation along the Y-axis.
+  float location_z = 0;  ///< Translation along the Z-axis.
+};
+
 /**
  * @brief The Controller class provides an interface for manipulating and
  * updating a 3D scene.
@@ -47,10 +62,18 @@ class Controller {
    * The provided callback is used to notify listeners when the scene is updated
    * and needs to be redrawn.
    *
-   * @param callback A function taking a shared pointer to DrawSceneData.
+   * @param callback A function taking a shared pointer to DrawSceneData and
+   * the kind of change, which tells whether GPU buffers must be refreshed.
+   */
+  void SetSceneUpdateCallback(Facade::SceneUpdateCallback callback);
+
+  /**
+   * @brief Sets the callback that receives the levels of detail of scenes
+   * loaded asynchronously.
+   *
+   * @param callback Called on the thread that started the load.
    */
-  void SetSceneUpdateCallback(
-      std::function<void(const std::shared_ptr<DrawSceneData> &)> callback);
+  void SetLodReadyCallback(Facade::LodReadyCallback callback);
 
   /**
    * @brief Loads a scene from a specified file.
@@ -64,6 +87,42 @@ class Controller {
    */
   std::shared_ptr<DrawSceneData> LoadScene(const char *filename);
 
+  /**
+   * @brief Loads a scene from a file on a background thread.
+   *
+   * Delegates to Facade::LoadSceneAsync. The current scene keeps responding
+   * to transformations until the new one replaces it.
+   *
+   * @param filename The file path of the scene to load.
+   * @param dispatch Queues tasks on the calling (GUI) thread.
+   * @param on_progress Receives progress reports on the calling thread.
+   * @param on_finished Receives the loaded scene or the error on the calling
+   * thread.
+   */
+  void LoadSceneAsync(const char *filename, Facade::Dispatcher dispatch,
+                      Facade::LoadProgressCallback on_progress,
+                      Facade::LoadFinishedCallback on_finished);
+
+  /**
+   * @brief Cancels a running asynchronous load.
+   */
+  void CancelLoad();
+
+  /**
+   * @brief Selects whether files opened from now on are sorted spatially.
+   *
+   * @param spatial True to store the vertices in Morton order, false to keep
+   * the order of the file.
+   */
+  void SetSpatialOrder(bool spatial);
+
+  /**
+   * @brief Selects whether files opened from now on get 16-bit positions.
+   *
+   * @param quantized True to encode the positions while loading.
+   */
+  void SetQuantizedPositions(bool quantized);
+
   /**
    * @brief Resets the scene to its default position.
    *
@@ -162,6 +221,16 @@ class Controller {
    */
   void SetRotationZ(const int value);
 
+  /**
+   * @brief Sets scale, rotation and location in one step.
+   *
+   * The values are corrected like those of the single-axis setters and
+   * committed together, so the scene is notified and redrawn once.
+   *
+   * @param values The raw transformation values.
+   */
+  void ApplyTransform(const TransformValues &values);
+
   /**
    * @brief Retrieves the current scene parameters.
    *
@@ -187,8 +256,7 @@ class Controller {
   const float kMoveCorrection = 200.0;
 
   /// Callback function to be executed when the scene is updated.
-  std::function<void(const std::shared_ptr<DrawSceneData> &)>
-      sceneUpdateCallback_;
+  Facade::SceneUpdateCallback sceneUpdateCallback_;
 
   /**
    * @brief Private constructor to enforce singleton pattern.
@@ -1,8 +1,16 @@
 #include <QApplication>
 
 #include "view/main_window.h"
+#include "view/thumbnail_batch.h"
 
 int main(int argc, char *argv[]) {
+  // Batch thumbnails open no window, so they also run without a display,
+  // e.g. with QT_QPA_PLATFORM=offscreen
+  if (ThumbnailBatch::IsRequested(argc, argv)) {
+    QGuiApplication app(argc, argv);
+    return ThumbnailBatch::Run(app.arguments());
+  }
+
   QApplication app(argc, argv);
   MainWindow window(s21::Controller::GetInstance());
   window.show();
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "scene.h"
+
+// Writes a synthetic grid model with two triangles per cell. A shuffled grid
+// lists its vertices in an order unrelated to their position.
+std::string CreateGridObjFile(int rows, int cols, bool shuffled = false) {
+  std::string filename = "bench_scene.obj";
+  std::ofstream out(filename);
+  const uint64_t count = uint64_t(rows) * cols;
+  // A stride coprime with the count visits every vertex once.
+  const uint64_t stride = shuffled ? 1000003 : 1;
+  std::vector<uint64_t> line(count);
+  for (uint64_t k = 0; k < count; ++k) {
+    const uint64_t v = k * stride % count;
+    line[v] = k + 1;
+    out << "v " << v / cols << ' ' << v % cols << " 0\n";
+  }
+  for (int i = 0; i + 1 < rows; ++i) {
+    for (int j = 0; j + 1 < cols; ++j) {
+      const uint64_t a = uint64_t(i) * cols + j;
+      out << "f " << line[a] << ' ' << line[a + 1] << ' ' << line[a + cols]
+          << "\nf " << line[a + 1] << ' ' << line[a + cols + 1] << ' '
+          << line[a + cols] << '\n';
+    }
+  }
+  return filename;
+}
+
+// Reports face storage per face, the time Scene needs to extract edges, the
+// locality of the edge indices and the time of a CPU transform.
+void Run(const std::string& filename,
+         s21::VertexOrder order = s21::VertexOrder::kFile) {
+  s21::OBJData data;
+  data.Parse(filename, 0);
+  const size_t faces = data.FaceCount();
+  const size_t face_bytes =
+      data.face_vertices.capacity() * sizeof(s21::VertexIndices) +
+      data.face_offsets.capacity() * sizeof(uint32_t);
+
+  s21::Scene scene(s21::VertexLayout::kInterleaved, order);
+  auto start = std::chrono::steady_clock::now();
+  auto draw_data = scene.LoadSceneMeshData(std::move(data));
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::cout << filename << "\n  faces: " << faces
+            << "\n  bytes per face: " << static_cast<double>(face_bytes) / faces
+            << "\n  edge extraction: " << elapsed.count() << " ms ("
+            << draw_data->edge_count << " edges)\n  index bytes per edge: "
+            << draw_data->index_data.size() * sizeof(uint16_t) /
+                   static_cast<double>(draw_data->edge_count)
+            << " in " << draw_data->edge_batches.size() << " batches"
+            << "\n  mean index jump: " << draw_data->MeanIndexJump() << '\n';
+
+  s21::Mat4f matrix =
+      s21::TransformMatrixBuilder::CreateRotationMatrix(0.3f, 0.2f, 0.1f);
+  start = std::chrono::steady_clock::now();
+  scene.TransformSceneMeshData(matrix);
+  elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "  transform: " << elapsed.count() << " ms\n";
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    for (int i = 1; i < argc; ++i) Run(argv[i]);
+    return 0;
+  }
+  Run("view/primitives/Monkey.obj");
+  Run("view/primitives/Sphere.obj");
+
+  // About 10M triangles.
+  std::string filename = CreateGridObjFile(5000, 1000);
+  Run(filename);
+  std::remove(filename.c_str());
+
+  // About 2M triangles listed out of order, as read and sorted.
+  filename = CreateGridObjFile(1000, 1000, true);
+  std::cout << "file order, ";
+  Run(filename);
+  std::cout << "Morton order, ";
+  Run(filename, s21::VertexOrder::kMorton);
+  std::remove(filename.c_str());
+  return 0;
+}
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <type_traits>
 
 /**
  * @namespace s21
@@ -40,7 +41,7 @@ struct Vec2f {
   Vec2f(float x, float y) : x(x), y(y) {}
 
   // Default copy and move constructors and assignment operators
-  explicit Vec2f(const Vec2f&) = default;
+  Vec2f(const Vec2f&) = default;
   Vec2f& operator=(const Vec2f&) = default;
   Vec2f(Vec2f&&) = default;
   Vec2f& operator=(Vec2f&&) = default;
@@ -84,12 +85,8 @@ struct Vec2f {
  *
  * This structure represents a 3D vector and provides operations such as
  * addition, subtraction, scalar multiplication, length calculation, and
- * normalization.
- *
- * @note The copy constructor is defined with an empty body, which does not
- * initialize members and may lead to undefined behavior. It is recommended to
- * use `= default` or properly implement it (e.g., `Vec3f(const Vec3f& other) :
- * x(other.x), y(other.y), z(other.z) {}`).
+ * normalization. It is trivially copyable and packed as three floats, so
+ * arrays of it can be uploaded to the GPU as they are.
  */
 struct Vec3f {
   float x{0.0f},  ///< The x-component of the vector, initialized to 0.0f.
@@ -109,15 +106,8 @@ struct Vec3f {
    */
   Vec3f(float x, float y, float z) : x(x), y(y), z(z) {}
 
-  /**
-   * @brief Copy constructor.
-   * @param other The vector to copy from.
-   * @note This implementation is empty, leaving members uninitialized, which is
-   * likely a bug. Consider using `= default` or proper initialization.
-   */
-  explicit Vec3f(const Vec3f&) {}
-
-  // Default assignment operators
+  // Default copy and move constructors and assignment operators
+  Vec3f(const Vec3f&) = default;
   Vec3f& operator=(const Vec3f&) = default;
   Vec3f(Vec3f&&) = default;
   Vec3f& operator=(Vec3f&&) = default;
@@ -167,6 +157,10 @@ struct Vec3f {
   }
 };
 
+static_assert(std::is_trivially_copyable_v<Vec3f> &&
+                  sizeof(Vec3f) == 3 * sizeof(float),
+              "Vec3f arrays are used as packed float arrays");
+
 // 4D Vector
 /**
  * @struct Vec4f
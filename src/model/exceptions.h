@@ -13,6 +13,11 @@ class MeshLoadException : public ViewerException {
   explicit MeshLoadException(const std::string &msg) : ViewerException(msg) {}
 };
 
+class LoadCancelledException : public ViewerException {
+ public:
+  LoadCancelledException() : ViewerException("Loading cancelled") {}
+};
+
 class RenderException : public ViewerException {
  public:
   explicit RenderException(const std::string &msg) : ViewerException(msg) {}
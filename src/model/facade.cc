@@ -1,14 +1,31 @@
 #include "facade.h"
 
+#include "lod/mesh_simplifier.h"
+
 namespace s21 {
+
+namespace {
+
+// Encodes the positions of a scene as 16-bit integers.
+void Quantize(DrawSceneData &data) {
+  data.quantized = std::make_shared<const QuantizedPositions>(
+      data.vertices.data(), data.vertices.size());
+}
+
+}  // namespace
+
 Facade::Facade()
     : fileReader_(std::make_unique<FileReader>()),
       sceneParam_(std::make_unique<SceneParameters>()) {}
 
+Facade::~Facade() { CancelLoad(); }
+
 std::shared_ptr<DrawSceneData> Facade::LoadScene(const char *path) {
+  CancelLoad();
   scene_.reset();
-  scene_ = std::make_unique<Scene>();
+  scene_ = std::make_shared<Scene>(vertexLayout_, vertexOrder_);
   auto sceneData = scene_->LoadSceneMeshData(fileReader_->ReadFile(path));
+  if (sceneData && quantized_) Quantize(*sceneData);
 
   // Store the initial scene data
   if (sceneData) {
@@ -18,6 +35,107 @@ std::shared_ptr<DrawSceneData> Facade::LoadScene(const char *path) {
   return sceneData;
 }
 
+void Facade::LoadSceneAsync(const std::string &path, Dispatcher dispatch,
+                            LoadProgressCallback on_progress,
+                            LoadFinishedCallback on_finished) {
+  CancelLoad();
+  const uint64_t generation = ++loadGeneration_;
+  loadMonitor_ = std::make_shared<LoadMonitor>(
+      [dispatch, on_progress](const LoadProgress &progress) {
+        if (on_progress) {
+          dispatch([on_progress, progress] { on_progress(progress); });
+        }
+      });
+
+  loadThread_ = std::thread([this, path, dispatch, on_finished, generation,
+                             monitor = loadMonitor_, layout = vertexLayout_,
+                             order = vertexOrder_, quantized = quantized_,
+                             lodSettings = lodSettings_] {
+    auto scene = std::make_shared<Scene>(layout, order);
+    std::shared_ptr<DrawSceneData> sceneData;
+    std::exception_ptr error;
+    // Only the vertices move into the scene; the faces, renumbered to the
+    // scene's vertex order, stay for the LODs
+    OBJData data;
+    MeshCache::SourceStamp stamp;
+    try {
+      data = fileReader_->ReadFile(path.c_str(), monitor.get(), &stamp);
+      sceneData = scene->LoadSceneMeshData(std::move(data), monitor.get());
+      if (quantized && sceneData) {
+        Quantize(*sceneData);
+        monitor->ThrowIfCancelled();
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    // Install the result on the owning thread unless a newer load started.
+    dispatch([this, scene, sceneData, error, on_finished, generation,
+              monitor]() mutable {
+      if (generation != loadGeneration_) return;
+      if (!error && monitor->Cancelled()) {
+        error = std::make_exception_ptr(LoadCancelledException());
+      }
+      if (!error) {
+        scene_ = std::move(scene);
+        currentSceneData_ = sceneData;
+      } else {
+        sceneData.reset();
+      }
+      if (on_finished) on_finished(sceneData, error);
+    });
+    if (error || lodSettings.max_levels < 2) return;
+
+    try {
+      auto lods = MakeLods(path, stamp, data, sceneData, lodSettings,
+                           monitor.get());
+      // Level 0 is the scene, encoded above
+      for (size_t i = 1; quantized && i < lods->size(); ++i) {
+        Quantize(*(*lods)[i].data);
+        monitor->ThrowIfCancelled();
+      }
+      dispatch([this, lods, generation] {
+        if (generation != loadGeneration_) return;
+        if (lodReadyCallback_) lodReadyCallback_(lods);
+      });
+    } catch (const LoadCancelledException &) {
+      // A newer load replaces the scene.
+    }
+  });
+}
+
+std::shared_ptr<const LodChain> Facade::MakeLods(
+    const std::string &path, const MeshCache::SourceStamp &stamp,
+    const OBJData &data,
+    const std::shared_ptr<DrawSceneData> &scene,
+    const LodChain::Settings &settings, LoadMonitor *monitor) {
+  constexpr const char *kAttachment = "lod";
+  auto lods = std::make_shared<LodChain>();
+  std::string bytes;
+  if (fileReader_->Cache().LoadAttachment(path, kAttachment, bytes,
+                                          monitor) &&
+      LodChain::Deserialize(bytes, scene, settings, *lods)) {
+    return lods;
+  }
+
+  std::vector<uint8_t> sides;
+  auto triangles =
+      MeshSimplifier::Triangulate(data, scene->vertices.size(), &sides);
+  *lods = LodChain::Build(scene, std::move(triangles), std::move(sides),
+                          settings, monitor);
+  if (lods->size() > 1) {
+    fileReader_->Cache().StoreAttachment(path, stamp, kAttachment,
+                                         lods->Serialize(settings), monitor);
+  }
+  return lods;
+}
+
+void Facade::CancelLoad() {
+  if (loadMonitor_) loadMonitor_->Cancel();
+  if (loadThread_.joinable()) loadThread_.join();
+  loadMonitor_.reset();
+}
+
 std::shared_ptr<Facade> Facade::GetInstance() {
   static auto instance = std::shared_ptr<Facade>(new Facade);
   return instance;
@@ -105,6 +223,13 @@ void Facade::RotateZ(const float value) {
   TransformScene();
 }
 
+void Facade::ApplyTransform(const SceneParameters &parameters) {
+  if (!scene_) return;
+
+  *sceneParam_ = parameters;
+  TransformScene();
+}
+
 std::tuple<float, float, float, float, float, float, float, float, float>
 Facade::GetSceneParameters() {
   if (!scene_) return std::make_tuple(0, 0, 0, 0, 0, 0, 0, 0, 0);
@@ -119,7 +244,7 @@ Facade::GetSceneParameters() {
 void Facade::TransformScene() {
   // Notify about the update if callback is set
   if (sceneUpdateCallback_ && currentSceneData_) {
-    sceneUpdateCallback_(currentSceneData_);
+    sceneUpdateCallback_(currentSceneData_, SceneChange::kTransform);
   }
 }
 }  // namespace s21
\ No newline at end of file
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <exception>
 #include <functional>
+#include <string>
+#include <thread>
 #include <tuple>
 
 #include "filereader.h"
+#include "lod/lod_chain.h"
 #include "scene.h"
 #include "scene_parameters.h"
 
@@ -30,10 +34,44 @@ class Facade {
    * @brief Callback function type for scene updates.
    *
    * This callback is invoked whenever the scene data is updated, passing a
-   * shared pointer to the updated scene data.
+   * shared pointer to the updated scene data and what changed in it.
    */
   using SceneUpdateCallback =
-      std::function<void(const std::shared_ptr<DrawSceneData>&)>;
+      std::function<void(const std::shared_ptr<DrawSceneData>&, SceneChange)>;
+
+  /**
+   * @typedef Dispatcher
+   * @brief Runs a task on the thread that owns the facade, usually the GUI
+   * thread.
+   *
+   * Must not block: it is called from the loading thread and should only
+   * queue the task.
+   */
+  using Dispatcher = std::function<void(std::function<void()>)>;
+
+  /**
+   * @typedef LoadProgressCallback
+   * @brief Receives progress reports of an asynchronous load.
+   */
+  using LoadProgressCallback = std::function<void(const LoadProgress&)>;
+
+  /**
+   * @typedef LoadFinishedCallback
+   * @brief Receives the loaded scene, or the error that stopped the load.
+   *
+   * A cancelled load finishes with a LoadCancelledException.
+   */
+  using LoadFinishedCallback = std::function<void(
+      const std::shared_ptr<DrawSceneData>&, std::exception_ptr)>;
+
+  /**
+   * @typedef LodReadyCallback
+   * @brief Receives the levels of detail of a scene loaded asynchronously.
+   *
+   * Level 0 of the chain is the scene passed to the LoadFinishedCallback.
+   */
+  using LodReadyCallback =
+      std::function<void(const std::shared_ptr<const LodChain>&)>;
 
   // Deleted copy and move constructors and assignment operator to prevent
   // copying/moving
@@ -51,12 +89,11 @@ class Facade {
   static std::shared_ptr<Facade> GetInstance();
 
   /**
-   * @brief Default destructor.
+   * @brief Destructor.
    *
-   * No special cleanup is performed as resource management is handled by smart
-   * pointers.
+   * Cancels a running asynchronous load and waits for its thread.
    */
-  ~Facade() = default;
+  ~Facade();
 
   /**
    * @brief Sets the callback function to be invoked when the scene data
@@ -64,10 +101,54 @@ class Facade {
    * @param callback The callback function to set.
    *
    * The provided callback will be called whenever the scene is modified,
-   * passing the updated scene data.
+   * passing the updated scene data. Transformations are reported as
+   * SceneChange::kTransform, since they leave the vertex data untouched.
    */
   void SetSceneUpdateCallback(SceneUpdateCallback callback);
 
+  /**
+   * @brief Selects how scenes loaded from now on keep their positions.
+   * @param layout The layout used by the CPU transform of new scenes.
+   *
+   * Only callers of Scene::TransformSceneMeshData gain from
+   * VertexLayout::kArrays; the viewer transforms on the GPU and would just
+   * keep a second copy of the positions.
+   */
+  void SetVertexLayout(VertexLayout layout) { vertexLayout_ = layout; }
+
+  /**
+   * @brief Selects the vertex order of scenes loaded from now on.
+   * @param order VertexOrder::kMorton sorts the vertices spatially at load
+   * time.
+   */
+  void SetVertexOrder(VertexOrder order) { vertexOrder_ = order; }
+
+  /**
+   * @brief Selects whether scenes loaded from now on get 16-bit positions.
+   * @param quantized True to fill DrawSceneData::quantized of the scene and
+   * of every level of detail.
+   *
+   * The encoding runs on the loading thread, so the renderer only uploads
+   * it.
+   */
+  void SetQuantizedPositions(bool quantized) { quantized_ = quantized; }
+
+  /**
+   * @brief Sets the callback that receives levels of detail.
+   * @param callback Called on the thread that owns the facade.
+   */
+  void SetLodReadyCallback(LodReadyCallback callback) {
+    lodReadyCallback_ = std::move(callback);
+  }
+
+  /**
+   * @brief Selects the levels of detail built for scenes loaded from now on.
+   * @param settings Shape of the chain; max_levels 1 disables it.
+   */
+  void SetLodSettings(const LodChain::Settings& settings) {
+    lodSettings_ = settings;
+  }
+
   /**
    * @brief Loads a scene from the specified file path.
    * @param path The file path to the scene file (e.g., an OBJ file).
@@ -78,6 +159,36 @@ class Facade {
    */
   std::shared_ptr<DrawSceneData> LoadScene(const char* path);
 
+  /**
+   * @brief Loads a scene on a background thread.
+   * @param path The file path to the scene file.
+   * @param dispatch Queues tasks on the calling thread.
+   * @param on_progress Receives progress reports; may be empty.
+   * @param on_finished Receives the result; may be empty.
+   *
+   * Parsing, normalization and edge building run on a worker thread while
+   * the current scene stays usable. Progress reports and the result are
+   * delivered through dispatch, so both callbacks run on the calling thread.
+   * The new scene replaces the current one right before on_finished is
+   * called. The worker then builds the levels of detail of the scene, or
+   * restores them from the file cache, and hands them to the
+   * LodReadyCallback. Starting another load cancels this one, and its
+   * callbacks are then dropped.
+   */
+  void LoadSceneAsync(const std::string& path, Dispatcher dispatch,
+                      LoadProgressCallback on_progress,
+                      LoadFinishedCallback on_finished);
+
+  /**
+   * @brief Cancels a running asynchronous load and waits for its thread.
+   *
+   * The load finishes with a LoadCancelledException. Every stage of the
+   * load, including cache reads and writes and the LOD passes, checks the
+   * monitor at least every few tens of MB, so the wait is short. Does
+   * nothing if no load is running.
+   */
+  void CancelLoad();
+
   /**
    * @brief Resets the scene's transformation parameters to their default
    * values.
@@ -170,6 +281,15 @@ class Facade {
    */
   void RotateZ(const float value);
 
+  /**
+   * @brief Replaces all transformation parameters at once.
+   * @param parameters The new scale, rotation and location.
+   *
+   * Unlike the single-axis setters, the whole set is committed together and
+   * listeners are notified once, so they never see a partial update.
+   */
+  void ApplyTransform(const SceneParameters& parameters);
+
   /**
    * @brief Retrieves the current transformation parameters of the scene.
    * @return A tuple containing the transformation parameters in the following
@@ -192,14 +312,24 @@ class Facade {
  private:
   std::unique_ptr<FileReader>
       fileReader_;  ///< Manages file reading operations (e.g., OBJ files).
-  std::unique_ptr<Scene>
+  std::shared_ptr<Scene>
       scene_;  ///< Handles the scene data and its processing.
+  VertexLayout vertexLayout_ =
+      VertexLayout::kInterleaved;  ///< Position layout of new scenes.
+  VertexOrder vertexOrder_ = VertexOrder::kFile;  ///< Order of new scenes.
+  bool quantized_ = false;  ///< Whether new scenes get 16-bit positions.
   std::unique_ptr<SceneParameters>
       sceneParam_;  ///< Stores the scene's transformation parameters.
   std::shared_ptr<DrawSceneData>
       currentSceneData_;  ///< Holds the current scene data for rendering.
   SceneUpdateCallback
       sceneUpdateCallback_;  ///< Callback invoked on scene updates.
+  std::thread loadThread_;  ///< Thread of the running asynchronous load.
+  std::shared_ptr<LoadMonitor>
+      loadMonitor_;  ///< Progress and cancellation of the running load.
+  uint64_t loadGeneration_ = 0;  ///< Identifies the latest load request.
+  LodChain::Settings lodSettings_;      ///< Levels built for new scenes.
+  LodReadyCallback lodReadyCallback_;  ///< Receives levels of detail.
 
   /**
    * @brief Private constructor to enforce singleton pattern.
@@ -210,11 +340,30 @@ class Facade {
   Facade();
 
   /**
-   * @brief Applies the current transformation parameters to the scene.
+   * @brief Notifies the listener that the transformation parameters changed.
    *
-   * Uses the SceneParameters to compute and apply a transformation matrix to
-   * the scene, updating the currentSceneData_ accordingly.
+   * The parameters are applied by the renderer as a model matrix, so the
+   * scene data is left as is and reported as SceneChange::kTransform.
    */
   void TransformScene();
+
+  /**
+   * @brief Builds or restores the levels of detail of a loaded scene.
+   * @param path The file the scene was loaded from.
+   * @param stamp Stamp of the file taken before it was read.
+   * @param data The parsed file; its faces are still needed.
+   * @param scene The loaded scene.
+   * @param settings Shape of the chain.
+   * @param monitor Cancels the build.
+   * @return The chain, stored in the file cache if it was built.
+   *
+   * Runs on the loading thread.
+   *
+   * @throws LoadCancelledException if the monitor cancels.
+   */
+  std::shared_ptr<const LodChain> MakeLods(
+      const std::string& path, const MeshCache::SourceStamp& stamp,
+      const OBJData& data, const std::shared_ptr<DrawSceneData>& scene,
+      const LodChain::Settings& settings, LoadMonitor* monitor);
 };
 }  // namespace s21
\ No newline at end of file
@@ -1,8 +1,34 @@
 #include "filereader.h"
 
-s21::OBJData s21::FileReader(const char *path) {
+namespace s21 {
+
+bool FileReader::IsGzip(std::string_view path) {
+  constexpr std::string_view kSuffix = ".gz";
+  return path.size() >= kSuffix.size() &&
+         path.substr(path.size() - kSuffix.size()) == kSuffix;
+}
+
+OBJData FileReader::ReadFile(const char *path, LoadMonitor *monitor,
+                             MeshCache::SourceStamp *stamp) {
+  // Taken first, so a file rewritten while it is parsed is not cached under
+  // its new contents
+  MeshCache::SourceStamp before;
+  const bool stamped = cache_.Enabled() && MeshCache::Stamp(path, before);
+  if (stamp) *stamp = before;
+
   OBJData data;
-  data.Parse(path);
+  if (cache_.Load(path, data, monitor)) return data;
+
+  if (IsGzip(path)) {
+    data.ParseGzip(path, monitor);
+  } else {
+    data.Parse(path, 0, monitor);
+  }
+  if (monitor) monitor->SetStage(LoadProgress::Stage::kNormalizing);
   data.Normalize();
+  if (monitor) monitor->ThrowIfCancelled();
+  if (stamped) cache_.Store(path, before, data, monitor);
   return data;
-}
\ No newline at end of file
+}
+
+}  // namespace s21
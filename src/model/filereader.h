@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string_view>
+
+#include "obj/mesh_cache.h"
 #include "obj/obj_data.h"
 
 namespace s21 {
@@ -10,27 +13,62 @@ namespace s21 {
  *
  * The `FileReader` class offers a simple interface for reading OBJ files. It
  * encapsulates the logic for parsing the file, normalizing the data, and
- * returning the processed information as an `OBJData` object.
+ * returning the processed information as an `OBJData` object. Parsed files
+ * are kept in a MeshCache so reopening them skips the text parser.
  */
 class FileReader {
  public:
+  /**
+   * @brief Creates a reader using the default cache location.
+   */
+  FileReader() : FileReader(MeshCache::DefaultSettings()) {}
+
+  /**
+   * @brief Creates a reader with custom cache settings.
+   * @param cache_settings Cache directory and size limit; an empty directory
+   * disables caching.
+   */
+  explicit FileReader(MeshCache::Settings cache_settings)
+      : cache_(std::move(cache_settings)) {}
+
   /**
    * @brief Reads and processes an OBJ file from the specified path.
    * @param path The file path to the OBJ file to be read.
+   * @param monitor Receives progress and may cancel the load; optional.
+   * @param stamp Receives the stamp of the file taken before it was read,
+   * for caching data derived from it; optional.
    * @return An `OBJData` object containing the parsed and normalized data from
    * the OBJ file.
    *
    * This method performs the following steps:
-   * - Parses the OBJ file located at the given path.
+   * - Returns the cached data if the cache holds an up-to-date snapshot.
+   * - Otherwise parses the OBJ file located at the given path on all hardware
+   * threads. Files ending in ".gz" are streamed through zlib instead, with
+   * decompression and parsing overlapped on two threads.
    * - Normalizes the parsed data to ensure it is suitable for rendering or
    * further processing.
-   * - Returns the resulting `OBJData` object.
+   * - Stores the result in the cache, unless the file changed while it was
+   * parsed, and returns it.
+   *
+   * @throws LoadCancelledException if the monitor cancels the load.
    */
-  OBJData ReadFile(const char *path) {
-    OBJData data;
-    data.Parse(path);
-    data.Normalize();
-    return data;
-  }
+  OBJData ReadFile(const char *path, LoadMonitor *monitor = nullptr,
+                   MeshCache::SourceStamp *stamp = nullptr);
+
+  /**
+   * @brief Checks whether a file is read as gzip-compressed.
+   * @param path The file path.
+   * @return True if the path ends in ".gz".
+   */
+  static bool IsGzip(std::string_view path);
+
+  /**
+   * @brief Returns the cache of parsed files.
+   * @return The cache, also used to store data derived from the files.
+   */
+  MeshCache &Cache() { return cache_; }
+
+ private:
+  MeshCache cache_;  ///< Snapshots of previously parsed files.
 };
 }  // namespace s21
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lod_chain.h"
+#include "mesh_simplifier.h"
+#include "scene.h"
+
+// Parses a model, or builds a bumpy grid of rows x cols vertices if path is
+// empty.
+s21::OBJData LoadModel(const std::string& path, int rows, int cols) {
+  s21::OBJData data;
+  if (!path.empty()) {
+    data.Parse(path, 0);
+    data.Normalize();
+    return data;
+  }
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      const float x = 2.0f * i / rows - 1.0f, y = 2.0f * j / cols - 1.0f;
+      const float z = 0.1f * std::sin(6.0f * x) * std::cos(4.0f * y);
+      data.vertices.emplace_back(x, y, z);
+    }
+  }
+  for (int i = 0; i + 1 < rows; ++i) {
+    for (int j = 0; j + 1 < cols; ++j) {
+      const int a = i * cols + j;
+      for (int v : {a, a + 1, a + cols, a + 1, a + cols + 1, a + cols}) {
+        data.face_vertices.emplace_back(v);
+        if (data.face_vertices.size() % 3 == 0) {
+          data.face_offsets.push_back(data.face_vertices.size());
+        }
+      }
+    }
+  }
+  return data;
+}
+
+// Reports the time to build a chain and the edges and error of its levels.
+void Run(const std::string& name, s21::OBJData data) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<uint8_t> sides;
+  std::vector<uint32_t> triangles =
+      s21::MeshSimplifier::Triangulate(data, data.vertices.size(), &sides);
+  auto full = s21::Scene().LoadSceneMeshData(std::move(data));
+  const s21::LodChain::Settings settings;
+  const s21::LodChain chain =
+      s21::LodChain::Build(full, std::move(triangles), std::move(sides),
+                           settings);
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  const std::string bytes = chain.Serialize(settings);
+  std::cout << name << "\n  chain build: " << elapsed.count() << " ms, "
+            << bytes.size() / (1024 * 1024) << " MB cached\n";
+  for (size_t i = 0; i < chain.size(); ++i) {
+    const s21::LodLevel& level = chain[i];
+    std::cout << "  level " << i << ": " << level.triangle_count
+              << " triangles, " << level.data->edge_count << " edges ("
+              << 100.0 * level.data->edge_count / full->edge_count
+              << "%), error " << level.error << '\n';
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    for (int i = 1; i < argc; ++i) Run(argv[i], LoadModel(argv[i], 0, 0));
+    return 0;
+  }
+  Run("view/primitives/Monkey.obj",
+      LoadModel("view/primitives/Monkey.obj", 0, 0));
+  // About 2M triangles.
+  Run("bumpy grid", LoadModel("", 1000, 1000));
+  return 0;
+}
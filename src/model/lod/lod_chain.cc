@@ -0,0 +1,267 @@
+#include "lod_chain.h"
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+
+#include "mesh_simplifier.h"
+
+namespace s21 {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', '2', '1', 'L', 'O', 'D', 'S', '\0'};
+
+// Appends a trivially copyable value to a byte string.
+template <typename T>
+void Append(std::string& out, const T& value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Appends a length-prefixed array to a byte string.
+template <typename T>
+void AppendArray(std::string& out, const std::vector<T>& values) {
+  Append(out, static_cast<uint64_t>(values.size()));
+  out.append(reinterpret_cast<const char*>(values.data()),
+             values.size() * sizeof(T));
+}
+
+/**
+ * @class ByteReader
+ * @brief Bounds-checked reading of a serialized chain.
+ */
+class ByteReader {
+ public:
+  explicit ByteReader(std::string_view bytes)
+      : p_(bytes.data()), end_(bytes.data() + bytes.size()) {}
+
+  template <typename T>
+  bool Read(T& value) {
+    if (static_cast<size_t>(end_ - p_) < sizeof(value)) return false;
+    std::memcpy(&value, p_, sizeof(value));
+    p_ += sizeof(value);
+    return true;
+  }
+
+  template <typename T>
+  bool ReadArray(std::vector<T>& values) {
+    uint64_t count;
+    if (!Read(count) ||
+        count > static_cast<size_t>(end_ - p_) / sizeof(T)) {
+      return false;
+    }
+    values.resize(count);
+    std::memcpy(static_cast<void*>(values.data()), p_, count * sizeof(T));
+    p_ += count * sizeof(T);
+    return true;
+  }
+
+  bool AtEnd() const { return p_ == end_; }
+
+ private:
+  const char* p_;    ///< Next byte to read.
+  const char* end_;  ///< End of the data.
+};
+
+// Builds the drawing data of simplified triangles.
+std::shared_ptr<DrawSceneData> MakeLevelData(
+    std::vector<Vec3f> vertices, const std::vector<uint32_t>& tris,
+    const std::vector<uint8_t>& sides) {
+  OBJData data;
+  data.vertices = std::move(vertices);
+  data.face_vertices.reserve(tris.size());
+  data.face_offsets.reserve(tris.size() / 3 + 1);
+  // A triangle of polygon sides only becomes a face; any other triangle
+  // becomes one two-vertex face per side, so fan diagonals are not drawn.
+  auto add_face = [&data](std::initializer_list<uint32_t> corners) {
+    for (uint32_t v : corners) {
+      data.face_vertices.emplace_back(static_cast<int>(v));
+    }
+    data.face_offsets.push_back(
+        static_cast<uint32_t>(data.face_vertices.size()));
+  };
+  for (size_t i = 0; i < tris.size(); i += 3) {
+    const uint8_t marks = sides[i / 3];
+    if (marks == MeshSimplifier::kAllSides) {
+      add_face({tris[i], tris[i + 1], tris[i + 2]});
+      continue;
+    }
+    for (int k = 0; k < 3; ++k) {
+      if (marks & 1 << k) add_face({tris[i + k], tris[i + (k + 1) % 3]});
+    }
+  }
+  return Scene().LoadSceneMeshData(std::move(data));
+}
+
+// Checks that every batch lies inside the index data and every index names
+// a vertex.
+bool ValidEdges(const DrawSceneData& data) {
+  const size_t bytes = data.index_data.size() * sizeof(uint16_t);
+  size_t indices = 0;
+  for (const EdgeBatch& batch : data.edge_batches) {
+    const size_t width = batch.wide ? sizeof(uint32_t) : sizeof(uint16_t);
+    if (batch.offset > bytes || batch.count > (bytes - batch.offset) / width ||
+        batch.offset % sizeof(uint16_t) != 0) {
+      return false;
+    }
+    for (size_t i = 0; i < batch.count; ++i) {
+      if (data.EdgeIndex(batch, i) >= data.vertices.size()) return false;
+    }
+    indices += batch.count;
+  }
+  return indices == data.edge_count * 2;
+}
+
+}  // namespace
+
+LodChain LodChain::Build(std::shared_ptr<DrawSceneData> full,
+                         std::vector<uint32_t> triangles,
+                         std::vector<uint8_t> sides, const Settings& settings,
+                         LoadMonitor* monitor) {
+  LodChain chain;
+  const size_t triangle_count = triangles.size() / 3;
+  const std::vector<Vec3f>& vertices = full->vertices;
+  chain.levels_.push_back({std::move(full), triangle_count, 0.0f});
+  if (settings.max_levels < 2) return chain;
+
+  MeshSimplifier simplifier(vertices, std::move(triangles), std::move(sides));
+  while (chain.levels_.size() < settings.max_levels) {
+    const size_t previous = chain.levels_.back().triangle_count;
+    const size_t target = static_cast<size_t>(previous * settings.ratio);
+    if (target < settings.min_triangles) break;
+    simplifier.Simplify(target, monitor);
+    // Stop once collapses stall well short of the target.
+    if (simplifier.TriangleCount() > previous * (1.0f + settings.ratio) / 2) {
+      break;
+    }
+
+    std::vector<Vec3f> level_vertices;
+    std::vector<uint32_t> level_triangles;
+    std::vector<uint8_t> level_sides;
+    simplifier.Extract(level_vertices, level_triangles, &level_sides);
+    chain.levels_.push_back(
+        {MakeLevelData(std::move(level_vertices), level_triangles,
+                       level_sides),
+         simplifier.TriangleCount(), simplifier.Error()});
+  }
+  return chain;
+}
+
+size_t LodChain::Select(float pixels_per_unit, float max_pixel_error) const {
+  for (size_t i = levels_.size(); i-- > 1;) {
+    if (levels_[i].error * pixels_per_unit <= max_pixel_error) return i;
+  }
+  return 0;
+}
+
+size_t LodChain::Select(float pixels_per_unit, float max_pixel_error,
+                        size_t current) const {
+  const size_t level = Select(pixels_per_unit, max_pixel_error);
+  if (current >= levels_.size() || level == current) return level;
+  if (level < current) {
+    const float error = levels_[current].error * pixels_per_unit;
+    return error <= max_pixel_error * kHysteresis ? current : level;
+  }
+  return std::max(current,
+                  Select(pixels_per_unit, max_pixel_error / kHysteresis));
+}
+
+std::string LodChain::Serialize(const Settings& settings) const {
+  std::string out(kMagic, sizeof(kMagic));
+  Append(out, kVersion);
+  Append(out, settings.ratio);
+  Append(out, static_cast<uint64_t>(settings.min_triangles));
+  Append(out, static_cast<uint64_t>(settings.max_levels));
+  const DrawSceneData& full = *levels_.front().data;
+  Append(out, static_cast<uint64_t>(full.vertices.size()));
+  Append(out, static_cast<uint64_t>(full.edge_count));
+  Append(out, static_cast<uint64_t>(levels_.front().triangle_count));
+  Append(out, static_cast<uint64_t>(levels_.size() - 1));
+  for (size_t i = 1; i < levels_.size(); ++i) {
+    const LodLevel& level = levels_[i];
+    Append(out, static_cast<uint64_t>(level.triangle_count));
+    Append(out, level.error);
+    AppendArray(out, level.data->vertices);
+    AppendArray(out, level.data->index_data);
+    Append(out, static_cast<uint64_t>(level.data->edge_batches.size()));
+    for (const EdgeBatch& batch : level.data->edge_batches) {
+      Append(out, batch.base_vertex);
+      Append(out, static_cast<uint64_t>(batch.offset));
+      Append(out, static_cast<uint64_t>(batch.count));
+      Append(out, static_cast<uint8_t>(batch.wide));
+    }
+    Append(out, static_cast<uint64_t>(level.data->edge_count));
+  }
+  return out;
+}
+
+bool LodChain::Deserialize(std::string_view bytes,
+                           std::shared_ptr<DrawSceneData> full,
+                           const Settings& settings, LodChain& chain) {
+  ByteReader reader(bytes);
+  char magic[sizeof(kMagic)];
+  uint32_t version;
+  float ratio;
+  uint64_t min_triangles, max_levels, vertex_count, edge_count,
+      triangle_count, level_count;
+  if (!reader.Read(magic) || std::memcmp(magic, kMagic, sizeof(kMagic)) ||
+      !reader.Read(version) || version != kVersion || !reader.Read(ratio) ||
+      !reader.Read(min_triangles) || !reader.Read(max_levels) ||
+      !reader.Read(vertex_count) || !reader.Read(edge_count) ||
+      !reader.Read(triangle_count) || !reader.Read(level_count)) {
+    return false;
+  }
+  if (ratio != settings.ratio || min_triangles != settings.min_triangles ||
+      max_levels != settings.max_levels ||
+      vertex_count != full->vertices.size() ||
+      edge_count != full->edge_count || level_count >= max_levels) {
+    return false;
+  }
+
+  LodChain loaded;
+  loaded.levels_.push_back({std::move(full), triangle_count, 0.0f});
+  for (uint64_t i = 0; i < level_count; ++i) {
+    LodLevel level;
+    level.data = std::make_shared<DrawSceneData>();
+    DrawSceneData& data = *level.data;
+    uint64_t level_triangles, batch_count, level_edges;
+    if (!reader.Read(level_triangles) || !reader.Read(level.error) ||
+        !reader.ReadArray(data.vertices) ||
+        !reader.ReadArray(data.index_data) || !reader.Read(batch_count) ||
+        batch_count > bytes.size()) {
+      return false;
+    }
+    for (uint64_t j = 0; j < batch_count; ++j) {
+      EdgeBatch& batch = data.edge_batches.emplace_back();
+      uint64_t offset, count;
+      uint8_t wide;
+      if (!reader.Read(batch.base_vertex) || !reader.Read(offset) ||
+          !reader.Read(count) || !reader.Read(wide)) {
+        return false;
+      }
+      batch.offset = offset;
+      batch.count = count;
+      batch.wide = wide != 0;
+    }
+    if (!reader.Read(level_edges)) return false;
+    data.edge_count = level_edges;
+    if (!ValidEdges(data)) return false;
+    level.triangle_count = level_triangles;
+    loaded.levels_.push_back(std::move(level));
+  }
+  if (!reader.AtEnd()) return false;
+  chain = std::move(loaded);
+  return true;
+}
+
+void FrameBudget::Update(double frame_ms, bool complete) {
+  if (budget_ms_ <= 0.0 || !complete) return;
+  if (frame_ms > budget_ms_) {
+    scale_ = std::min(scale_ * 2.0f, kMaxScale);
+  } else if (frame_ms * 2.0 / ratio_ < budget_ms_) {
+    // The finer level would still take at most half the budget.
+    scale_ = std::max(scale_ * 0.5f, 1.0f);
+  }
+}
+
+}  // namespace s21
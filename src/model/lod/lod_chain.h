@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../scene.h"
+
+namespace s21 {
+
+/**
+ * @struct LodLevel
+ * @brief One level of detail of a scene.
+ */
+struct LodLevel {
+  std::shared_ptr<DrawSceneData> data;  ///< Vertices and edges to draw.
+  size_t triangle_count = 0;            ///< Triangles the level was built of.
+  float error = 0.0f;  ///< Deviation from the full mesh in model units.
+};
+
+/**
+ * @class LodChain
+ * @brief Progressively simplified versions of a scene for distant views.
+ *
+ * Level 0 is the full scene; every further level has about Settings::ratio
+ * times the triangles of the previous one. All levels come from one
+ * MeshSimplifier run, so each error is measured against the full mesh.
+ * Select() picks the coarsest level whose error projects to less than a
+ * given number of pixels. Like the full scene, every level draws only the
+ * sides of the source polygons, not the edges their triangulation added.
+ */
+class LodChain {
+ public:
+  /**
+   * @struct Settings
+   * @brief Shape of the chain.
+   */
+  struct Settings {
+    float ratio = 0.25f;          ///< Triangles of a level per previous one.
+    size_t min_triangles = 2000;  ///< No level gets fewer triangles.
+    /// Number of levels including the full scene; 1 disables the chain.
+    size_t max_levels = 6;
+  };
+
+  /// Format version of Serialize(); bump whenever the layout changes.
+  static constexpr uint32_t kVersion = 2;
+
+  /// Factor the error must pass the limit by before the level changes.
+  static constexpr float kHysteresis = 1.5f;
+
+  LodChain() = default;
+
+  /**
+   * @brief Builds the levels of a scene.
+   * @param full The full scene; becomes level 0.
+   * @param triangles The triangles of the full scene, see
+   * MeshSimplifier::Triangulate().
+   * @param sides Which triangle edges are polygon sides, from the same
+   * call; empty if all are.
+   * @param settings Shape of the chain.
+   * @param monitor Checked for cancellation while simplifying; optional.
+   * @return The chain; only level 0 if the mesh is too small to simplify.
+   *
+   * @throws LoadCancelledException if the monitor cancels.
+   */
+  static LodChain Build(std::shared_ptr<DrawSceneData> full,
+                        std::vector<uint32_t> triangles,
+                        std::vector<uint8_t> sides, const Settings& settings,
+                        LoadMonitor* monitor = nullptr);
+
+  /**
+   * @brief Returns the number of levels.
+   * @return Levels including the full scene; 0 for an empty chain.
+   */
+  size_t size() const { return levels_.size(); }
+
+  /**
+   * @brief Returns a level.
+   * @param i Level index; 0 is the full scene.
+   * @return The level.
+   */
+  const LodLevel& operator[](size_t i) const { return levels_[i]; }
+
+  /**
+   * @brief Picks the level to draw.
+   * @param pixels_per_unit Screen pixels covered by one model unit.
+   * @param max_pixel_error Largest acceptable error on screen in pixels.
+   * @return The coarsest level whose projected error is within the limit;
+   * 0 if there is none.
+   */
+  size_t Select(float pixels_per_unit, float max_pixel_error) const;
+
+  /**
+   * @brief Picks the level to draw, preferring the level drawn now.
+   * @param pixels_per_unit Screen pixels covered by one model unit.
+   * @param max_pixel_error Largest acceptable error on screen in pixels.
+   * @param current The level drawn now.
+   * @return Like Select(), except that a finer level is only taken once the
+   * current error exceeds the limit by kHysteresis, and a coarser one only
+   * if its error is below the limit by kHysteresis. A view near the limit
+   * thus keeps its level instead of switching every frame.
+   */
+  size_t Select(float pixels_per_unit, float max_pixel_error,
+                size_t current) const;
+
+  /**
+   * @brief Writes the levels above 0 to a byte string.
+   * @param settings The settings the chain was built with.
+   * @return The serialized chain, see Deserialize().
+   */
+  std::string Serialize(const Settings& settings) const;
+
+  /**
+   * @brief Restores a chain written by Serialize().
+   * @param bytes The serialized chain.
+   * @param full The full scene the chain was built from.
+   * @param settings The settings the chain must have been built with.
+   * @param chain Receives the chain on success.
+   * @return False if the bytes are corrupt or belong to another scene or
+   * other settings.
+   */
+  static bool Deserialize(std::string_view bytes,
+                          std::shared_ptr<DrawSceneData> full,
+                          const Settings& settings, LodChain& chain);
+
+ private:
+  std::vector<LodLevel> levels_;  ///< Level 0 first.
+};
+
+/**
+ * @class FrameBudget
+ * @brief Loosens the level of detail while frames take too long.
+ *
+ * Scale() multiplies the pixel error passed to LodChain::Select(). It
+ * doubles after a frame over the budget and halves after a frame far below
+ * it, so the finer level, about 1 / ratio times as expensive, still fits.
+ */
+class FrameBudget {
+ public:
+  /// Largest value of Scale().
+  static constexpr float kMaxScale = 64.0f;
+
+  /**
+   * @brief Creates a budget.
+   * @param budget_ms Time a frame may take; 0 disables the budget.
+   * @param ratio Cost of a level relative to the next finer one.
+   */
+  explicit FrameBudget(double budget_ms = 0.0, float ratio = 0.25f)
+      : budget_ms_(budget_ms), ratio_(ratio) {}
+
+  /**
+   * @brief Records the duration of a frame.
+   * @param frame_ms How long the frame took.
+   * @param complete False if the frame drew only part of its level, for
+   * instance while the level streams to the GPU; such frames are ignored,
+   * since their time says nothing about the cost of the level.
+   */
+  void Update(double frame_ms, bool complete = true);
+
+  /**
+   * @brief Returns the factor for the pixel error.
+   * @return A power of two between 1 and kMaxScale.
+   */
+  float Scale() const { return scale_; }
+
+ private:
+  double budget_ms_;    ///< Time a frame may take.
+  float ratio_;         ///< Cost of a level relative to the finer one.
+  float scale_ = 1.0f;  ///< Factor for the pixel error.
+};
+
+}  // namespace s21
@@ -0,0 +1,326 @@
+#include "mesh_simplifier.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace s21 {
+
+namespace {
+
+// Weight of the plane along a border edge relative to a triangle plane.
+constexpr float kBorderWeight = 10.0f;
+
+// The cost limit of a pass is this many times the cost of the collapse that
+// would reach the target, leaving expensive collapses to later passes.
+constexpr float kPassCostSlack = 1.5f;
+
+// A collapse may turn the normal of a remaining triangle by at most the
+// angle with this cosine. Smaller turns accumulate over passes, so a plain
+// sign check would let slivers tip over gradually.
+constexpr float kMinNormalCosine = 0.5f;
+
+// A pass checks for cancellation once per this many vertices or collapses,
+// so cancelling a load does not wait for a pass over a huge mesh.
+constexpr size_t kCancelCheckInterval = size_t{1} << 16;
+
+Vec3f Sub(const Vec3f& a, const Vec3f& b) {
+  return Vec3f(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+Vec3f Cross(const Vec3f& a, const Vec3f& b) {
+  return Vec3f(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+               a.x * b.y - a.y * b.x);
+}
+
+float Dot(const Vec3f& a, const Vec3f& b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+}  // namespace
+
+void MeshSimplifier::Quadric::AddPlane(float a, float b, float c, float d,
+                                       float w) {
+  a2 += w * a * a;
+  b2 += w * b * b;
+  c2 += w * c * c;
+  d2 += w * d * d;
+  ab += w * a * b;
+  ac += w * a * c;
+  ad += w * a * d;
+  bc += w * b * c;
+  bd += w * b * d;
+  cd += w * c * d;
+  weight += w;
+}
+
+MeshSimplifier::Quadric& MeshSimplifier::Quadric::operator+=(
+    const Quadric& other) {
+  a2 += other.a2;
+  b2 += other.b2;
+  c2 += other.c2;
+  d2 += other.d2;
+  ab += other.ab;
+  ac += other.ac;
+  ad += other.ad;
+  bc += other.bc;
+  bd += other.bd;
+  cd += other.cd;
+  weight += other.weight;
+  return *this;
+}
+
+float MeshSimplifier::Quadric::Evaluate(const Vec3f& p) const {
+  const float e = a2 * p.x * p.x + b2 * p.y * p.y + c2 * p.z * p.z + d2 +
+                  2.0f * (ab * p.x * p.y + ac * p.x * p.z + bc * p.y * p.z +
+                          ad * p.x + bd * p.y + cd * p.z);
+  // Rounding can make a zero error slightly negative.
+  return std::max(e, 0.0f);
+}
+
+MeshSimplifier::MeshSimplifier(const std::vector<Vec3f>& vertices,
+                               std::vector<uint32_t> triangles,
+                               std::vector<uint8_t> sides)
+    : vertices_(vertices),
+      triangles_(std::move(triangles)),
+      sides_(std::move(sides)),
+      quadrics_(vertices.size()) {
+  if (sides_.size() != TriangleCount()) {
+    sides_.assign(TriangleCount(), kAllSides);
+  }
+  ComputeQuadrics();
+}
+
+std::vector<uint32_t> MeshSimplifier::Triangulate(const OBJData& data,
+                                                  size_t vertex_count,
+                                                  std::vector<uint8_t>* sides) {
+  std::vector<uint32_t> triangles;
+  std::vector<uint32_t> polygon;
+  if (sides) sides->clear();
+  for (const Face& face : data.Faces()) {
+    polygon.clear();
+    for (const VertexIndices& index : face.vertices) {
+      if (index.v >= 0 && static_cast<size_t>(index.v) < vertex_count) {
+        polygon.push_back(index.v);
+      }
+    }
+    for (size_t i = 2; i < polygon.size(); ++i) {
+      const uint32_t a = polygon[0], b = polygon[i - 1], c = polygon[i];
+      if (a == b || b == c || a == c) continue;
+      triangles.insert(triangles.end(), {a, b, c});
+      // b-c is always a side; a-b only in the first triangle of the fan and
+      // c-a only in the last
+      if (sides) {
+        sides->push_back(static_cast<uint8_t>(
+            (i == 2 ? 1 : 0) | 2 | (i + 1 == polygon.size() ? 4 : 0)));
+      }
+    }
+  }
+  return triangles;
+}
+
+void MeshSimplifier::ComputeQuadrics() {
+  // Directed edges of all triangles; a border edge has no reverse.
+  std::vector<uint64_t> directed;
+  directed.reserve(triangles_.size());
+  for (size_t t = 0; t < triangles_.size(); t += 3) {
+    for (int k = 0; k < 3; ++k) {
+      const uint32_t a = triangles_[t + k], b = triangles_[t + (k + 1) % 3];
+      directed.push_back(uint64_t{a} << 32 | b);
+    }
+  }
+  std::sort(directed.begin(), directed.end());
+
+  for (size_t t = 0; t < triangles_.size(); t += 3) {
+    const uint32_t* v = &triangles_[t];
+    const Vec3f &p0 = vertices_[v[0]], &p1 = vertices_[v[1]],
+                &p2 = vertices_[v[2]];
+    Vec3f n = Cross(Sub(p1, p0), Sub(p2, p0));
+    const float length = std::sqrt(Dot(n, n));
+    if (length == 0.0f) continue;
+    n = Vec3f(n.x / length, n.y / length, n.z / length);
+
+    // Area-weighted plane of the triangle.
+    Quadric plane;
+    plane.AddPlane(n.x, n.y, n.z, -Dot(n, p0), length * 0.5f);
+    for (int k = 0; k < 3; ++k) quadrics_[v[k]] += plane;
+
+    for (int k = 0; k < 3; ++k) {
+      const uint32_t a = v[k], b = v[(k + 1) % 3];
+      if (std::binary_search(directed.begin(), directed.end(),
+                             uint64_t{b} << 32 | a)) {
+        continue;
+      }
+      // Plane through the border edge, perpendicular to the triangle.
+      const Vec3f edge = Sub(vertices_[b], vertices_[a]);
+      Vec3f m = Cross(edge, n);
+      const float m_length = std::sqrt(Dot(m, m));
+      if (m_length == 0.0f) continue;
+      m = Vec3f(m.x / m_length, m.y / m_length, m.z / m_length);
+      Quadric border;
+      border.AddPlane(m.x, m.y, m.z, -Dot(m, vertices_[a]),
+                      kBorderWeight * Dot(edge, edge));
+      quadrics_[a] += border;
+      quadrics_[b] += border;
+    }
+  }
+}
+
+void MeshSimplifier::Simplify(size_t target, LoadMonitor* monitor) {
+  while (TriangleCount() > target) {
+    if (monitor) monitor->ThrowIfCancelled();
+    if (Pass(target, monitor) == 0) break;
+  }
+}
+
+size_t MeshSimplifier::Pass(size_t target, LoadMonitor* monitor) {
+  const size_t vertex_count = vertices_.size();
+  const size_t triangle_count = TriangleCount();
+
+  // Triangles around every vertex, in CSR form.
+  std::vector<uint32_t> first(vertex_count + 1, 0);
+  for (uint32_t v : triangles_) ++first[v + 1];
+  for (size_t v = 0; v < vertex_count; ++v) first[v + 1] += first[v];
+  std::vector<uint32_t> around(triangles_.size());
+  {
+    std::vector<uint32_t> next(first.begin(), first.end() - 1);
+    for (size_t i = 0; i < triangles_.size(); ++i) {
+      around[next[triangles_[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+  }
+
+  // Every edge once, found from its smaller end and collapsed towards its
+  // cheaper end. seen[u] holds the last vertex that found u.
+  std::vector<Collapse> collapses;
+  collapses.reserve(triangles_.size() / 2);
+  {
+    std::vector<uint32_t> seen(vertex_count, UINT32_MAX);
+    for (uint32_t a = 0; a < vertex_count; ++a) {
+      if (monitor && a % kCancelCheckInterval == 0) {
+        monitor->ThrowIfCancelled();
+      }
+      for (uint32_t i = first[a]; i < first[a + 1]; ++i) {
+        const uint32_t* v = &triangles_[around[i] * 3];
+        for (int k = 0; k < 3; ++k) {
+          const uint32_t b = v[k];
+          if (b <= a || seen[b] == a) continue;
+          seen[b] = a;
+          Quadric q = quadrics_[a];
+          q += quadrics_[b];
+          const float to_b = q.Evaluate(vertices_[b]);
+          const float to_a = q.Evaluate(vertices_[a]);
+          collapses.push_back(to_b <= to_a ? Collapse{a, b, to_b}
+                                           : Collapse{b, a, to_a});
+        }
+      }
+    }
+  }
+
+  // An interior collapse removes two triangles.
+  const size_t goal = (triangle_count - target + 1) / 2;
+  auto by_cost = [](const Collapse& x, const Collapse& y) {
+    return x.cost < y.cost;
+  };
+  if (goal < collapses.size()) {
+    std::nth_element(collapses.begin(), collapses.begin() + goal,
+                     collapses.end(), by_cost);
+    const float limit = collapses[goal].cost * kPassCostSlack;
+    collapses.erase(std::partition(collapses.begin(), collapses.end(),
+                                   [limit](const Collapse& c) {
+                                     return c.cost <= limit;
+                                   }),
+                    collapses.end());
+  }
+  std::sort(collapses.begin(), collapses.end(), by_cost);
+  if (monitor) monitor->ThrowIfCancelled();
+
+  std::vector<uint32_t> remap(vertex_count);
+  for (size_t v = 0; v < vertex_count; ++v) remap[v] = v;
+  std::vector<bool> locked(vertex_count, false);
+  size_t removed = 0, applied = 0;
+  for (size_t n = 0; n < collapses.size(); ++n) {
+    const Collapse& c = collapses[n];
+    if (triangle_count - removed <= target) break;
+    if (monitor && n % kCancelCheckInterval == 0) monitor->ThrowIfCancelled();
+    if (locked[c.from] || locked[c.to]) continue;
+    const uint32_t* ring = around.data() + first[c.from];
+    const size_t ring_size = first[c.from + 1] - first[c.from];
+    size_t gone = 0;
+    if (!KeepsOrientation(c, ring, ring_size, gone)) continue;
+
+    remap[c.from] = c.to;
+    quadrics_[c.to] += quadrics_[c.from];
+    const Quadric& q = quadrics_[c.to];
+    if (q.weight > 0.0f) {
+      error_ = std::max(error_, std::sqrt(c.cost / q.weight));
+    }
+    // Triangles around c.from change shape; keep their corners still for
+    // the rest of the pass so later checks see final positions.
+    for (size_t i = 0; i < ring_size; ++i) {
+      for (int k = 0; k < 3; ++k) locked[triangles_[ring[i] * 3 + k]] = true;
+    }
+    removed += gone;
+    ++applied;
+  }
+
+  // Move collapsed corners and drop the triangles that became degenerate.
+  size_t out = 0;
+  for (size_t t = 0; t < triangles_.size(); t += 3) {
+    const uint32_t a = remap[triangles_[t]], b = remap[triangles_[t + 1]],
+                   c = remap[triangles_[t + 2]];
+    if (a == b || b == c || a == c) continue;
+    sides_[out / 3] = sides_[t / 3];
+    triangles_[out++] = a;
+    triangles_[out++] = b;
+    triangles_[out++] = c;
+  }
+  triangles_.resize(out);
+  sides_.resize(out / 3);
+  return applied;
+}
+
+bool MeshSimplifier::KeepsOrientation(const Collapse& c,
+                                      const uint32_t* triangles, size_t count,
+                                      size_t& removed) const {
+  removed = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t* v = &triangles_[triangles[i] * 3];
+    if (v[0] == c.to || v[1] == c.to || v[2] == c.to) {
+      ++removed;
+      continue;
+    }
+    Vec3f p[3], moved[3];
+    for (int k = 0; k < 3; ++k) {
+      p[k] = vertices_[v[k]];
+      moved[k] = v[k] == c.from ? vertices_[c.to] : p[k];
+    }
+    const Vec3f before = Cross(Sub(p[1], p[0]), Sub(p[2], p[0]));
+    const Vec3f after = Cross(Sub(moved[1], moved[0]), Sub(moved[2], moved[0]));
+    const float dot = Dot(before, after);
+    if (dot <= 0.0f || dot * dot < kMinNormalCosine * kMinNormalCosine *
+                                       Dot(before, before) *
+                                       Dot(after, after)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void MeshSimplifier::Extract(std::vector<Vec3f>& vertices,
+                             std::vector<uint32_t>& triangles,
+                             std::vector<uint8_t>* sides) const {
+  std::vector<uint32_t> index(vertices_.size(), 0);
+  for (uint32_t v : triangles_) index[v] = 1;
+  vertices.clear();
+  for (size_t v = 0; v < vertices_.size(); ++v) {
+    if (!index[v]) continue;
+    index[v] = static_cast<uint32_t>(vertices.size());
+    vertices.push_back(vertices_[v]);
+  }
+  triangles.resize(triangles_.size());
+  for (size_t i = 0; i < triangles_.size(); ++i) {
+    triangles[i] = index[triangles_[i]];
+  }
+  if (sides) *sides = sides_;
+}
+
+}  // namespace s21
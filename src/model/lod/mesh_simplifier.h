@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../obj/load_monitor.h"
+#include "../obj/obj_data.h"
+
+namespace s21 {
+
+/**
+ * @class MeshSimplifier
+ * @brief Reduces a triangle mesh by quadric-error edge collapse.
+ *
+ * Every vertex carries the sum of the squared-distance quadrics of the
+ * planes of its triangles (Garland and Heckbert). Collapsing an edge moves
+ * one end onto the other and adds their quadrics; the cost of a collapse is
+ * the quadric error at the kept end. Ends are kept rather than optimal
+ * positions computed, so the simplified mesh reuses original positions.
+ *
+ * Collapses run in passes. A pass computes the cost of every edge, sorts
+ * them and applies the cheapest ones, locking the neighbourhood of each so
+ * later collapses in the pass see up-to-date geometry. Collapses that would
+ * flip a triangle or tilt it steeply are skipped. Border edges get an extra
+ * perpendicular plane, so open boundaries keep their shape.
+ *
+ * Simplify() can be called repeatedly with decreasing targets; the quadrics
+ * persist between calls, so each result approximates the original mesh
+ * rather than the previous result.
+ *
+ * Every triangle remembers which of its edges are sides of the polygon it
+ * was cut from. A collapse only renames corners, so the marks stay with
+ * their edges, and Extract() reports them for drawing the sides alone.
+ */
+class MeshSimplifier {
+ public:
+  /// Side marks of a triangle all of whose edges are polygon sides.
+  static constexpr uint8_t kAllSides = 7;
+
+  /**
+   * @brief Prepares a mesh for simplification.
+   * @param vertices Vertex positions; must outlive the simplifier.
+   * @param triangles Three valid, distinct vertex indices per triangle.
+   * @param sides Per triangle, bit k is set if the edge from corner k to
+   * corner k + 1 is a polygon side, see Triangulate(); empty if every edge
+   * is.
+   */
+  MeshSimplifier(const std::vector<Vec3f>& vertices,
+                 std::vector<uint32_t> triangles,
+                 std::vector<uint8_t> sides = {});
+
+  /**
+   * @brief Splits the faces of parsed data into triangles.
+   * @param data The parsed data.
+   * @param vertex_count Number of vertices the indices refer to.
+   * @param sides Receives the side marks of every triangle; optional.
+   * @return Three vertex indices per triangle.
+   *
+   * Polygons are split into fans, whose inner edges are not sides. Faces
+   * with fewer than three valid vertex references and triangles with
+   * repeated vertices are dropped.
+   */
+  static std::vector<uint32_t> Triangulate(
+      const OBJData& data, size_t vertex_count,
+      std::vector<uint8_t>* sides = nullptr);
+
+  /**
+   * @brief Collapses edges until at most target triangles are left.
+   * @param target Number of triangles to reach.
+   * @param monitor Checked for cancellation during the passes; optional.
+   *
+   * Stops early if no edge can be collapsed without flipping a triangle.
+   *
+   * @throws LoadCancelledException if the monitor cancels.
+   */
+  void Simplify(size_t target, LoadMonitor* monitor = nullptr);
+
+  /**
+   * @brief Returns the number of triangles left.
+   * @return Triangles of the current mesh.
+   */
+  size_t TriangleCount() const { return triangles_.size() / 3; }
+
+  /**
+   * @brief Returns the error of the collapses made so far.
+   * @return The largest root mean square distance, in model units, between
+   * a kept vertex and the planes of the triangles merged into it.
+   */
+  float Error() const { return error_; }
+
+  /**
+   * @brief Copies out the current mesh.
+   * @param vertices Receives the positions of the vertices still in use, in
+   * their original order.
+   * @param triangles Receives the triangles, indexing vertices.
+   * @param sides Receives the side marks of the triangles; optional.
+   */
+  void Extract(std::vector<Vec3f>& vertices, std::vector<uint32_t>& triangles,
+               std::vector<uint8_t>* sides = nullptr) const;
+
+ private:
+  /**
+   * @struct Quadric
+   * @brief Weighted sum of squared distances to planes.
+   */
+  struct Quadric {
+    float a2 = 0, b2 = 0, c2 = 0, d2 = 0;  ///< Squared plane terms.
+    float ab = 0, ac = 0, ad = 0;          ///< Mixed terms of a.
+    float bc = 0, bd = 0, cd = 0;          ///< Other mixed terms.
+    float weight = 0;                      ///< Sum of plane weights.
+
+    /// Adds the plane ax + by + cz + d = 0 with a weight.
+    void AddPlane(float a, float b, float c, float d, float w);
+    /// Adds another quadric.
+    Quadric& operator+=(const Quadric& other);
+    /// Returns the weighted sum of squared distances of a point.
+    float Evaluate(const Vec3f& p) const;
+  };
+
+  /**
+   * @struct Collapse
+   * @brief A candidate edge collapse.
+   */
+  struct Collapse {
+    uint32_t from;  ///< Vertex removed.
+    uint32_t to;    ///< Vertex kept.
+    float cost;     ///< Quadric error of the collapse.
+  };
+
+  const std::vector<Vec3f>& vertices_;  ///< Original positions.
+  std::vector<uint32_t> triangles_;     ///< Current triangles.
+  std::vector<uint8_t> sides_;          ///< Side marks of every triangle.
+  std::vector<Quadric> quadrics_;       ///< Quadric of every vertex.
+  float error_ = 0.0f;                  ///< Largest collapse error so far.
+
+  /// Adds the planes of the triangles and of the border edges.
+  void ComputeQuadrics();
+
+  /**
+   * @brief Runs one pass of collapses.
+   * @param target Number of triangles to reach.
+   * @param monitor Checked for cancellation while the pass runs; optional.
+   * @return Number of collapses made.
+   * @throws LoadCancelledException if the monitor cancels.
+   */
+  size_t Pass(size_t target, LoadMonitor* monitor);
+
+  /**
+   * @brief Checks whether moving a vertex tips over one of its triangles.
+   * @param c The collapse.
+   * @param triangles Triangles around c.from.
+   * @param count Number of those triangles.
+   * @param removed Receives how many of them the collapse removes.
+   * @return True if no remaining triangle turns its normal by 60 degrees or
+   * more.
+   */
+  bool KeepsOrientation(const Collapse& c, const uint32_t* triangles,
+                        size_t count, size_t& removed) const;
+};
+
+}  // namespace s21
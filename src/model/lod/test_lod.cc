@@ -0,0 +1,349 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lod_chain.h"
+#include "mesh_simplifier.h"
+#include "scene.h"
+
+// Unit sphere of rings x segments quads with outward-facing triangles.
+struct Sphere {
+  std::vector<s21::Vec3f> vertices;
+  std::vector<uint32_t> triangles;
+  // Side marks of the triangles as if the quads had been triangulated.
+  std::vector<uint8_t> quad_sides;
+
+  Sphere(int rings, int segments) {
+    const float pi = std::acos(-1.0f);
+    vertices.emplace_back(0.0f, 1.0f, 0.0f);
+    for (int r = 1; r < rings; ++r) {
+      const float theta = pi * r / rings;
+      for (int s = 0; s < segments; ++s) {
+        const float phi = 2.0f * pi * s / segments;
+        vertices.emplace_back(std::sin(theta) * std::cos(phi),
+                              std::cos(theta),
+                              -std::sin(theta) * std::sin(phi));
+      }
+    }
+    vertices.emplace_back(0.0f, -1.0f, 0.0f);
+
+    const uint32_t bottom = static_cast<uint32_t>(vertices.size() - 1);
+    auto ring = [segments](int r, int s) {
+      return static_cast<uint32_t>(1 + (r - 1) * segments + s % segments);
+    };
+    for (int s = 0; s < segments; ++s) {
+      triangles.insert(triangles.end(), {0, ring(1, s), ring(1, s + 1)});
+      quad_sides.push_back(s21::MeshSimplifier::kAllSides);
+      for (int r = 1; r + 1 < rings; ++r) {
+        triangles.insert(triangles.end(),
+                         {ring(r, s), ring(r + 1, s), ring(r + 1, s + 1)});
+        triangles.insert(triangles.end(),
+                         {ring(r, s), ring(r + 1, s + 1), ring(r, s + 1)});
+        quad_sides.insert(quad_sides.end(), {3, 6});
+      }
+      triangles.insert(triangles.end(), {ring(rings - 1, s), bottom,
+                                         ring(rings - 1, s + 1)});
+      quad_sides.push_back(s21::MeshSimplifier::kAllSides);
+    }
+  }
+
+  // Builds the drawing data of the sphere.
+  std::shared_ptr<s21::DrawSceneData> DrawData() const {
+    s21::OBJData data;
+    data.vertices = vertices;
+    for (size_t i = 0; i < triangles.size(); ++i) {
+      data.face_vertices.emplace_back(static_cast<int>(triangles[i]));
+      if (i % 3 == 2) data.face_offsets.push_back(i + 1);
+    }
+    return s21::Scene().LoadSceneMeshData(std::move(data));
+  }
+};
+
+// Returns the triangle count of the flat n x n quad grid.
+size_t GridTriangles(int n) { return size_t(n) * n * 2; }
+
+// Flat grid of n x n quads in the z = 0 plane.
+void MakeGrid(int n, std::vector<s21::Vec3f>& vertices,
+              std::vector<uint32_t>& triangles) {
+  for (int y = 0; y <= n; ++y) {
+    for (int x = 0; x <= n; ++x) vertices.emplace_back(x, y, 0.0f);
+  }
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      const uint32_t a = y * (n + 1) + x, b = a + 1, c = a + n + 1,
+                     d = c + 1;
+      triangles.insert(triangles.end(), {a, b, d, a, d, c});
+    }
+  }
+}
+
+// Returns the unnormalized normal of a triangle.
+s21::Vec3f Normal(const std::vector<s21::Vec3f>& v, const uint32_t* t) {
+  const s21::Vec3f &a = v[t[0]], &b = v[t[1]], &c = v[t[2]];
+  const float ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+  const float wx = c.x - a.x, wy = c.y - a.y, wz = c.z - a.z;
+  return s21::Vec3f(uy * wz - uz * wy, uz * wx - ux * wz, ux * wy - uy * wx);
+}
+
+// Test: A flat grid collapses to the target without leaving its plane,
+// its outline or its orientation.
+TEST(MeshSimplifierTest, FlatGridReachesTarget) {
+  std::vector<s21::Vec3f> vertices;
+  std::vector<uint32_t> triangles;
+  MakeGrid(32, vertices, triangles);
+  s21::MeshSimplifier simplifier(vertices, triangles);
+  simplifier.Simplify(GridTriangles(32) / 8);
+
+  EXPECT_LE(simplifier.TriangleCount(), GridTriangles(32) / 8);
+  EXPECT_GT(simplifier.TriangleCount(), 0u);
+  EXPECT_LT(simplifier.Error(), 1e-3f);
+
+  std::vector<s21::Vec3f> kept;
+  std::vector<uint32_t> out;
+  simplifier.Extract(kept, out);
+  ASSERT_EQ(out.size(), simplifier.TriangleCount() * 3);
+  float area = 0.0f;
+  for (size_t t = 0; t < out.size(); t += 3) {
+    ASSERT_LT(out[t], kept.size());
+    const s21::Vec3f n = Normal(kept, &out[t]);
+    EXPECT_GT(n.z, 0.0f);
+    area += n.z / 2.0f;
+  }
+  // Corners stay, so the simplified grid covers the same square.
+  EXPECT_NEAR(area, 32.0f * 32.0f, 1e-2f);
+}
+
+// Test: A simplified sphere stays close to the surface and keeps every
+// triangle facing outwards.
+TEST(MeshSimplifierTest, SphereErrorIsBounded) {
+  Sphere sphere(48, 96);
+  const size_t target = sphere.triangles.size() / 16;
+  s21::MeshSimplifier simplifier(sphere.vertices, sphere.triangles);
+  simplifier.Simplify(target);
+
+  EXPECT_LE(simplifier.TriangleCount(), target);
+  EXPECT_GT(simplifier.TriangleCount(), target / 2);
+  EXPECT_GT(simplifier.Error(), 0.0f);
+  EXPECT_LT(simplifier.Error(), 0.05f);
+
+  std::vector<s21::Vec3f> kept;
+  std::vector<uint32_t> out;
+  simplifier.Extract(kept, out);
+  for (size_t t = 0; t < out.size(); t += 3) {
+    const s21::Vec3f n = Normal(kept, &out[t]);
+    const s21::Vec3f& p = kept[out[t]];
+    EXPECT_GT(n.x * p.x + n.y * p.y + n.z * p.z, 0.0f);
+  }
+}
+
+// Test: Collapses stop at the cancellation of the monitor.
+TEST(MeshSimplifierTest, SimplifyCanBeCancelled) {
+  Sphere sphere(16, 32);
+  s21::MeshSimplifier simplifier(sphere.vertices, sphere.triangles);
+  s21::LoadMonitor monitor;
+  monitor.Cancel();
+  EXPECT_THROW(simplifier.Simplify(10, &monitor),
+               s21::LoadCancelledException);
+  EXPECT_EQ(simplifier.TriangleCount(), sphere.triangles.size() / 3);
+}
+
+// Test: Polygons become fans; invalid references and degenerate triangles
+// are dropped.
+TEST(MeshSimplifierTest, TriangulateDropsInvalidFaces) {
+  const std::string filename = "lod_test.obj";
+  {
+    std::ofstream out(filename);
+    out << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+           "f 1 2 3 4\nf 1 1 2\nf 1 2 9\nf 1 2\nf 4 9 3 2\n";
+  }
+  s21::OBJData data;
+  data.Parse(filename);
+  std::remove(filename.c_str());
+
+  std::vector<uint8_t> sides;
+  const std::vector<uint32_t> triangles =
+      s21::MeshSimplifier::Triangulate(data, data.vertices.size(), &sides);
+  const std::vector<uint32_t> expected = {0, 1, 2, 0, 2, 3, 3, 2, 1};
+  EXPECT_EQ(triangles, expected);
+  // The diagonal 1-3 of the quad is no side
+  const std::vector<uint8_t> expected_sides = {3, 6, 7};
+  EXPECT_EQ(sides, expected_sides);
+}
+
+// Sphere with a chain of small levels.
+class LodChainTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    settings_.ratio = 0.25f;
+    settings_.min_triangles = 50;
+    settings_.max_levels = 4;
+    full_ = sphere_.DrawData();
+    chain_ = s21::LodChain::Build(full_, sphere_.triangles, {}, settings_);
+  }
+
+  Sphere sphere_{32, 64};
+  s21::LodChain::Settings settings_;
+  std::shared_ptr<s21::DrawSceneData> full_;
+  s21::LodChain chain_;
+};
+
+// Test: Each level has about ratio times the triangles of the previous one
+// and a larger error.
+TEST_F(LodChainTest, LevelsGetCoarser) {
+  ASSERT_EQ(chain_.size(), 4u);
+  EXPECT_EQ(chain_[0].data, full_);
+  EXPECT_EQ(chain_[0].triangle_count, sphere_.triangles.size() / 3);
+  EXPECT_EQ(chain_[0].error, 0.0f);
+  for (size_t i = 1; i < chain_.size(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_LE(chain_[i].triangle_count, chain_[i - 1].triangle_count / 4);
+    EXPECT_GT(chain_[i].error, chain_[i - 1].error);
+    EXPECT_LT(chain_[i].data->edge_count, chain_[i - 1].data->edge_count);
+    EXPECT_LT(chain_[i].data->vertices.size(),
+              chain_[i - 1].data->vertices.size());
+  }
+}
+
+// Test: Small meshes and max_levels 1 give only the full scene.
+TEST_F(LodChainTest, SmallMeshesKeepOneLevel) {
+  settings_.min_triangles = sphere_.triangles.size();
+  EXPECT_EQ(
+      s21::LodChain::Build(full_, sphere_.triangles, {}, settings_).size(),
+      1u);
+  settings_.min_triangles = 1;
+  settings_.max_levels = 1;
+  EXPECT_EQ(
+      s21::LodChain::Build(full_, sphere_.triangles, {}, settings_).size(),
+      1u);
+}
+
+// Returns the edges of drawing data as ordered vertex pairs.
+std::set<std::pair<uint32_t, uint32_t>> Edges(const s21::DrawSceneData& data) {
+  std::set<std::pair<uint32_t, uint32_t>> edges;
+  for (const s21::EdgeBatch& batch : data.edge_batches) {
+    for (size_t i = 0; i < batch.count; i += 2) {
+      const uint32_t a = data.EdgeIndex(batch, i);
+      const uint32_t b = data.EdgeIndex(batch, i + 1);
+      edges.emplace(std::min(a, b), std::max(a, b));
+    }
+  }
+  return edges;
+}
+
+// Test: Levels of a quad mesh draw the quad sides of their triangles, not
+// the diagonals, like the full scene.
+TEST_F(LodChainTest, LevelsDrawPolygonSidesOnly) {
+  const s21::LodChain quads = s21::LodChain::Build(
+      full_, sphere_.triangles, sphere_.quad_sides, settings_);
+  ASSERT_EQ(quads.size(), chain_.size());
+  for (size_t i = 1; i < quads.size(); ++i) {
+    SCOPED_TRACE(i);
+    // The marks do not change the collapses, only the edges drawn
+    EXPECT_EQ(quads[i].triangle_count, chain_[i].triangle_count);
+    ASSERT_EQ(quads[i].data->vertices.size(),
+              chain_[i].data->vertices.size());
+    const auto sides = Edges(*quads[i].data);
+    const auto all = Edges(*chain_[i].data);
+    EXPECT_EQ(sides.size(), quads[i].data->edge_count);
+    EXPECT_LT(sides.size(), all.size());
+    EXPECT_TRUE(std::includes(all.begin(), all.end(), sides.begin(),
+                              sides.end()));
+  }
+}
+
+// Test: The coarsest level whose projected error fits is selected.
+TEST_F(LodChainTest, SelectsByProjectedError) {
+  EXPECT_EQ(chain_.Select(1e9f, 1.0f), 0u);
+  EXPECT_EQ(chain_.Select(1e-3f, 1.0f), chain_.size() - 1);
+  const float ppu = 1.0f / chain_[2].error;
+  EXPECT_EQ(chain_.Select(ppu, 1.0f), 2u);
+  EXPECT_EQ(chain_.Select(ppu, 0.99f), 1u);
+  EXPECT_EQ(s21::LodChain().Select(1.0f, 1.0f), 0u);
+}
+
+// Test: A view near the error limit keeps its level.
+TEST_F(LodChainTest, SelectKeepsLevelNearLimit) {
+  ASSERT_GT(chain_.size(), 2u);
+  const float ppu = 1.0f / chain_[2].error;
+  const float h = s21::LodChain::kHysteresis;
+  // Slightly over the limit: level 2 stays, level 1 does not coarsen yet
+  EXPECT_EQ(chain_.Select(ppu, 0.9f, 2), 2u);
+  EXPECT_EQ(chain_.Select(ppu, 1.1f, 1), 1u);
+  // Clearly past the limit the level changes
+  EXPECT_LT(chain_.Select(ppu, 0.99f / h, 2), 2u);
+  EXPECT_GE(chain_.Select(ppu, 1.01f * h, 1), 2u);
+  // Without a valid current level it is the plain selection
+  EXPECT_EQ(chain_.Select(ppu, 1.0f, chain_.size()), 2u);
+}
+
+// Test: A serialized chain restores for the same scene and settings only.
+TEST_F(LodChainTest, SerializeRoundTrip) {
+  const std::string bytes = chain_.Serialize(settings_);
+  s21::LodChain loaded;
+  ASSERT_TRUE(s21::LodChain::Deserialize(bytes, full_, settings_, loaded));
+  ASSERT_EQ(loaded.size(), chain_.size());
+  EXPECT_EQ(loaded[0].data, full_);
+  for (size_t i = 1; i < chain_.size(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_EQ(loaded[i].triangle_count, chain_[i].triangle_count);
+    EXPECT_EQ(loaded[i].error, chain_[i].error);
+    EXPECT_EQ(loaded[i].data->vertices.size(),
+              chain_[i].data->vertices.size());
+    EXPECT_EQ(loaded[i].data->index_data, chain_[i].data->index_data);
+    EXPECT_EQ(loaded[i].data->edge_count, chain_[i].data->edge_count);
+    EXPECT_EQ(loaded[i].data->edge_batches.size(),
+              chain_[i].data->edge_batches.size());
+  }
+
+  s21::LodChain rejected;
+  s21::LodChain::Settings other = settings_;
+  other.ratio = 0.5f;
+  EXPECT_FALSE(s21::LodChain::Deserialize(bytes, full_, other, rejected));
+  EXPECT_FALSE(s21::LodChain::Deserialize(bytes, Sphere(8, 16).DrawData(),
+                                          settings_, rejected));
+  EXPECT_FALSE(s21::LodChain::Deserialize(bytes.substr(0, bytes.size() - 1),
+                                          full_, settings_, rejected));
+  EXPECT_FALSE(s21::LodChain::Deserialize(bytes + '\0', full_, settings_,
+                                          rejected));
+  EXPECT_EQ(rejected.size(), 0u);
+}
+
+// Test: Slow frames loosen the error limit and fast frames restore it.
+TEST(FrameBudgetTest, ScalesWithFrameTime) {
+  s21::FrameBudget budget(10.0, 0.25f);
+  EXPECT_EQ(budget.Scale(), 1.0f);
+  budget.Update(20.0);
+  EXPECT_EQ(budget.Scale(), 2.0f);
+  for (int i = 0; i < 10; ++i) budget.Update(20.0);
+  EXPECT_EQ(budget.Scale(), s21::FrameBudget::kMaxScale);
+
+  // The finer level takes four times as long, so it must fit in half the
+  // budget: 4 ms frames keep the scale, 1 ms frames halve it.
+  budget.Update(4.0);
+  EXPECT_EQ(budget.Scale(), s21::FrameBudget::kMaxScale);
+  budget.Update(1.0);
+  EXPECT_EQ(budget.Scale(), s21::FrameBudget::kMaxScale / 2);
+  for (int i = 0; i < 10; ++i) budget.Update(1.0);
+  EXPECT_EQ(budget.Scale(), 1.0f);
+
+  // Frames of a level still streaming skip most of the drawing, so their
+  // short times must not refine the level
+  budget.Update(20.0);
+  EXPECT_EQ(budget.Scale(), 2.0f);
+  for (int i = 0; i < 10; ++i) budget.Update(0.1, false);
+  EXPECT_EQ(budget.Scale(), 2.0f);
+  budget.Update(0.1);
+  EXPECT_EQ(budget.Scale(), 1.0f);
+
+  s21::FrameBudget disabled;
+  disabled.Update(1e6);
+  EXPECT_EQ(disabled.Scale(), 1.0f);
+}
@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "obj/obj_data.h"
+#include "position_arrays.h"
+#include "quantized_positions.h"
+#include "transform_matrix_builder.h"
+#include "vertex_transform.h"
+
+// Mat4f is a std::array, so argument-dependent lookup misses its operators.
+using s21::operator*;
+
+// Times a transform over all positions and returns milliseconds per run,
+// the best of a few runs.
+template <typename Transform>
+double TimeTransform(Transform transform) {
+  double best = 0;
+  for (int run = 0; run < 3; ++run) {
+    auto start = std::chrono::steady_clock::now();
+    transform();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (run == 0 || elapsed.count() < best) best = elapsed.count();
+  }
+  return best;
+}
+
+// Compares the per-vertex Mat4f * Vec4f path Scene used before with the
+// batched affine and projective kernels.
+void Run(size_t count) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+  std::vector<s21::Vec3f> in(count);
+  for (auto& v : in) v = s21::Vec3f(coord(rng), coord(rng), coord(rng));
+  std::vector<s21::Vec3f> out(count);
+
+  const s21::Mat4f affine =
+      s21::TransformMatrixBuilder::CreateMoveMatrix(0.1f, 0.2f, 0.3f) *
+      s21::TransformMatrixBuilder::CreateRotationMatrix(0.5f, 0.6f, 0.7f) *
+      s21::TransformMatrixBuilder::CreateScaleMatrix(1.5f, 1.5f, 1.5f);
+  s21::Mat4f projective = affine;
+  projective[3] = {0.0f, 0.0f, -0.5f, 2.0f};
+
+  const double generic = TimeTransform([&] {
+    for (size_t i = 0; i < count; ++i) {
+      auto [x, y, z, w] = s21::Vec4f(in[i]) * affine;
+      out[i] = s21::Vec3f(x, y, z);
+    }
+  });
+  const double batched_affine = TimeTransform([&] {
+    s21::VertexTransform::Apply<true>(affine, in.data(), out.data(), count);
+  });
+  const double batched_projective = TimeTransform([&] {
+    s21::VertexTransform::Apply<false>(projective, in.data(), out.data(),
+                                       count);
+  });
+
+  const double mvertices = count / 1e6;
+  std::cout << count << " vertices\n"
+            << "  Mat4f * Vec4f:        " << generic << " ms ("
+            << mvertices / generic * 1e3 << " Mvert/s)\n"
+            << "  batched affine:       " << batched_affine << " ms ("
+            << mvertices / batched_affine * 1e3 << " Mvert/s, "
+            << generic / batched_affine << "x)\n"
+            << "  batched projective:   " << batched_projective << " ms ("
+            << mvertices / batched_projective * 1e3 << " Mvert/s)\n";
+
+  // Packed positions against coordinate arrays. Normalizing is timed from
+  // scratch, bounds included; repeating it on normalized data costs the same.
+  s21::OBJData packed;
+  packed.vertices = in;
+  s21::PositionArrays arrays(in);
+  s21::Vec3f min, max;
+  const double packed_bounds = TimeTransform([&] { packed.UpdateBounds(); });
+  const double arrays_bounds = TimeTransform([&] { arrays.Bounds(min, max); });
+  const double packed_normalize = TimeTransform([&] {
+    packed.UpdateBounds();
+    packed.Normalize();
+  });
+  const double arrays_normalize = TimeTransform([&] { arrays.Normalize(); });
+  const double arrays_affine = TimeTransform([&] {
+    s21::VertexTransform::ApplyArrays(affine, arrays.x(), arrays.y(),
+                                      arrays.z(), out.data(), count);
+  });
+  std::cout << "  bounds packed/arrays:     " << packed_bounds << " / "
+            << arrays_bounds << " ms\n"
+            << "  normalize packed/arrays:  " << packed_normalize << " / "
+            << arrays_normalize << " ms\n"
+            << "  affine packed/arrays:     " << batched_affine << " / "
+            << arrays_affine << " ms\n";
+
+  // Encoding for the 16-bit GPU upload.
+  s21::QuantizedPositions quantized;
+  const double quantize = TimeTransform(
+      [&] { quantized = s21::QuantizedPositions(in.data(), count); });
+  std::cout << "  quantize:                 " << quantize << " ms, "
+            << count * sizeof(s21::Vec3f) / (1 << 20) << " -> "
+            << quantized.bytes() / (1 << 20) << " MB, max error "
+            << quantized.MaxError() << '\n';
+}
+
+// Benchmarks 1M, 10M and 50M vertices, or the counts given as arguments.
+int main(int argc, char** argv) {
+  std::cout << "Instruction set: " << s21::VertexTransform::InstructionSet()
+            << '\n';
+  if (argc > 1) {
+    for (int i = 1; i < argc; ++i) Run(std::strtoull(argv[i], nullptr, 10));
+    return 0;
+  }
+  for (size_t count : {1000000, 10000000, 50000000}) Run(count);
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include "position_arrays.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../parallel.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace s21 {
+
+namespace {
+
+// Finds the smallest and largest of n > 0 floats starting at p.
+void MinMax(const float* p, size_t n, float& lo, float& hi) {
+  lo = hi = p[0];
+  size_t i = 0;
+#ifdef __SSE2__
+  if (n >= 8) {
+    // Two pairs of accumulators hide the latency of min and max.
+    __m128 lo0 = _mm_loadu_ps(p), hi0 = lo0;
+    __m128 lo1 = _mm_loadu_ps(p + 4), hi1 = lo1;
+    for (i = 8; i + 8 <= n; i += 8) {
+      const __m128 a = _mm_loadu_ps(p + i), b = _mm_loadu_ps(p + i + 4);
+      lo0 = _mm_min_ps(lo0, a);
+      hi0 = _mm_max_ps(hi0, a);
+      lo1 = _mm_min_ps(lo1, b);
+      hi1 = _mm_max_ps(hi1, b);
+    }
+    float lows[4], highs[4];
+    _mm_storeu_ps(lows, _mm_min_ps(lo0, lo1));
+    _mm_storeu_ps(highs, _mm_max_ps(hi0, hi1));
+    lo = *std::min_element(lows, lows + 4);
+    hi = *std::max_element(highs, highs + 4);
+  }
+#endif
+  for (; i < n; ++i) {
+    lo = std::min(lo, p[i]);
+    hi = std::max(hi, p[i]);
+  }
+}
+
+// Replaces every float v of [p, p + n) with (v - mid) * scale.
+void Rescale(float* p, size_t n, float mid, float scale) {
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128 offset = _mm_set1_ps(mid), factor = _mm_set1_ps(scale);
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(p + i,
+                  _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p + i), offset), factor));
+  }
+#endif
+  for (; i < n; ++i) p[i] = (p[i] - mid) * scale;
+}
+
+}  // namespace
+
+PositionArrays::PositionArrays(const std::vector<Vec3f>& positions)
+    : x_(positions.size()), y_(positions.size()), z_(positions.size()) {
+  for (size_t i = 0; i < positions.size(); ++i) {
+    x_[i] = positions[i].x;
+    y_[i] = positions[i].y;
+    z_[i] = positions[i].z;
+  }
+}
+
+bool PositionArrays::Bounds(Vec3f& min, Vec3f& max) const {
+  if (empty()) return false;
+  MinMax(x_.data(), size(), min.x, max.x);
+  MinMax(y_.data(), size(), min.y, max.y);
+  MinMax(z_.data(), size(), min.z, max.z);
+  return true;
+}
+
+void PositionArrays::Normalize() {
+  Vec3f min, max;
+  if (!Bounds(min, max)) return;
+
+  // The center and scale of OBJData::Normalize().
+  const Vec3f mid((max.x + min.x) / 2.0f, (max.y + min.y) / 2.0f,
+                  (max.z + min.z) / 2.0f);
+  const float dx = std::max(std::abs(max.x - mid.x), std::abs(min.x - mid.x));
+  const float dy = std::max(std::abs(max.y - mid.y), std::abs(min.y - mid.y));
+  const float dz = std::max(std::abs(max.z - mid.z), std::abs(min.z - mid.z));
+  float scale_factor = std::max({dx, dy, dz}) * 2.0f;
+  if (scale_factor == 0.0f) scale_factor = 1.0f;
+  const float scale = 1.0f / scale_factor;
+
+  constexpr size_t kGrain = size_t{1} << 16;
+  ParallelFor(size(), kGrain, [&](size_t first, size_t last) {
+    Rescale(x_.data() + first, last - first, mid.x, scale);
+    Rescale(y_.data() + first, last - first, mid.y, scale);
+    Rescale(z_.data() + first, last - first, mid.z, scale);
+  });
+}
+
+void PositionArrays::Interleave(Vec3f* out) const {
+  for (size_t i = 0; i < size(); ++i) out[i] = Vec3f(x_[i], y_[i], z_[i]);
+}
+
+}  // namespace s21
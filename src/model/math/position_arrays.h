@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "data_structures.h"
+
+namespace s21 {
+
+/**
+ * @enum VertexLayout
+ * @brief How a scene keeps the positions it transforms on the CPU.
+ */
+enum class VertexLayout {
+  kInterleaved,  ///< Packed x, y, z per vertex, as uploaded to the GPU.
+  kArrays,       ///< Separate x, y and z arrays (PositionArrays).
+};
+
+/**
+ * @struct AlignedAllocator
+ * @brief Allocator returning storage aligned to kAlignment bytes.
+ * @tparam T Element type.
+ * @tparam kAlignment Alignment in bytes, a power of two.
+ */
+template <typename T, size_t kAlignment>
+struct AlignedAllocator {
+  using value_type = T;  ///< Element type.
+
+  /// Rebinds the allocator to another element type.
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, kAlignment>;  ///< The rebound type.
+  };
+
+  AlignedAllocator() = default;
+
+  /// Converts from an allocator of another element type.
+  template <typename U>
+  explicit AlignedAllocator(const AlignedAllocator<U, kAlignment>&) {}
+
+  /**
+   * @brief Allocates storage for n elements.
+   * @param n Number of elements.
+   * @return Aligned, uninitialized storage.
+   */
+  T* allocate(size_t n) {
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t{kAlignment}));
+  }
+
+  /**
+   * @brief Frees storage returned by allocate().
+   * @param p The storage.
+   */
+  void deallocate(T* p, size_t) {
+    ::operator delete(p, std::align_val_t{kAlignment});
+  }
+
+  /// All instances share the same heap.
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, kAlignment>&) const {
+    return true;
+  }
+
+  /// All instances share the same heap.
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, kAlignment>&) const {
+    return false;
+  }
+};
+
+/**
+ * @class PositionArrays
+ * @brief Vertex positions stored as separate x, y and z arrays.
+ *
+ * Each coordinate array starts on a 64-byte boundary, so bounds,
+ * normalization and transforms run on whole vector registers without the
+ * shuffles the packed Vec3f layout needs. The GPU still takes packed
+ * positions; Interleave() and VertexTransform::ApplyArrays() produce them
+ * when the data is uploaded.
+ */
+class PositionArrays {
+ public:
+  /// Alignment of every coordinate array in bytes.
+  static constexpr size_t kAlignment = 64;
+  /// A coordinate array.
+  using Floats = std::vector<float, AlignedAllocator<float, kAlignment>>;
+
+  PositionArrays() = default;
+
+  /**
+   * @brief Splits packed positions into coordinate arrays.
+   * @param positions The packed positions.
+   */
+  explicit PositionArrays(const std::vector<Vec3f>& positions);
+
+  /**
+   * @brief Returns the number of positions.
+   * @return The length of each coordinate array.
+   */
+  size_t size() const { return x_.size(); }
+
+  /**
+   * @brief Checks whether there are no positions.
+   * @return true if the arrays are empty.
+   */
+  bool empty() const { return x_.empty(); }
+
+  /**
+   * @brief Returns a position.
+   * @param i Index of the position, below size().
+   * @return The position as a packed vector.
+   */
+  Vec3f operator[](size_t i) const { return Vec3f(x_[i], y_[i], z_[i]); }
+
+  const float* x() const { return x_.data(); }  ///< The x coordinates.
+  const float* y() const { return y_.data(); }  ///< The y coordinates.
+  const float* z() const { return z_.data(); }  ///< The z coordinates.
+
+  /**
+   * @brief Computes the bounding box of the positions.
+   * @param min Receives the smallest coordinates.
+   * @param max Receives the largest coordinates.
+   * @return false, leaving min and max untouched, if there are no positions.
+   */
+  bool Bounds(Vec3f& min, Vec3f& max) const;
+
+  /**
+   * @brief Centers the positions and fits them into [-0.5, 0.5].
+   *
+   * Uses the same center and scale as OBJData::Normalize(), so both layouts
+   * give the same result.
+   */
+  void Normalize();
+
+  /**
+   * @brief Writes the positions in the packed layout.
+   * @param out Receives size() positions.
+   */
+  void Interleave(Vec3f* out) const;
+
+ private:
+  Floats x_;  ///< The x coordinates.
+  Floats y_;  ///< The y coordinates.
+  Floats z_;  ///< The z coordinates.
+};
+
+}  // namespace s21
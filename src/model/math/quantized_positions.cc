@@ -0,0 +1,169 @@
+#include "quantized_positions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+#include "../parallel.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace s21 {
+
+namespace {
+
+constexpr size_t kGrain = size_t{1} << 16;
+
+// Quantizes one coordinate and returns its decoding error. Rounds like the
+// SSE conversion, to nearest with ties to even.
+float Encode(float v, float offset, float step, float inv_step,
+             int16_t& out) {
+  constexpr float kLimit = QuantizedPositions::kMaxValue;
+  out = static_cast<int16_t>(
+      std::nearbyint(std::clamp((v - offset) * inv_step, -kLimit, kLimit)));
+  return std::abs(out * step + offset - v);
+}
+
+#ifdef __SSE2__
+
+// Four packed positions span three registers, (x y z x), (y z x y) and
+// (z x y z); per-axis constants are loaded in the same three rotations.
+struct Rotations {
+  __m128 r[3];  ///< The constant in each rotation.
+
+  explicit Rotations(const Vec3f& v)
+      : r{_mm_setr_ps(v.x, v.y, v.z, v.x), _mm_setr_ps(v.y, v.z, v.x, v.y),
+          _mm_setr_ps(v.z, v.x, v.y, v.z)} {}
+};
+
+// Extends [min, max] by positions [first, last), four at a time.
+size_t BoundsSse2(const Vec3f* positions, size_t first, size_t last,
+                  Vec3f& min, Vec3f& max) {
+  if (last - first < 4) return first;
+  const float* p = &positions[first].x;
+  __m128 lo[3], hi[3];
+  for (int k = 0; k < 3; ++k) lo[k] = hi[k] = _mm_loadu_ps(p + 4 * k);
+  size_t i = first + 4;
+  for (p += 12; i + 4 <= last; i += 4, p += 12) {
+    for (int k = 0; k < 3; ++k) {
+      const __m128 v = _mm_loadu_ps(p + 4 * k);
+      lo[k] = _mm_min_ps(lo[k], v);
+      hi[k] = _mm_max_ps(hi[k], v);
+    }
+  }
+  float l[12], h[12];
+  for (int k = 0; k < 3; ++k) {
+    _mm_storeu_ps(l + 4 * k, lo[k]);
+    _mm_storeu_ps(h + 4 * k, hi[k]);
+  }
+  // Lane j of the block holds axis j % 3.
+  float* mins[3] = {&min.x, &min.y, &min.z};
+  float* maxs[3] = {&max.x, &max.y, &max.z};
+  for (int j = 0; j < 12; ++j) {
+    *mins[j % 3] = std::min(*mins[j % 3], l[j]);
+    *maxs[j % 3] = std::max(*maxs[j % 3], h[j]);
+  }
+  return i;
+}
+
+// Encodes positions [first, last), four at a time, and returns the index of
+// the first one left.
+size_t EncodeSse2(const Vec3f* positions, size_t first, size_t last,
+                  const Vec3f& offset, const Vec3f& step,
+                  const Vec3f& inv_step, int16_t* out, float& error) {
+  const Rotations off(offset), st(step), inv(inv_step);
+  const __m128 limit = _mm_set1_ps(QuantizedPositions::kMaxValue);
+  const __m128 neg_limit = _mm_set1_ps(-QuantizedPositions::kMaxValue);
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  __m128 err = _mm_setzero_ps();
+
+  size_t i = first;
+  for (; i + 4 <= last; i += 4) {
+    const float* p = &positions[i].x;
+    __m128i q[3];
+    for (int k = 0; k < 3; ++k) {
+      const __m128 v = _mm_loadu_ps(p + 4 * k);
+      const __m128 scaled = _mm_mul_ps(_mm_sub_ps(v, off.r[k]), inv.r[k]);
+      q[k] = _mm_cvtps_epi32(
+          _mm_min_ps(_mm_max_ps(scaled, neg_limit), limit));
+      const __m128 decoded =
+          _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(q[k]), st.r[k]), off.r[k]);
+      err = _mm_max_ps(err, _mm_and_ps(_mm_sub_ps(decoded, v), abs_mask));
+    }
+    int16_t* dst = out + i * 3;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_packs_epi32(q[0], q[1]));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 8),
+                     _mm_packs_epi32(q[2], q[2]));
+  }
+  float lanes[4];
+  _mm_storeu_ps(lanes, err);
+  error = std::max({error, lanes[0], lanes[1], lanes[2], lanes[3]});
+  return i;
+}
+
+#endif
+
+}  // namespace
+
+QuantizedPositions::QuantizedPositions(const Vec3f* positions, size_t count)
+    : values_(count * 3) {
+  if (count == 0) return;
+
+  Vec3f min = positions[0], max = positions[0];
+  std::mutex mutex;
+  ParallelFor(count, kGrain, [&](size_t first, size_t last) {
+    Vec3f lo = positions[first], hi = positions[first];
+    size_t i = first;
+#ifdef __SSE2__
+    i = BoundsSse2(positions, first, last, lo, hi);
+#endif
+    for (; i < last; ++i) {
+      const Vec3f& v = positions[i];
+      lo = Vec3f(std::min(lo.x, v.x), std::min(lo.y, v.y), std::min(lo.z, v.z));
+      hi = Vec3f(std::max(hi.x, v.x), std::max(hi.y, v.y), std::max(hi.z, v.z));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    min = Vec3f(std::min(min.x, lo.x), std::min(min.y, lo.y),
+                std::min(min.z, lo.z));
+    max = Vec3f(std::max(max.x, hi.x), std::max(max.y, hi.y),
+                std::max(max.z, hi.z));
+  });
+
+  offset_ = Vec3f((min.x + max.x) / 2.0f, (min.y + max.y) / 2.0f,
+                  (min.z + max.z) / 2.0f);
+  step_ = Vec3f((max.x - min.x) / (2.0f * kMaxValue),
+                (max.y - min.y) / (2.0f * kMaxValue),
+                (max.z - min.z) / (2.0f * kMaxValue));
+  const Vec3f inv(step_.x > 0.0f ? 1.0f / step_.x : 0.0f,
+                  step_.y > 0.0f ? 1.0f / step_.y : 0.0f,
+                  step_.z > 0.0f ? 1.0f / step_.z : 0.0f);
+
+  ParallelFor(count, kGrain, [&](size_t first, size_t last) {
+    float error = 0.0f;
+    size_t i = first;
+#ifdef __SSE2__
+    i = EncodeSse2(positions, first, last, offset_, step_, inv,
+                   values_.data(), error);
+#endif
+    for (; i < last; ++i) {
+      const Vec3f& v = positions[i];
+      int16_t* out = &values_[i * 3];
+      error = std::max({error, Encode(v.x, offset_.x, step_.x, inv.x, out[0]),
+                        Encode(v.y, offset_.y, step_.y, inv.y, out[1]),
+                        Encode(v.z, offset_.z, step_.z, inv.z, out[2])});
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    max_error_ = std::max(max_error_, error);
+  });
+}
+
+Vec3f QuantizedPositions::Decode(size_t i) const {
+  const int16_t* v = &values_[i * 3];
+  return Vec3f(v[0] * step_.x + offset_.x, v[1] * step_.y + offset_.y,
+               v[2] * step_.z + offset_.z);
+}
+
+}  // namespace s21
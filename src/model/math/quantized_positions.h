@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "data_structures.h"
+
+namespace s21 {
+
+/**
+ * @class QuantizedPositions
+ * @brief Vertex positions packed as three 16-bit integers each.
+ *
+ * Every axis of the bounding box is divided into 65535 steps around its
+ * center, and a position is stored as the nearest step on each axis, so it
+ * takes 6 bytes instead of the 12 of a Vec3f. A position decodes as
+ * value * Step() + Offset() per coordinate, which a vertex shader does with
+ * one multiply-add. The error is at most half a step on each axis; the
+ * largest error actually made is measured while encoding.
+ */
+class QuantizedPositions {
+ public:
+  /// Largest magnitude of a stored coordinate.
+  static constexpr int kMaxValue = 32767;
+
+  QuantizedPositions() = default;
+
+  /**
+   * @brief Encodes positions.
+   * @param positions The positions.
+   * @param count Number of positions.
+   */
+  QuantizedPositions(const Vec3f* positions, size_t count);
+
+  /**
+   * @brief Returns the number of positions.
+   * @return Number of encoded positions.
+   */
+  size_t size() const { return values_.size() / 3; }
+
+  /**
+   * @brief Returns the packed coordinates.
+   * @return x, y and z of every position in turn.
+   */
+  const int16_t* data() const { return values_.data(); }
+
+  /**
+   * @brief Returns the size of the packed coordinates.
+   * @return Bytes of data().
+   */
+  size_t bytes() const { return values_.size() * sizeof(int16_t); }
+
+  /**
+   * @brief Returns the decoded size of one step of a stored coordinate.
+   * @return The step per axis; 0 on an axis where all positions are equal.
+   */
+  const Vec3f& Step() const { return step_; }
+
+  /**
+   * @brief Returns the position a stored 0 decodes to.
+   * @return The center of the bounding box.
+   */
+  const Vec3f& Offset() const { return offset_; }
+
+  /**
+   * @brief Returns the largest coordinate error of the encoding.
+   * @return The largest difference between an original and a decoded
+   * coordinate.
+   */
+  float MaxError() const { return max_error_; }
+
+  /**
+   * @brief Decodes a position.
+   * @param i Index of the position, below size().
+   * @return The position as the GPU sees it.
+   */
+  Vec3f Decode(size_t i) const;
+
+ private:
+  std::vector<int16_t> values_;  ///< x, y and z of every position.
+  Vec3f step_;                   ///< Decoded size of one step per axis.
+  Vec3f offset_;                 ///< Center of the bounding box.
+  float max_error_ = 0.0f;       ///< Largest coordinate error.
+};
+
+}  // namespace s21
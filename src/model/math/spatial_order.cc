@@ -0,0 +1,79 @@
+#include "spatial_order.h"
+
+#include <algorithm>
+
+#include "../parallel.h"
+
+namespace s21 {
+
+namespace {
+
+constexpr size_t kGrain = size_t{1} << 16;
+
+// Maps a coordinate in [min, min + extent] to a cell index.
+uint32_t Cell(float v, float min, float scale) {
+  constexpr float kLast = (1u << SpatialOrder::kBitsPerAxis) - 1;
+  return static_cast<uint32_t>(std::clamp((v - min) * scale, 0.0f, kLast));
+}
+
+}  // namespace
+
+std::vector<uint32_t> SpatialOrder::Morton(const Vec3f* positions,
+                                           size_t count) {
+  if (count == 0) return {};
+
+  Vec3f min = positions[0], max = positions[0];
+  for (size_t i = 1; i < count; ++i) {
+    const Vec3f& v = positions[i];
+    min = Vec3f(std::min(min.x, v.x), std::min(min.y, v.y),
+                std::min(min.z, v.z));
+    max = Vec3f(std::max(max.x, v.x), std::max(max.y, v.y),
+                std::max(max.z, v.z));
+  }
+  // One scale for all axes keeps the cells cubic.
+  const float extent =
+      std::max({max.x - min.x, max.y - min.y, max.z - min.z});
+  const float scale =
+      extent > 0.0f ? (1u << kBitsPerAxis) / extent : 0.0f;
+
+  // Keys hold the code above the original index, so sorting the code bits
+  // stably yields the order in the low half.
+  std::vector<uint64_t> keys(count);
+  ParallelFor(count, kGrain, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      const Vec3f& v = positions[i];
+      const uint32_t code = Encode(Cell(v.x, min.x, scale),
+                                   Cell(v.y, min.y, scale),
+                                   Cell(v.z, min.z, scale));
+      keys[i] = uint64_t{code} << 32 | i;
+    }
+  });
+
+  // Least significant digit radix sort over the code, three digits.
+  constexpr int kDigitBits = kBitsPerAxis;
+  constexpr size_t kBuckets = size_t{1} << kDigitBits;
+  std::vector<uint64_t> sorted(count);
+  for (int shift = 32; shift < 32 + 3 * kBitsPerAxis; shift += kDigitBits) {
+    std::vector<size_t> starts(kBuckets + 1, 0);
+    for (uint64_t key : keys) ++starts[((key >> shift) & (kBuckets - 1)) + 1];
+    for (size_t b = 1; b <= kBuckets; ++b) starts[b] += starts[b - 1];
+    for (uint64_t key : keys) {
+      sorted[starts[(key >> shift) & (kBuckets - 1)]++] = key;
+    }
+    keys.swap(sorted);
+  }
+
+  std::vector<uint32_t> order(count);
+  for (size_t i = 0; i < count; ++i) order[i] = static_cast<uint32_t>(keys[i]);
+  return order;
+}
+
+std::vector<uint32_t> SpatialOrder::Invert(const std::vector<uint32_t>& order) {
+  std::vector<uint32_t> place(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    place[order[i]] = static_cast<uint32_t>(i);
+  }
+  return place;
+}
+
+}  // namespace s21
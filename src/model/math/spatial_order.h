@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "data_structures.h"
+
+namespace s21 {
+
+/**
+ * @enum VertexOrder
+ * @brief Order in which a scene stores its vertices.
+ */
+enum class VertexOrder {
+  kFile,    ///< As listed in the file.
+  kMorton,  ///< Along a Z-order curve through the bounding box.
+};
+
+/**
+ * @class SpatialOrder
+ * @brief Orders positions so that neighbours in space are close in memory.
+ *
+ * Exporters often list vertices in an order unrelated to their position, so
+ * the edges of a face reference vertices far apart in the vertex buffer.
+ * Sorting the vertices by their Morton code, the bits of the cell
+ * coordinates interleaved, keeps nearby vertices together: transform and
+ * bounding box passes and the vertex fetch of the GPU then reuse cache lines,
+ * and more edges fit into 16-bit index batches.
+ */
+class SpatialOrder {
+ public:
+  /// Cells per axis are 2 to the power of this.
+  static constexpr int kBitsPerAxis = 10;
+
+  /**
+   * @brief Computes the Morton order of positions.
+   * @param positions The positions.
+   * @param count Number of positions.
+   * @return The original index of the position at each new place. Positions
+   * in the same cell keep their relative order.
+   */
+  static std::vector<uint32_t> Morton(const Vec3f* positions, size_t count);
+
+  /**
+   * @brief Inverts a permutation.
+   * @param order The original index at each new place, see Morton().
+   * @return The new place of each original index.
+   */
+  static std::vector<uint32_t> Invert(const std::vector<uint32_t>& order);
+
+  /**
+   * @brief Returns the Morton code of a cell.
+   * @param x Cell coordinate on the x axis, below 2^kBitsPerAxis.
+   * @param y Cell coordinate on the y axis, below 2^kBitsPerAxis.
+   * @param z Cell coordinate on the z axis, below 2^kBitsPerAxis.
+   * @return The bits of x, y and z interleaved, x lowest.
+   */
+  static uint32_t Encode(uint32_t x, uint32_t y, uint32_t z) {
+    return Spread(x) | Spread(y) << 1 | Spread(z) << 2;
+  }
+
+ private:
+  /// Moves the low kBitsPerAxis bits of v to every third bit.
+  static uint32_t Spread(uint32_t v) {
+    v &= 0x3ff;
+    v = (v | v << 16) & 0x030000ff;
+    v = (v | v << 8) & 0x0300f00f;
+    v = (v | v << 4) & 0x030c30c3;
+    v = (v | v << 2) & 0x09249249;
+    return v;
+  }
+};
+
+}  // namespace s21
@@ -1,9 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 #include "data_structures.h"
+#include "position_arrays.h"
+#include "quantized_positions.h"
+#include "spatial_order.h"
 #include "transform_matrix_builder.h"
+#include "vertex_transform.h"
 
 using namespace s21;
 
@@ -184,6 +192,228 @@ TEST(TransformMatrixBuilderTest, ScaleMatrix) {
       if (i != j) EXPECT_NEAR(scale[i][j], 0.0f, 1e-5);
 }
 
+//========================
+// VertexTransform Tests
+//========================
+
+// Builds count distinct positions.
+std::vector<Vec3f> MakePositions(size_t count) {
+  std::vector<Vec3f> positions(count);
+  for (size_t i = 0; i < count; ++i) {
+    positions[i] = Vec3f(0.5f * i, 1.0f - 0.25f * i, 0.125f * i * i);
+  }
+  return positions;
+}
+
+// Transforms a position the way Scene did before the batched kernels.
+Vec3f ReferenceTransform(const Mat4f& m, const Vec3f& v, bool divide) {
+  Vec4f r = m * Vec4f(v);
+  if (divide) return Vec3f(r.x / r.w, r.y / r.w, r.z / r.w);
+  return Vec3f(r.x, r.y, r.z);
+}
+
+TEST(VertexTransformTest, AffineMatchesReference) {
+  const Mat4f m =
+      TransformMatrixBuilder::CreateMoveMatrix(1.0f, -2.0f, 3.0f) *
+      TransformMatrixBuilder::CreateRotationMatrix(0.3f, 0.7f, 1.1f) *
+      TransformMatrixBuilder::CreateScaleMatrix(2.0f, 0.5f, 1.5f);
+  ASSERT_TRUE(VertexTransform::IsAffine(m));
+  // Every count up to a few vector widths, to cover the scalar tails.
+  for (size_t count = 0; count <= 27; ++count) {
+    const std::vector<Vec3f> in = MakePositions(count);
+    std::vector<Vec3f> out(count);
+    VertexTransform::Apply(m, in.data(), out.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+      const Vec3f expected = ReferenceTransform(m, in[i], false);
+      EXPECT_NEAR(out[i].x, expected.x, 1e-4) << count << ':' << i;
+      EXPECT_NEAR(out[i].y, expected.y, 1e-4) << count << ':' << i;
+      EXPECT_NEAR(out[i].z, expected.z, 1e-4) << count << ':' << i;
+    }
+  }
+}
+
+TEST(VertexTransformTest, ProjectiveDividesByW) {
+  Mat4f m = TransformMatrixBuilder::CreateRotationMatrix(0.2f, 0.4f, 0.6f);
+  m[3] = {0.1f, 0.05f, 0.02f, 2.0f};
+  ASSERT_FALSE(VertexTransform::IsAffine(m));
+  const std::vector<Vec3f> in = MakePositions(21);
+  std::vector<Vec3f> out(in.size());
+  VertexTransform::Apply(m, in.data(), out.data(), in.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    const Vec3f expected = ReferenceTransform(m, in[i], true);
+    EXPECT_NEAR(out[i].x, expected.x, 1e-4) << i;
+    EXPECT_NEAR(out[i].y, expected.y, 1e-4) << i;
+    EXPECT_NEAR(out[i].z, expected.z, 1e-4) << i;
+  }
+}
+
+TEST(VertexTransformTest, TransformsInPlace) {
+  const Mat4f m = TransformMatrixBuilder::CreateScaleMatrix(2.0f, 3.0f, 4.0f);
+  std::vector<Vec3f> positions = MakePositions(19);
+  const std::vector<Vec3f> original = positions;
+  VertexTransform::Apply<true>(m, positions.data(), positions.data(),
+                               positions.size());
+  for (size_t i = 0; i < positions.size(); ++i) {
+    EXPECT_FLOAT_EQ(positions[i].x, original[i].x * 2.0f);
+    EXPECT_FLOAT_EQ(positions[i].y, original[i].y * 3.0f);
+    EXPECT_FLOAT_EQ(positions[i].z, original[i].z * 4.0f);
+  }
+}
+
+// Test: The array kernel gives the same packed output as the packed one.
+TEST(VertexTransformTest, ArraysMatchPacked) {
+  Mat4f projective = TransformMatrixBuilder::CreateRotationMatrix(0.3f, 0.1f,
+                                                                  0.7f);
+  projective[3] = {0.1f, 0.05f, 0.02f, 2.0f};
+  const Mat4f affine = TransformMatrixBuilder::CreateMoveMatrix(1, 2, 3) *
+                       TransformMatrixBuilder::CreateScaleMatrix(2, 2, 2);
+  for (const Mat4f& m : {affine, projective}) {
+    for (size_t count = 0; count < 28; ++count) {
+      const std::vector<Vec3f> in = MakePositions(count);
+      const PositionArrays arrays(in);
+      std::vector<Vec3f> packed(count), split(count);
+      VertexTransform::Apply(m, in.data(), packed.data(), count);
+      VertexTransform::ApplyArrays(m, arrays.x(), arrays.y(), arrays.z(),
+                                   split.data(), count);
+      for (size_t i = 0; i < count; ++i) {
+        EXPECT_NEAR(split[i].x, packed[i].x, 1e-4) << count << ':' << i;
+        EXPECT_NEAR(split[i].y, packed[i].y, 1e-4) << count << ':' << i;
+        EXPECT_NEAR(split[i].z, packed[i].z, 1e-4) << count << ':' << i;
+      }
+    }
+  }
+}
+
+//========================
+// PositionArrays Tests
+//========================
+
+// Checks that two positions are exactly equal.
+bool SamePosition(const Vec3f& a, const Vec3f& b) {
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+// Test: Splitting and interleaving keeps every position, in aligned arrays.
+TEST(PositionArraysTest, RoundTripsAndAligns) {
+  const std::vector<Vec3f> in = MakePositions(13);
+  const PositionArrays arrays(in);
+  ASSERT_EQ(arrays.size(), in.size());
+  for (const float* p : {arrays.x(), arrays.y(), arrays.z()}) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % PositionArrays::kAlignment, 0u);
+  }
+  std::vector<Vec3f> out(in.size());
+  arrays.Interleave(out.data());
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_TRUE(SamePosition(out[i], in[i])) << i;
+    EXPECT_TRUE(SamePosition(arrays[i], in[i])) << i;
+  }
+}
+
+// Test: Bounds match a scalar scan for every remainder length.
+TEST(PositionArraysTest, BoundsMatchScalar) {
+  Vec3f min, max;
+  EXPECT_FALSE(PositionArrays().Bounds(min, max));
+  for (size_t count = 1; count < 20; ++count) {
+    std::vector<Vec3f> in = MakePositions(count);
+    in[count / 2] = Vec3f(-7.0f, 9.0f, -0.5f);
+    ASSERT_TRUE(PositionArrays(in).Bounds(min, max));
+    Vec3f lo = in[0], hi = in[0];
+    for (const Vec3f& v : in) {
+      lo = Vec3f(std::min(lo.x, v.x), std::min(lo.y, v.y),
+                 std::min(lo.z, v.z));
+      hi = Vec3f(std::max(hi.x, v.x), std::max(hi.y, v.y),
+                 std::max(hi.z, v.z));
+    }
+    EXPECT_TRUE(SamePosition(min, lo)) << count;
+    EXPECT_TRUE(SamePosition(max, hi)) << count;
+  }
+}
+
+// Test: Normalization centers the positions and fits the widest axis.
+TEST(PositionArraysTest, NormalizeCentersAndFits) {
+  PositionArrays arrays(std::vector<Vec3f>{
+      {1.0f, 2.0f, 3.0f}, {5.0f, 4.0f, 3.0f}, {3.0f, 3.0f, 3.5f}});
+  arrays.Normalize();
+  EXPECT_FLOAT_EQ(arrays[0].x, -0.5f);
+  EXPECT_FLOAT_EQ(arrays[1].x, 0.5f);
+  EXPECT_FLOAT_EQ(arrays[0].y, -0.25f);
+  EXPECT_FLOAT_EQ(arrays[1].y, 0.25f);
+  EXPECT_FLOAT_EQ(arrays[2].z, 0.0625f);
+
+  PositionArrays point(std::vector<Vec3f>{{2.0f, 2.0f, 2.0f}});
+  point.Normalize();
+  EXPECT_TRUE(SamePosition(point[0], Vec3f(0.0f, 0.0f, 0.0f)));
+}
+
+//========================
+// QuantizedPositions Tests
+//========================
+
+// Test: Every decoded coordinate is within the reported error, which is at
+// most half a step plus float rounding.
+TEST(QuantizedPositionsTest, ErrorIsBoundedAndReported) {
+  const std::vector<Vec3f> in = MakePositions(1000);
+  const QuantizedPositions quantized(in.data(), in.size());
+  ASSERT_EQ(quantized.size(), in.size());
+  EXPECT_EQ(quantized.bytes(), in.size() * sizeof(Vec3f) / 2);
+
+  float error = 0.0f, magnitude = 0.0f;
+  for (size_t i = 0; i < in.size(); ++i) {
+    const Vec3f v = quantized.Decode(i);
+    error = std::max({error, std::abs(v.x - in[i].x),
+                      std::abs(v.y - in[i].y), std::abs(v.z - in[i].z)});
+    magnitude = std::max({magnitude, std::abs(in[i].x), std::abs(in[i].y),
+                          std::abs(in[i].z)});
+  }
+  const Vec3f& step = quantized.Step();
+  EXPECT_FLOAT_EQ(quantized.MaxError(), error);
+  EXPECT_LE(error, std::max({step.x, step.y, step.z}) * 0.5f +
+                       magnitude * 4 * std::numeric_limits<float>::epsilon());
+  EXPECT_GT(error, 0.0f);
+}
+
+// Test: The bounding box maps onto the full range, and a flat axis decodes
+// exactly.
+TEST(QuantizedPositionsTest, BoxCornersAndFlatAxis) {
+  const std::vector<Vec3f> in{{-1.0f, 5.0f, 2.0f}, {3.0f, 5.0f, 2.0f}};
+  const QuantizedPositions quantized(in.data(), in.size());
+  EXPECT_EQ(quantized.data()[0], -QuantizedPositions::kMaxValue);
+  EXPECT_EQ(quantized.data()[3], QuantizedPositions::kMaxValue);
+  EXPECT_FLOAT_EQ(quantized.Offset().x, 1.0f);
+  EXPECT_FLOAT_EQ(quantized.Step().y, 0.0f);
+  for (size_t i = 0; i < in.size(); ++i) {
+    const Vec3f v = quantized.Decode(i);
+    EXPECT_NEAR(v.x, in[i].x, 1e-6) << i;
+    EXPECT_FLOAT_EQ(v.y, 5.0f) << i;
+    EXPECT_FLOAT_EQ(v.z, 2.0f) << i;
+  }
+  EXPECT_EQ(QuantizedPositions(nullptr, 0).size(), 0u);
+}
+
+// Test: Morton codes interleave the cell bits with x lowest.
+TEST(SpatialOrderTest, EncodeInterleavesBits) {
+  EXPECT_EQ(SpatialOrder::Encode(0, 0, 0), 0u);
+  EXPECT_EQ(SpatialOrder::Encode(1, 0, 0), 1u);
+  EXPECT_EQ(SpatialOrder::Encode(0, 1, 0), 2u);
+  EXPECT_EQ(SpatialOrder::Encode(0, 0, 1), 4u);
+  EXPECT_EQ(SpatialOrder::Encode(3, 0, 0), 9u);
+  EXPECT_EQ(SpatialOrder::Encode(1023, 1023, 1023), (1u << 30) - 1);
+}
+
+// Test: The order is a permutation sorted by code, stable within a cell, and
+// Invert() undoes it.
+TEST(SpatialOrderTest, MortonSortsByCodeStably) {
+  const std::vector<Vec3f> in{{1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f},
+                              {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f},
+                              {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f}};
+  const std::vector<uint32_t> order = SpatialOrder::Morton(in.data(), 6);
+  EXPECT_EQ(order, (std::vector<uint32_t>{1, 3, 2, 4, 0, 5}));
+
+  const std::vector<uint32_t> place = SpatialOrder::Invert(order);
+  for (uint32_t i = 0; i < order.size(); ++i) EXPECT_EQ(place[order[i]], i);
+  EXPECT_TRUE(SpatialOrder::Morton(nullptr, 0).empty());
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,295 @@
+#include "vertex_transform.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define S21_TRANSFORM_X86 1
+#endif
+
+namespace s21 {
+
+namespace {
+
+/**
+ * @struct PackedSource
+ * @brief Reads positions from a packed Vec3f array.
+ */
+struct PackedSource {
+  const Vec3f* positions;  ///< The positions.
+
+  /// Returns position i.
+  Vec3f operator[](size_t i) const { return positions[i]; }
+};
+
+/**
+ * @struct ArraySource
+ * @brief Reads positions from separate coordinate arrays.
+ */
+struct ArraySource {
+  const float* x;  ///< The x coordinates.
+  const float* y;  ///< The y coordinates.
+  const float* z;  ///< The z coordinates.
+
+  /// Returns position i.
+  Vec3f operator[](size_t i) const { return Vec3f(x[i], y[i], z[i]); }
+};
+
+template <typename Source>
+using TransformFunction = void (*)(const Mat4f&, Source, Vec3f*, size_t,
+                                   size_t);
+
+// Transforms positions [first, last) one at a time; also handles the tails
+// of the vector kernels.
+template <bool kAffine, typename Source>
+void ApplyScalar(const Mat4f& m, Source in, Vec3f* out, size_t first,
+                 size_t last) {
+  for (size_t i = first; i < last; ++i) {
+    const Vec3f v = in[i];
+    float x = m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z + m[0][3];
+    float y = m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z + m[1][3];
+    float z = m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z + m[2][3];
+    if constexpr (!kAffine) {
+      const float inv_w =
+          1.0f / (m[3][0] * v.x + m[3][1] * v.y + m[3][2] * v.z + m[3][3]);
+      x *= inv_w;
+      y *= inv_w;
+      z *= inv_w;
+    }
+    out[i] = Vec3f(x, y, z);
+  }
+}
+
+#ifdef S21_TRANSFORM_X86
+
+// Four packed positions span three registers, a = (x0 y0 z0 x1),
+// b = (y1 z1 x2 y2) and c = (z2 x3 y3 z3). The shuffles below convert them
+// to and from one register per coordinate. They stay within 128-bit lanes,
+// so the AVX versions handle two groups of four positions at once.
+
+inline void Deinterleave(__m128 a, __m128 b, __m128 c, __m128& x, __m128& y,
+                         __m128& z) {
+  x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)),
+                     _MM_SHUFFLE(2, 0, 3, 0));
+  y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                     _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                     _MM_SHUFFLE(2, 0, 2, 0));
+  z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c,
+                     _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+inline void Interleave(__m128 x, __m128 y, __m128 z, __m128& a, __m128& b,
+                       __m128& c) {
+  a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)),
+                     _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)),
+                     _MM_SHUFFLE(2, 0, 2, 0));
+  b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)),
+                     _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)),
+                     _MM_SHUFFLE(2, 0, 2, 0));
+  c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+                     _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)),
+                     _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+// Loads positions i to i + 3 as one register per coordinate.
+inline void Load(PackedSource in, size_t i, __m128& x, __m128& y, __m128& z) {
+  const float* p = &in.positions[i].x;
+  Deinterleave(_mm_loadu_ps(p), _mm_loadu_ps(p + 4), _mm_loadu_ps(p + 8), x,
+               y, z);
+}
+
+inline void Load(ArraySource in, size_t i, __m128& x, __m128& y, __m128& z) {
+  x = _mm_loadu_ps(in.x + i);
+  y = _mm_loadu_ps(in.y + i);
+  z = _mm_loadu_ps(in.z + i);
+}
+
+// Transforms four positions per step with SSE2.
+template <bool kAffine, typename Source>
+void ApplySse2(const Mat4f& m, Source in, Vec3f* out, size_t first,
+               size_t last) {
+  __m128 k[4][4];
+  for (int r = 0; r < 4; ++r) {
+    for (int col = 0; col < 4; ++col) k[r][col] = _mm_set1_ps(m[r][col]);
+  }
+  auto row = [&k](int r, __m128 x, __m128 y, __m128 z) {
+    return _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(k[r][0], x), _mm_mul_ps(k[r][1], y)),
+        _mm_add_ps(_mm_mul_ps(k[r][2], z), k[r][3]));
+  };
+
+  size_t i = first;
+  for (; i + 4 <= last; i += 4) {
+    __m128 x, y, z;
+    Load(in, i, x, y, z);
+    __m128 tx = row(0, x, y, z), ty = row(1, x, y, z), tz = row(2, x, y, z);
+    if constexpr (!kAffine) {
+      const __m128 inv_w = _mm_div_ps(_mm_set1_ps(1.0f), row(3, x, y, z));
+      tx = _mm_mul_ps(tx, inv_w);
+      ty = _mm_mul_ps(ty, inv_w);
+      tz = _mm_mul_ps(tz, inv_w);
+    }
+    __m128 a, b, c;
+    Interleave(tx, ty, tz, a, b, c);
+    float* dst = &out[i].x;
+    _mm_storeu_ps(dst, a);
+    _mm_storeu_ps(dst + 4, b);
+    _mm_storeu_ps(dst + 8, c);
+  }
+  ApplyScalar<kAffine>(m, in, out, i, last);
+}
+
+__attribute__((target("avx2,fma"))) inline void Deinterleave(
+    __m256 a, __m256 b, __m256 c, __m256& x, __m256& y, __m256& z) {
+  x = _mm256_shuffle_ps(a, _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)),
+                        _MM_SHUFFLE(2, 0, 3, 0));
+  y = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                        _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                        _MM_SHUFFLE(2, 0, 2, 0));
+  z = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c,
+                        _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+__attribute__((target("avx2,fma"))) inline void Interleave(
+    __m256 x, __m256 y, __m256 z, __m256& a, __m256& b, __m256& c) {
+  a = _mm256_shuffle_ps(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)),
+                        _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)),
+                        _MM_SHUFFLE(2, 0, 2, 0));
+  b = _mm256_shuffle_ps(_mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)),
+                        _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)),
+                        _MM_SHUFFLE(2, 0, 2, 0));
+  c = _mm256_shuffle_ps(_mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+                        _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)),
+                        _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+// Loads positions i to i + 7 as one register per coordinate. The low lanes
+// hold positions i to i + 3 and the high lanes the other four.
+__attribute__((target("avx2,fma"))) inline void Load(PackedSource in,
+                                                     size_t i, __m256& x,
+                                                     __m256& y, __m256& z) {
+  const float* p = &in.positions[i].x;
+  const __m256 l0 = _mm256_loadu_ps(p), l1 = _mm256_loadu_ps(p + 8),
+               l2 = _mm256_loadu_ps(p + 16);
+  Deinterleave(_mm256_permute2f128_ps(l0, l1, 0x30),
+               _mm256_permute2f128_ps(l0, l2, 0x21),
+               _mm256_permute2f128_ps(l1, l2, 0x30), x, y, z);
+}
+
+__attribute__((target("avx2,fma"))) inline void Load(ArraySource in, size_t i,
+                                                     __m256& x, __m256& y,
+                                                     __m256& z) {
+  // Plain loads already put positions i to i + 3 in the low lanes.
+  x = _mm256_loadu_ps(in.x + i);
+  y = _mm256_loadu_ps(in.y + i);
+  z = _mm256_loadu_ps(in.z + i);
+}
+
+// Transforms eight positions per step with AVX2 and FMA.
+template <bool kAffine, typename Source>
+__attribute__((target("avx2,fma"))) void ApplyAvx2(const Mat4f& m, Source in,
+                                                   Vec3f* out, size_t first,
+                                                   size_t last) {
+  __m256 k[4][4];
+  for (int r = 0; r < 4; ++r) {
+    for (int col = 0; col < 4; ++col) k[r][col] = _mm256_set1_ps(m[r][col]);
+  }
+
+  size_t i = first;
+  for (; i + 8 <= last; i += 8) {
+    __m256 x, y, z;
+    Load(in, i, x, y, z);
+    __m256 t[4];
+    for (int r = 0; r < (kAffine ? 3 : 4); ++r) {
+      t[r] = _mm256_fmadd_ps(
+          k[r][0], x,
+          _mm256_fmadd_ps(k[r][1], y, _mm256_fmadd_ps(k[r][2], z, k[r][3])));
+    }
+    if constexpr (!kAffine) {
+      const __m256 inv_w = _mm256_div_ps(_mm256_set1_ps(1.0f), t[3]);
+      for (int r = 0; r < 3; ++r) t[r] = _mm256_mul_ps(t[r], inv_w);
+    }
+    __m256 a, b, c;
+    Interleave(t[0], t[1], t[2], a, b, c);
+    float* dst = &out[i].x;
+    _mm256_storeu_ps(dst, _mm256_permute2f128_ps(a, b, 0x20));
+    _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(c, a, 0x30));
+    _mm256_storeu_ps(dst + 16, _mm256_permute2f128_ps(b, c, 0x31));
+  }
+  ApplyScalar<kAffine>(m, in, out, i, last);
+}
+
+#endif
+
+/**
+ * @struct Kernels
+ * @brief The kernels of one instruction set.
+ */
+struct Kernels {
+  TransformFunction<PackedSource> affine;      ///< Skips the bottom row.
+  TransformFunction<PackedSource> projective;  ///< Divides by w.
+  TransformFunction<ArraySource> affine_arrays;      ///< Affine, from arrays.
+  TransformFunction<ArraySource> projective_arrays;  ///< Projective, arrays.
+  const char* name;                                  ///< Instruction set.
+};
+
+// Picks the widest implementation the CPU supports.
+Kernels SelectKernels() {
+#ifdef S21_TRANSFORM_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return {ApplyAvx2<true, PackedSource>, ApplyAvx2<false, PackedSource>,
+            ApplyAvx2<true, ArraySource>, ApplyAvx2<false, ArraySource>,
+            "avx2"};
+  }
+  return {ApplySse2<true, PackedSource>, ApplySse2<false, PackedSource>,
+          ApplySse2<true, ArraySource>, ApplySse2<false, ArraySource>, "sse2"};
+#else
+  return {ApplyScalar<true, PackedSource>, ApplyScalar<false, PackedSource>,
+          ApplyScalar<true, ArraySource>, ApplyScalar<false, ArraySource>,
+          "scalar"};
+#endif
+}
+
+const Kernels kKernels = SelectKernels();
+
+}  // namespace
+
+template <bool kAffine>
+void VertexTransform::Apply(const Mat4f& matrix, const Vec3f* in, Vec3f* out,
+                            size_t count) {
+  (kAffine ? kKernels.affine : kKernels.projective)(
+      matrix, PackedSource{in}, out, 0, count);
+}
+
+template void VertexTransform::Apply<true>(const Mat4f&, const Vec3f*, Vec3f*,
+                                           size_t);
+template void VertexTransform::Apply<false>(const Mat4f&, const Vec3f*,
+                                            Vec3f*, size_t);
+
+void VertexTransform::Apply(const Mat4f& matrix, const Vec3f* in, Vec3f* out,
+                            size_t count) {
+  if (IsAffine(matrix)) {
+    Apply<true>(matrix, in, out, count);
+  } else {
+    Apply<false>(matrix, in, out, count);
+  }
+}
+
+void VertexTransform::ApplyArrays(const Mat4f& matrix, const float* x,
+                                  const float* y, const float* z, Vec3f* out,
+                                  size_t count) {
+  const ArraySource in{x, y, z};
+  if (IsAffine(matrix)) {
+    kKernels.affine_arrays(matrix, in, out, 0, count);
+  } else {
+    kKernels.projective_arrays(matrix, in, out, 0, count);
+  }
+}
+
+bool VertexTransform::IsAffine(const Mat4f& matrix) {
+  return matrix[3][0] == 0.0f && matrix[3][1] == 0.0f &&
+         matrix[3][2] == 0.0f && matrix[3][3] == 1.0f;
+}
+
+const char* VertexTransform::InstructionSet() { return kKernels.name; }
+
+}  // namespace s21
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+
+#include "data_structures.h"
+
+namespace s21 {
+
+/**
+ * @class VertexTransform
+ * @brief Vectorized transformation of packed vertex positions.
+ *
+ * Positions are transformed as column vectors (x, y, z, 1) by a Mat4f, four
+ * at a time with SSE or eight at a time with AVX2 and FMA, selected at
+ * runtime. The affine kernel skips the bottom row of the matrix; the
+ * projective kernel computes it and divides by the resulting w. Vertices
+ * that do not fill a vector are transformed with scalar code. Sources can
+ * be packed Vec3f arrays or separate coordinate arrays.
+ */
+class VertexTransform {
+ public:
+  /**
+   * @brief Transforms count positions with a matrix of known kind.
+   * @tparam kAffine true if the bottom row of matrix is (0, 0, 0, 1).
+   * @param matrix The transformation.
+   * @param in Source positions.
+   * @param out Destination positions; may be equal to in, but must not
+   * overlap it otherwise.
+   * @param count Number of positions.
+   *
+   * Both kinds are instantiated in vertex_transform.cc.
+   */
+  template <bool kAffine>
+  static void Apply(const Mat4f& matrix, const Vec3f* in, Vec3f* out,
+                    size_t count);
+
+  /**
+   * @brief Transforms count positions, choosing the kernel from the matrix.
+   * @param matrix The transformation.
+   * @param in Source positions.
+   * @param out Destination positions; may be equal to in, but must not
+   * overlap it otherwise.
+   * @param count Number of positions.
+   */
+  static void Apply(const Mat4f& matrix, const Vec3f* in, Vec3f* out,
+                    size_t count);
+
+  /**
+   * @brief Transforms positions kept as coordinate arrays into packed ones.
+   * @param matrix The transformation.
+   * @param x Source x coordinates.
+   * @param y Source y coordinates.
+   * @param z Source z coordinates.
+   * @param out Destination positions, not overlapping the sources.
+   * @param count Number of positions.
+   *
+   * The arrays are read without shuffles; only the packed output is
+   * interleaved, as the GPU expects it. See PositionArrays.
+   */
+  static void ApplyArrays(const Mat4f& matrix, const float* x, const float* y,
+                          const float* z, Vec3f* out, size_t count);
+
+  /**
+   * @brief Checks whether a matrix has no projective part.
+   * @param matrix The matrix to check.
+   * @return true if its bottom row is exactly (0, 0, 0, 1).
+   */
+  static bool IsAffine(const Mat4f& matrix);
+
+  /**
+   * @brief Returns the name of the selected instruction set.
+   * @return "avx2", "sse2" or "scalar".
+   */
+  static const char* InstructionSet();
+};
+
+}  // namespace s21
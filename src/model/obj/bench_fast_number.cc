@@ -0,0 +1,56 @@
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "fast_from_chars.h"
+
+// Times a parser over all tokens and returns nanoseconds per number.
+template <typename T, typename Parser>
+double TimePerNumber(const std::vector<std::string>& tokens, Parser parse,
+                     double& checksum) {
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < 10; ++round) {
+    for (const auto& token : tokens) {
+      T value{};
+      parse(token.data(), token.data() + token.size(), value);
+      checksum += value;
+    }
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / (10.0 * tokens.size());
+}
+
+// Compares std::from_chars with s21::FastFromChars on scanner-like input.
+int main() {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+  std::vector<std::string> floats, indices;
+  char buffer[32];
+  for (int i = 0; i < 1000000; ++i) {
+    std::snprintf(buffer, sizeof(buffer), "%.6f", coord(rng));
+    floats.emplace_back(buffer);
+    indices.push_back(std::to_string(rng() % 10000000));
+  }
+
+  double checksum = 0;
+  auto std_parse = [](const char* f, const char* l, auto& v) {
+    std::from_chars(f, l, v);
+  };
+  auto fast_parse = [](const char* f, const char* l, auto& v) {
+    s21::FastFromChars(f, l, v);
+  };
+  std::cout << "kernel\t\tfloat ns\tint ns\n"
+            << "from_chars\t"
+            << TimePerNumber<float>(floats, std_parse, checksum) << '\t'
+            << TimePerNumber<int>(indices, std_parse, checksum) << '\n'
+            << "FastFromChars\t"
+            << TimePerNumber<float>(floats, fast_parse, checksum) << '\t'
+            << TimePerNumber<int>(indices, fast_parse, checksum) << '\n'
+            << "(checksum " << checksum << ")\n";
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include <zlib.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "obj_data.h"
+
+// Writes a synthetic scan-like OBJ file of roughly the requested size.
+std::string CreateSyntheticObjFile(size_t target_mb) {
+  std::string filename = "bench_obj_data.obj";
+  std::ofstream out(filename);
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+
+  const size_t target_bytes = target_mb * 1024 * 1024;
+  size_t vertices = 0;
+  out << "o Scan\n";
+  while (static_cast<size_t>(out.tellp()) < target_bytes) {
+    for (int i = 0; i < 1000; ++i, ++vertices) {
+      out << "v " << coord(rng) << ' ' << coord(rng) << ' ' << coord(rng)
+          << '\n';
+    }
+    for (int i = 0; i < 1000; ++i) {
+      out << "f -" << 1 + i % 997 << " -" << 2 + i % 997 << " -"
+          << 3 + i % 997 << '\n';
+    }
+  }
+  return filename;
+}
+
+// Reports how fast lines and tokens are found, without parsing them.
+void BenchScanner(const std::string& filename, double size_mb) {
+  std::ifstream file(filename, std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+
+  // Byte-by-byte splitting, as the parser did before LineScanner.
+  auto start = std::chrono::steady_clock::now();
+  size_t scalar_tokens = 0;
+  bool in_token = false;
+  for (char c : buffer) {
+    bool separator = c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    if (!separator && !in_token) ++scalar_tokens;
+    in_token = !separator;
+  }
+  std::chrono::duration<double> scalar =
+      std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  size_t tokens = 0;
+  s21::LineScanner::ScanLines(
+      buffer, [&](const std::string_view*, size_t count) { tokens += count; },
+      [&](std::string_view line) {
+        for (char c : line) tokens += c == ' ';
+      });
+  std::chrono::duration<double> simd = std::chrono::steady_clock::now() - start;
+
+  std::cout << "scan\tMB/s\ttokens\n"
+            << "scalar\t" << size_mb / scalar.count() << '\t' << scalar_tokens
+            << '\n'
+            << s21::LineScanner::InstructionSet() << '\t'
+            << size_mb / simd.count() << '\t' << tokens << "\n\n";
+}
+
+// Compares parsing a gzip copy of the file with parsing the file itself.
+void BenchGzip(const std::string& filename, double size_mb) {
+  std::ifstream file(filename, std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+  const std::string compressed = filename + ".gz";
+  gzFile out = gzopen(compressed.c_str(), "wb6");
+  gzwrite(out, buffer.data(), buffer.size());
+  gzclose(out);
+  buffer = std::string();
+
+  s21::OBJData plain;
+  auto start = std::chrono::steady_clock::now();
+  plain.Parse(filename);
+  std::chrono::duration<double> plain_time =
+      std::chrono::steady_clock::now() - start;
+
+  s21::OBJData gzip;
+  start = std::chrono::steady_clock::now();
+  gzip.ParseGzip(compressed);
+  std::chrono::duration<double> gzip_time =
+      std::chrono::steady_clock::now() - start;
+
+  std::ifstream gz_file(compressed, std::ios::binary | std::ios::ate);
+  std::cout << "input\tMB on disk\tseconds\tMB/s of text\n"
+            << "obj\t" << size_mb << '\t' << plain_time.count() << '\t'
+            << size_mb / plain_time.count() << '\n'
+            << "obj.gz\t" << gz_file.tellg() / (1024.0 * 1024) << '\t'
+            << gzip_time.count() << '\t' << size_mb / gzip_time.count()
+            << "\n\n";
+  std::remove(compressed.c_str());
+}
+
+// Parses the file with 1, 2, 4, ... threads and reports throughput.
+int main(int argc, char** argv) {
+  std::string filename;
+  bool generated = argc < 2;
+  if (generated) {
+    filename = CreateSyntheticObjFile(256);
+  } else {
+    filename = argv[1];
+  }
+
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  const double size_mb = static_cast<double>(file.tellg()) / (1024 * 1024);
+  const size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "File: " << filename << " (" << size_mb << " MB)\n";
+  BenchScanner(filename, size_mb);
+  BenchGzip(filename, size_mb);
+  std::cout << "threads\tseconds\tMB/s\n";
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    s21::OBJData data;
+    auto start = std::chrono::steady_clock::now();
+    data.Parse(filename, threads);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cout << threads << '\t' << elapsed.count() << '\t'
+              << size_mb / elapsed.count() << '\n';
+    if (threads < max_threads && threads * 2 > max_threads) {
+      threads = max_threads / 2;
+    }
+  }
+
+  if (generated) std::remove(filename.c_str());
+  return 0;
+}
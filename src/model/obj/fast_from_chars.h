@@ -0,0 +1,130 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+
+/**
+ * @namespace s21
+ * @brief Contains number parsing kernels used by the OBJ parser.
+ */
+namespace s21 {
+
+namespace detail {
+
+/**
+ * @brief Checks whether a character is a decimal digit.
+ * @param c The character to check.
+ * @return True for '0'..'9'.
+ */
+inline bool IsDigit(char c) {
+  return static_cast<unsigned char>(c - '0') < 10;
+}
+
+/// Maximum number of digits handled by the fast path; 10^15 < 2^53.
+inline constexpr int kMaxFastDigits = 15;
+
+/// Powers of ten that are exactly representable as double.
+inline constexpr double kExactPow10[] = {1e0,  1e1,  1e2,  1e3, 1e4,  1e5,
+                                         1e6,  1e7,  1e8,  1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15};
+
+/**
+ * @brief Checks whether a double lies exactly halfway between two floats.
+ * @param value A double within the normal float range.
+ * @return True if converting it to float would need a tie break.
+ */
+inline bool IsFloatMidpoint(double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  // The 29 mantissa bits a float drops are exactly 1000...0.
+  constexpr uint64_t kDroppedBits = (uint64_t{1} << 29) - 1;
+  return (bits & kDroppedBits) == (uint64_t{1} << 28);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Parses a float with the same result as std::from_chars.
+ * @param first Start of the characters to parse.
+ * @param last End of the characters to parse.
+ * @param value Receives the parsed value on success.
+ * @return The same pointer and error code std::from_chars would return.
+ *
+ * Plain decimals such as "-12.345678" with at most 15 digits are converted
+ * with one exact double division, which IEEE rounding makes the correctly
+ * rounded double. Rounding that to float is then correct unless the double
+ * is exactly halfway between two floats, which falls back. Exponents, long
+ * mantissas, inf/nan and malformed input go through std::from_chars.
+ */
+inline std::from_chars_result FastFromChars(const char* first,
+                                            const char* last, float& value) {
+  const char* p = first;
+  const bool negative = p != last && *p == '-';
+  if (negative) ++p;
+
+  uint64_t mantissa = 0;
+  const char* int_start = p;
+  for (; p != last && detail::IsDigit(*p); ++p) {
+    mantissa = mantissa * 10 + (*p - '0');
+  }
+  int digits = static_cast<int>(p - int_start);
+  int fraction = 0;
+  if (p != last && *p == '.') {
+    const char* frac_start = ++p;
+    for (; p != last && detail::IsDigit(*p); ++p) {
+      mantissa = mantissa * 10 + (*p - '0');
+    }
+    fraction = static_cast<int>(p - frac_start);
+    digits += fraction;
+  }
+
+  // Overflowed mantissas are discarded by the digit limit.
+  const bool is_plain_decimal =
+      digits > 0 && digits <= detail::kMaxFastDigits &&
+      (p == last || (*p != 'e' && *p != 'E'));
+  if (!is_plain_decimal) {
+    return std::from_chars(first, last, value);
+  }
+
+  // Both operands are exact, so the division is correctly rounded.
+  double result =
+      static_cast<double>(mantissa) / detail::kExactPow10[fraction];
+  if (detail::IsFloatMidpoint(result)) {
+    return std::from_chars(first, last, value);
+  }
+  value = static_cast<float>(negative ? -result : result);
+  return {p, std::errc()};
+}
+
+/**
+ * @brief Parses an int with the same result as std::from_chars.
+ * @param first Start of the characters to parse.
+ * @param last End of the characters to parse.
+ * @param value Receives the parsed value on success.
+ * @return The same pointer and error code std::from_chars would return.
+ *
+ * Numbers of up to 9 digits, which cannot overflow, are parsed inline;
+ * anything else goes through std::from_chars.
+ */
+inline std::from_chars_result FastFromChars(const char* first,
+                                            const char* last, int& value) {
+  const char* p = first;
+  const bool negative = p != last && *p == '-';
+  if (negative) ++p;
+
+  const char* digits_start = p;
+  int result = 0;
+  for (; p != last && detail::IsDigit(*p) && p - digits_start < 9; ++p) {
+    result = result * 10 + (*p - '0');
+  }
+  if (p == digits_start || (p != last && detail::IsDigit(*p))) {
+    return std::from_chars(first, last, value);
+  }
+
+  value = negative ? -result : result;
+  return {p, std::errc()};
+}
+
+}  // namespace s21
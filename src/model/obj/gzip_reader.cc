@@ -0,0 +1,221 @@
+#include "gzip_reader.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../exceptions.h"
+#include "Logger.h"
+
+namespace s21 {
+
+namespace {
+
+// Compressed bytes read from the file at once.
+constexpr size_t kInputSize = size_t{256} << 10;
+
+/**
+ * @struct Block
+ * @brief One of the two buffers shared by the inflating and parsing threads.
+ *
+ * The inflating thread owns a block until it sets ready; from then on the
+ * caller reads it until it clears ready again.
+ */
+struct Block {
+  std::vector<char> data;   ///< Decompressed text.
+  size_t size = 0;          ///< Bytes of data filled.
+  size_t lines = 0;         ///< Bytes up to and including the last line break.
+  uint64_t compressed = 0;  ///< Compressed bytes consumed for this block.
+  bool ready = false;       ///< Filled and waiting for the caller.
+  bool last = false;        ///< Holds the end of the file.
+};
+
+/**
+ * @struct InflateStream
+ * @brief Owns a zlib stream set up for gzip input.
+ */
+struct InflateStream {
+  z_stream z{};
+
+  InflateStream() {
+    // 15 window bits plus 16 accepts the gzip wrapper only.
+    if (inflateInit2(&z, 15 + 16) != Z_OK) {
+      throw MeshLoadException("Failed to initialize zlib");
+    }
+  }
+  ~InflateStream() { inflateEnd(&z); }
+};
+
+}  // namespace
+
+GzipReader::GzipReader(const std::string& filename, size_t block_size)
+    : filename_(filename), block_size_(std::max<size_t>(block_size, 1)) {
+  fd_ = open(filename.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd_ == -1 || fstat(fd_, &st) != 0) {
+    if (fd_ != -1) close(fd_);
+    LogError << "Failed to open file: " << filename << std::endl;
+    throw MeshLoadException("Failed to open file: " + filename);
+  }
+  compressed_size_ = st.st_size;
+}
+
+GzipReader::~GzipReader() { close(fd_); }
+
+void GzipReader::ReadLines(const BlockHandler& on_block) {
+  InflateStream stream;
+  std::vector<unsigned char> input(kInputSize);
+  Block blocks[2];
+  std::mutex mutex;
+  std::condition_variable changed;
+  bool stop = false;
+  std::exception_ptr error;
+
+  uint64_t read_total = 0;
+  bool end_of_input = false;
+  // Makes compressed input available; returns false at the end of the file.
+  auto refill = [&] {
+    if (stream.z.avail_in > 0) return true;
+    if (end_of_input) return false;
+    ssize_t n = read(fd_, input.data(), input.size());
+    if (n < 0) {
+      throw MeshLoadException("Failed to read file: " + filename_);
+    }
+    end_of_input = n == 0;
+    read_total += n;
+    stream.z.next_in = input.data();
+    stream.z.avail_in = static_cast<uInt>(n);
+    return !end_of_input;
+  };
+
+  // Inflates into block.data until it is full or the stream ends.
+  bool finished = false;
+  auto fill = [&](Block& block) {
+    while (!finished && block.size < block.data.size()) {
+      const bool has_input = refill();
+      stream.z.next_out = reinterpret_cast<Bytef*>(block.data.data()) +
+                          block.size;
+      stream.z.avail_out = static_cast<uInt>(std::min<size_t>(
+          block.data.size() - block.size, std::numeric_limits<uInt>::max()));
+      const uInt available = stream.z.avail_out;
+      int status = inflate(&stream.z, Z_NO_FLUSH);
+      block.size += available - stream.z.avail_out;
+
+      if (status == Z_STREAM_END) {
+        // Another gzip member may follow.
+        if (refill()) {
+          inflateReset(&stream.z);
+        } else {
+          finished = true;
+        }
+      } else if (status == Z_BUF_ERROR && !has_input) {
+        throw MeshLoadException("Unexpected end of compressed file: " +
+                                filename_);
+      } else if (status != Z_OK && status != Z_BUF_ERROR) {
+        throw MeshLoadException(
+            "Corrupt compressed file: " + filename_ + " (" +
+            (stream.z.msg ? stream.z.msg : "zlib error") + ")");
+      }
+    }
+  };
+
+  auto inflate_blocks = [&] {
+    uint64_t reported = 0;
+    const Block* previous = nullptr;
+    for (size_t k = 0; !finished; k ^= 1) {
+      Block& block = blocks[k];
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return stop || !block.ready; });
+        if (stop) return;
+      }
+
+      // Start with the partial line left over from the previous block.
+      const size_t carry = previous ? previous->size - previous->lines : 0;
+      block.data.resize(std::max({block.data.size(), block_size_, carry * 2}));
+      if (carry > 0) {
+        std::memcpy(block.data.data(), previous->data.data() + previous->lines,
+                    carry);
+      }
+      block.size = carry;
+
+      // Grow the block only while it does not hold a whole line.
+      for (;;) {
+        fill(block);
+        if (finished) {
+          block.lines = block.size;
+          break;
+        }
+        size_t last_break = std::string_view(block.data.data(), block.size)
+                                .find_last_of("\r\n");
+        if (last_break != std::string_view::npos) {
+          block.lines = last_break + 1;
+          break;
+        }
+        block.data.resize(block.data.size() * 2);
+      }
+
+      const uint64_t consumed = read_total - stream.z.avail_in;
+      block.compressed = consumed - reported;
+      reported = consumed;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        block.last = finished;
+        block.ready = true;
+      }
+      changed.notify_all();
+      previous = &block;
+    }
+  };
+
+  std::thread worker([&] {
+    try {
+      inflate_blocks();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      error = std::current_exception();
+    }
+    changed.notify_all();
+  });
+
+  try {
+    for (size_t k = 0;; k ^= 1) {
+      Block& block = blocks[k];
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return block.ready || error; });
+        if (!block.ready) std::rethrow_exception(error);
+      }
+      on_block(std::string_view(block.data.data(), block.lines),
+               block.compressed);
+      const bool last = block.last;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        block.ready = false;
+      }
+      changed.notify_all();
+      if (last) break;
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    changed.notify_all();
+    worker.join();
+    throw;
+  }
+  worker.join();
+}
+
+}  // namespace s21
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+/**
+ * @namespace s21
+ * @brief Contains classes and structures for parsing and managing OBJ file
+ * data.
+ */
+namespace s21 {
+
+/**
+ * @class GzipReader
+ * @brief Streams the lines of a gzip-compressed text file.
+ *
+ * The file is inflated on a worker thread into one of two fixed buffers
+ * while the caller processes the other, so decompression and parsing
+ * overlap and memory stays bounded no matter how large the file is. Every
+ * block handed to the caller ends at a line break; the partial line at the
+ * end of a buffer is carried over to the start of the next one. A buffer
+ * only grows if a single line does not fit in it.
+ *
+ * Files made of several concatenated gzip members are read as one stream.
+ */
+class GzipReader {
+ public:
+  /// Default size of each of the two buffers.
+  static constexpr size_t kBlockSize = size_t{4} << 20;
+
+  /**
+   * @brief Receives a block of whole lines.
+   * @param lines The decompressed text, ending at a line break unless it is
+   * the end of the file.
+   * @param compressed_bytes Compressed bytes consumed to produce the block.
+   */
+  using BlockHandler =
+      std::function<void(std::string_view lines, uint64_t compressed_bytes)>;
+
+  /**
+   * @brief Opens a compressed file.
+   * @param filename The path to the .gz file.
+   * @param block_size Size of each buffer.
+   * @throws MeshLoadException if the file cannot be opened.
+   */
+  explicit GzipReader(const std::string& filename,
+                      size_t block_size = kBlockSize);
+  ~GzipReader();
+
+  GzipReader(const GzipReader&) = delete;
+  GzipReader& operator=(const GzipReader&) = delete;
+
+  /**
+   * @brief Returns the size of the compressed file.
+   * @return File size in bytes.
+   */
+  uint64_t CompressedSize() const { return compressed_size_; }
+
+  /**
+   * @brief Inflates the whole file and passes it on in blocks of lines.
+   * @param on_block Called on the calling thread for every block, in order.
+   * @throws MeshLoadException if the data is not valid gzip. Exceptions
+   * thrown by on_block stop the inflation and are passed on.
+   */
+  void ReadLines(const BlockHandler& on_block);
+
+ private:
+  std::string filename_;      ///< Path of the file, for error messages.
+  int fd_ = -1;               ///< Descriptor of the open file.
+  uint64_t compressed_size_;  ///< Size of the file.
+  size_t block_size_;         ///< Initial size of each buffer.
+};
+
+}  // namespace s21
@@ -0,0 +1,141 @@
+#include "line_scanner.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define S21_SCANNER_X86 1
+#endif
+
+namespace s21 {
+
+namespace {
+
+using ClassifyFunction = LineScanner::Masks (*)(const char*);
+
+#ifdef S21_SCANNER_X86
+
+// Classifies 64 bytes with four 16-byte SSE2 compares per class.
+LineScanner::Masks ClassifySse2(const char* p) {
+  const __m128i lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+  const __m128i sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t');
+  LineScanner::Masks masks;
+  for (int i = 0; i < 4; ++i) {
+    __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+    __m128i newline = _mm_or_si128(_mm_cmpeq_epi8(block, lf),
+                                   _mm_cmpeq_epi8(block, cr));
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(block, sp),
+                                 _mm_cmpeq_epi8(block, tab));
+    masks.newline |=
+        static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(newline)))
+        << (i * 16);
+    masks.space |=
+        static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(space)))
+        << (i * 16);
+  }
+  return masks;
+}
+
+// Classifies 64 bytes with two 32-byte AVX2 compares per class.
+__attribute__((target("avx2"))) LineScanner::Masks ClassifyAvx2(
+    const char* p) {
+  const __m256i lf = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r');
+  const __m256i sp = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t');
+  LineScanner::Masks masks;
+  for (int i = 0; i < 2; ++i) {
+    __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i * 32));
+    __m256i newline = _mm256_or_si256(_mm256_cmpeq_epi8(block, lf),
+                                      _mm256_cmpeq_epi8(block, cr));
+    __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(block, sp),
+                                    _mm256_cmpeq_epi8(block, tab));
+    masks.newline |= static_cast<uint64_t>(static_cast<uint32_t>(
+                         _mm256_movemask_epi8(newline)))
+                     << (i * 32);
+    masks.space |= static_cast<uint64_t>(
+                       static_cast<uint32_t>(_mm256_movemask_epi8(space)))
+                   << (i * 32);
+  }
+  return masks;
+}
+
+#else
+
+// Portable fallback for architectures without a vector implementation.
+LineScanner::Masks ClassifyScalar(const char* p) {
+  LineScanner::Masks masks;
+  for (size_t i = 0; i < LineScanner::kWindow; ++i) {
+    const uint64_t bit = uint64_t{1} << i;
+    if (p[i] == '\n' || p[i] == '\r') masks.newline |= bit;
+    if (p[i] == ' ' || p[i] == '\t') masks.space |= bit;
+  }
+  return masks;
+}
+
+#endif
+
+// Picks the widest implementation the CPU supports.
+ClassifyFunction SelectClassify() {
+#ifdef S21_SCANNER_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return ClassifyAvx2;
+  return ClassifySse2;
+#else
+  return ClassifyScalar;
+#endif
+}
+
+const ClassifyFunction kClassify = SelectClassify();
+
+}  // namespace
+
+LineScanner::Masks LineScanner::Classify(const char* p, const char* end) {
+  if (end - p >= static_cast<std::ptrdiff_t>(kWindow)) return kClassify(p);
+
+  // Pad the tail of the buffer so the end reads as a line break.
+  char window[kWindow];
+  std::memset(window, '\n', kWindow);
+  std::memcpy(window, p, end - p);
+  return kClassify(window);
+}
+
+const char* LineScanner::FindLineEnd(const char* p, const char* end) {
+  for (; p < end; p += kWindow) {
+    Masks masks = Classify(p, end);
+    if (masks.newline) {
+      return std::min(p + __builtin_ctzll(masks.newline), end);
+    }
+  }
+  return end;
+}
+
+size_t LineScanner::SplitTokens(const char* line, size_t length,
+                                uint64_t space, std::string_view* tokens) {
+  // Bits of token characters within the line.
+  const uint64_t word = ~space & ((uint64_t{1} << length) - 1);
+  // First character of every token, and the position just past its end.
+  uint64_t starts = word & ~(word << 1);
+  uint64_t ends = ~word & (word << 1);
+
+  size_t count = 0;
+  while (starts) {
+    size_t start = __builtin_ctzll(starts);
+    size_t stop = __builtin_ctzll(ends);
+    tokens[count++] = std::string_view(line + start, stop - start);
+    starts &= starts - 1;
+    ends &= ends - 1;
+  }
+  return count;
+}
+
+const char* LineScanner::InstructionSet() {
+#ifdef S21_SCANNER_X86
+  return kClassify == ClassifyAvx2 ? "avx2" : "sse2";
+#else
+  return "scalar";
+#endif
+}
+
+}  // namespace s21
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @namespace s21
+ * @brief Contains classes and structures for parsing and managing OBJ file
+ * data.
+ */
+namespace s21 {
+
+/**
+ * @class LineScanner
+ * @brief Vectorized splitting of a text buffer into lines and tokens.
+ *
+ * The buffer is classified in 64-byte windows: one pass yields a bit mask of
+ * line breaks ('\n', '\r') and one of token separators (' ', '\t'). Lines
+ * that fit in a window are split into tokens straight from those masks;
+ * longer lines are handed over as raw text. SSE2 is the baseline on x86,
+ * AVX2 is selected at runtime when the CPU supports it, and other
+ * architectures use a scalar version.
+ */
+class LineScanner {
+ public:
+  /// Number of bytes classified at once.
+  static constexpr size_t kWindow = 64;
+  /// Maximum number of tokens a line within one window can have.
+  static constexpr size_t kMaxTokens = kWindow / 2;
+
+  /**
+   * @struct Masks
+   * @brief Character classes of a window, one bit per byte.
+   */
+  struct Masks {
+    uint64_t newline = 0;  ///< Bits set for '\n' and '\r'.
+    uint64_t space = 0;    ///< Bits set for ' ' and '\t'.
+  };
+
+  /**
+   * @brief Classifies the window starting at p.
+   * @param p Start of the window.
+   * @param end End of the buffer; bytes past it are treated as line breaks.
+   * @return The masks of the window.
+   */
+  static Masks Classify(const char* p, const char* end);
+
+  /**
+   * @brief Finds the first line break at or after p.
+   * @param p Position to search from.
+   * @param end End of the buffer.
+   * @return Position of the line break, or end if there is none.
+   */
+  static const char* FindLineEnd(const char* p, const char* end);
+
+  /**
+   * @brief Splits a line into tokens using its separator mask.
+   * @param line Start of the line.
+   * @param length Length of the line, less than kWindow.
+   * @param space Separator mask of the window starting at line.
+   * @param tokens Receives up to kMaxTokens tokens.
+   * @return Number of tokens written.
+   */
+  static size_t SplitTokens(const char* line, size_t length, uint64_t space,
+                            std::string_view* tokens);
+
+  /**
+   * @brief Returns the name of the selected instruction set.
+   * @return "avx2", "sse2" or "scalar".
+   */
+  static const char* InstructionSet();
+
+  /**
+   * @brief Calls a handler for every line of a buffer.
+   * @param buffer The text to scan.
+   * @param on_tokens Called as on_tokens(tokens, count) for lines shorter
+   * than a window, with count > 0.
+   * @param on_line Called as on_line(line) with the raw text of longer lines.
+   *
+   * Lines are separated by runs of '\n' and '\r'. Blank lines are skipped.
+   */
+  template <typename OnTokens, typename OnLine>
+  static void ScanLines(std::string_view buffer, OnTokens&& on_tokens,
+                        OnLine&& on_line) {
+    std::string_view tokens[kMaxTokens];
+    const char* current = buffer.data();
+    const char* end = buffer.data() + buffer.size();
+    while (current < end) {
+      Masks masks = Classify(current, end);
+      const char* line_end;
+      if (masks.newline) {
+        size_t length = __builtin_ctzll(masks.newline);
+        line_end = current + length;
+        size_t count = SplitTokens(current, length, masks.space, tokens);
+        if (count) on_tokens(tokens, count);
+      } else {
+        line_end = FindLineEnd(current + kWindow, end);
+        on_line(std::string_view(current, line_end - current));
+      }
+
+      current = line_end;
+      while (current < end && (*current == '\r' || *current == '\n')) {
+        ++current;
+      }
+    }
+  }
+};
+
+}  // namespace s21
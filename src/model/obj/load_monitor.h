@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+#include "../exceptions.h"
+
+/**
+ * @namespace s21
+ * @brief Contains classes and structures for parsing and managing OBJ file
+ * data.
+ */
+namespace s21 {
+
+/**
+ * @struct LoadProgress
+ * @brief Snapshot of how far a scene load has come.
+ */
+struct LoadProgress {
+  /**
+   * @enum Stage
+   * @brief Steps of a scene load in the order they run.
+   */
+  enum class Stage { kParsing, kNormalizing, kBuildingEdges };
+
+  Stage stage = Stage::kParsing;  ///< Step currently running.
+  uint64_t bytes_parsed = 0;      ///< Bytes of the file parsed so far.
+  uint64_t bytes_total = 0;       ///< Size of the file.
+};
+
+/**
+ * @class LoadMonitor
+ * @brief Progress reporting and cancellation shared by the stages of a load.
+ *
+ * A monitor is handed down to the parser and the scene builder, which may
+ * report from several threads at once. Progress is delivered to the callback
+ * on whichever thread reports it; reports that would overlap an ongoing one
+ * are dropped, as the next report supersedes them anyway. Cancel() may be
+ * called from any thread and makes the next checkpoint of the load throw
+ * LoadCancelledException.
+ */
+class LoadMonitor {
+ public:
+  /// Receives progress reports.
+  using Callback = std::function<void(const LoadProgress&)>;
+
+  /**
+   * @brief Creates a monitor.
+   * @param callback Receives progress reports; may be empty.
+   */
+  explicit LoadMonitor(Callback callback = {})
+      : callback_(std::move(callback)) {}
+
+  /// Requests the load to stop at its next checkpoint.
+  void Cancel() { cancelled_ = true; }
+
+  /// @return True once Cancel() has been called.
+  bool Cancelled() const { return cancelled_; }
+
+  /**
+   * @brief Checkpoint of a load.
+   * @throws LoadCancelledException if the load was cancelled.
+   */
+  void ThrowIfCancelled() const {
+    if (cancelled_) throw LoadCancelledException();
+  }
+
+  /**
+   * @brief Sets the size of the file being parsed.
+   * @param bytes File size in bytes.
+   */
+  void SetTotalBytes(uint64_t bytes) { total_ = bytes; }
+
+  /**
+   * @brief Adds parsed bytes, reports progress and checks for cancellation.
+   * @param bytes Number of bytes parsed since the last call of this thread.
+   */
+  void AddParsedBytes(uint64_t bytes) {
+    parsed_ += bytes;
+    Report();
+    ThrowIfCancelled();
+  }
+
+  /**
+   * @brief Starts a new stage, reports it and checks for cancellation.
+   * @param stage The stage about to run.
+   */
+  void SetStage(LoadProgress::Stage stage) {
+    stage_ = stage;
+    Report();
+    ThrowIfCancelled();
+  }
+
+ private:
+  Callback callback_;                   ///< Receives progress reports.
+  std::atomic<bool> cancelled_{false};  ///< Set by Cancel().
+  std::atomic<LoadProgress::Stage> stage_{
+      LoadProgress::Stage::kParsing};  ///< Current stage.
+  std::atomic<uint64_t> parsed_{0};     ///< Bytes parsed so far.
+  std::atomic<uint64_t> total_{0};      ///< Size of the file.
+  std::mutex report_mutex_;             ///< Serializes callback calls.
+
+  /// Sends the current progress to the callback unless it is busy.
+  void Report() {
+    if (!callback_) return;
+    std::unique_lock<std::mutex> lock(report_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) return;
+    callback_(LoadProgress{stage_, parsed_, total_});
+  }
+};
+
+}  // namespace s21
@@ -0,0 +1,638 @@
+#include "mesh_cache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+namespace s21 {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+static_assert(sizeof(Vec3f) == 3 * sizeof(float) &&
+                  std::is_standard_layout_v<Vec3f>,
+              "Vec3f is stored as three packed floats");
+static_assert(sizeof(Vec2f) == 2 * sizeof(float) &&
+                  std::is_standard_layout_v<Vec2f>,
+              "Vec2f is stored as two packed floats");
+static_assert(sizeof(VertexIndices) == 3 * sizeof(int) &&
+                  std::is_standard_layout_v<VertexIndices>,
+              "VertexIndices is stored as three packed ints");
+
+constexpr char kMagic[8] = {'S', '2', '1', 'M', 'E', 'S', 'H', '\0'};
+constexpr char kAttachmentMagic[8] = {'S', '2', '1', 'A', 'T', 'T', 'C', 'H'};
+constexpr const char* kExtension = ".mesh";
+
+// Long copies, hashes and writes check for cancellation once per this many
+// bytes, so a cancelled load does not wait for a multi-GB entry.
+constexpr size_t kCancelCheckBytes = size_t{64} << 20;
+
+// Throws LoadCancelledException if the optional monitor was cancelled.
+void CheckCancelled(const LoadMonitor* monitor) {
+  if (monitor) monitor->ThrowIfCancelled();
+}
+
+// Bytes sampled from the source for the content hash.
+constexpr size_t kSampleSize = 4096;
+constexpr size_t kSampleCount = 64;
+
+/**
+ * @struct Header
+ * @brief Fixed-size header at the start of every snapshot.
+ *
+ * The payload follows it as packed sections: source path, vertices,
+ * texcoords, normals, face vertices, face offsets and the serialized object
+ * structure.
+ */
+struct Header {
+  char magic[8];               ///< kMagic.
+  uint32_t version;            ///< MeshCache::kVersion.
+  uint32_t header_size;        ///< sizeof(Header), guards layout changes.
+  uint64_t source_size;        ///< Size of the source file.
+  int64_t source_mtime;        ///< Modification time of the source file.
+  uint64_t content_hash;       ///< Sampled hash of the source contents.
+  uint64_t payload_hash;       ///< Checksum of the payload.
+  uint64_t path_size;          ///< Length of the source path.
+  uint64_t vertex_count;       ///< Number of vertices.
+  uint64_t texcoord_count;     ///< Number of texture coordinates.
+  uint64_t normal_count;       ///< Number of normals.
+  uint64_t face_vertex_count;  ///< Number of face vertex references.
+  uint64_t face_offset_count;  ///< Number of face offsets.
+  uint64_t structure_size;     ///< Size of the serialized objects.
+  float bounds[6];             ///< OBJData x_min ... z_max.
+};
+
+/**
+ * @struct AttachmentHeader
+ * @brief Fixed-size header at the start of every attachment.
+ *
+ * The attachment bytes follow it as the only payload section.
+ */
+struct AttachmentHeader {
+  char magic[8];          ///< kAttachmentMagic.
+  uint32_t version;       ///< MeshCache::kVersion.
+  uint32_t header_size;   ///< sizeof(AttachmentHeader).
+  uint64_t source_size;   ///< Size of the source file.
+  int64_t source_mtime;   ///< Modification time of the source file.
+  uint64_t content_hash;  ///< Sampled hash of the source contents.
+  uint64_t payload_hash;  ///< Checksum of the payload.
+  uint64_t payload_size;  ///< Size of the payload.
+};
+
+/**
+ * @struct Section
+ * @brief A contiguous part of the payload.
+ */
+struct Section {
+  const void* data;  ///< Start of the bytes.
+  uint64_t size;     ///< Number of bytes.
+};
+
+// Mixes a hash state so every input bit affects every output bit.
+uint64_t Avalanche(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  return h ^ (h >> 33);
+}
+
+// Word-at-a-time 64-bit hash; fast enough to checksum GB-sized payloads.
+uint64_t Hash64(const void* data, size_t size, uint64_t seed,
+                const LoadMonitor* monitor = nullptr) {
+  constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ULL;
+  const char* p = static_cast<const char*>(data);
+  uint64_t h = seed ^ (size * kMultiplier);
+  for (size_t next_check = size; size >= 8; p += 8, size -= 8) {
+    if (size <= next_check) {
+      CheckCancelled(monitor);
+      next_check = size > kCancelCheckBytes ? size - kCancelCheckBytes : 0;
+    }
+    uint64_t word;
+    std::memcpy(&word, p, 8);
+    h = (h ^ (word * kMultiplier)) * kMultiplier;
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, p, size);
+  return Avalanche(h ^ tail);
+}
+
+// Splits a payload into its sections using the counts of its header.
+std::vector<Section> Sections(const Header& header, const char* payload) {
+  const uint64_t sizes[] = {header.path_size,
+                            header.vertex_count * sizeof(Vec3f),
+                            header.texcoord_count * sizeof(Vec2f),
+                            header.normal_count * sizeof(Vec3f),
+                            header.face_vertex_count * sizeof(VertexIndices),
+                            header.face_offset_count * sizeof(uint32_t),
+                            header.structure_size};
+  std::vector<Section> sections;
+  for (uint64_t size : sizes) {
+    sections.push_back({payload, size});
+    payload += size;
+  }
+  return sections;
+}
+
+// Checksum of all sections in order.
+uint64_t HashSections(const std::vector<Section>& sections,
+                      const LoadMonitor* monitor) {
+  uint64_t h = 0;
+  for (const Section& section : sections) {
+    h = Hash64(section.data, section.size, h, monitor);
+  }
+  return h;
+}
+
+// Hashes evenly spaced blocks of a file, including its first and last bytes.
+uint64_t SampleContentHash(const std::string& path, uint64_t size) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) return 0;
+  std::vector<char> block(kSampleSize);
+  uint64_t h = size;
+  const uint64_t last = size > kSampleSize ? size - kSampleSize : 0;
+  for (size_t i = 0; i < kSampleCount; ++i) {
+    const uint64_t offset = last * i / (kSampleCount - 1);
+    ssize_t read = pread(fd, block.data(), block.size(), offset);
+    if (read < 0) read = 0;
+    h = Hash64(block.data(), read, h);
+  }
+  close(fd);
+  return h;
+}
+
+// Modification time of a file in the file clock's ticks.
+int64_t ModificationTime(const std::string& path) {
+  return fs::last_write_time(path).time_since_epoch().count();
+}
+
+// Appends a trivially copyable value to a byte string.
+template <typename T>
+void Append(std::string& out, const T& value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Appends a length-prefixed string to a byte string.
+void AppendString(std::string& out, const std::string& value) {
+  Append(out, static_cast<uint32_t>(value.size()));
+  out += value;
+}
+
+/**
+ * @class ByteReader
+ * @brief Bounds-checked reading of the serialized object structure.
+ */
+class ByteReader {
+ public:
+  ByteReader(const char* data, size_t size) : p_(data), end_(data + size) {}
+
+  template <typename T>
+  bool Read(T& value) {
+    if (static_cast<size_t>(end_ - p_) < sizeof(value)) return false;
+    std::memcpy(&value, p_, sizeof(value));
+    p_ += sizeof(value);
+    return true;
+  }
+
+  bool ReadString(std::string& value) {
+    uint32_t size;
+    if (!Read(size) || static_cast<size_t>(end_ - p_) < size) return false;
+    value.assign(p_, size);
+    p_ += size;
+    return true;
+  }
+
+  bool AtEnd() const { return p_ == end_; }
+
+ private:
+  const char* p_;    ///< Next byte to read.
+  const char* end_;  ///< End of the data.
+};
+
+// Serializes objects and meshes.
+std::string SerializeStructure(const std::vector<Object>& objects) {
+  std::string out;
+  Append(out, static_cast<uint64_t>(objects.size()));
+  for (const Object& object : objects) {
+    AppendString(out, object.name);
+    Append(out, static_cast<uint64_t>(object.meshes.size()));
+    for (const Mesh& mesh : object.meshes) {
+      AppendString(out, mesh.material);
+      Append(out, static_cast<uint64_t>(mesh.first_face));
+      Append(out, static_cast<uint64_t>(mesh.face_count));
+    }
+  }
+  return out;
+}
+
+// Restores objects and meshes; checks that mesh face ranges are valid.
+bool DeserializeStructure(ByteReader reader, size_t face_count,
+                          std::vector<Object>& objects) {
+  uint64_t object_count;
+  if (!reader.Read(object_count)) return false;
+  for (uint64_t i = 0; i < object_count; ++i) {
+    Object& object = objects.emplace_back();
+    uint64_t mesh_count;
+    if (!reader.ReadString(object.name) || !reader.Read(mesh_count)) {
+      return false;
+    }
+    for (uint64_t j = 0; j < mesh_count; ++j) {
+      Mesh& mesh = object.meshes.emplace_back();
+      uint64_t first_face, count;
+      if (!reader.ReadString(mesh.material) || !reader.Read(first_face) ||
+          !reader.Read(count) || first_face > face_count ||
+          count > face_count - first_face) {
+        return false;
+      }
+      mesh.first_face = first_face;
+      mesh.face_count = count;
+    }
+  }
+  return reader.AtEnd();
+}
+
+// Writes a header and its sections to a temporary file and renames it to
+// entry, so readers never see a partial entry.
+void WriteEntry(const std::string& entry, const void* header,
+                size_t header_size, const std::vector<Section>& sections,
+                const LoadMonitor* monitor) {
+  const std::string temporary = entry + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(static_cast<const char*>(header), header_size);
+    try {
+      for (const Section& section : sections) {
+        const char* p = static_cast<const char*>(section.data);
+        for (uint64_t left = section.size; left > 0;) {
+          CheckCancelled(monitor);
+          const uint64_t slice = std::min<uint64_t>(left, kCancelCheckBytes);
+          out.write(p, slice);
+          p += slice;
+          left -= slice;
+        }
+      }
+    } catch (const LoadCancelledException&) {
+      out.close();
+      fs::remove(temporary);
+      throw;
+    }
+    out.close();
+    if (!out) {
+      fs::remove(temporary);
+      throw MeshLoadException("Failed to write " + temporary);
+    }
+  }
+  fs::rename(temporary, entry);
+}
+
+// Copies count elements of a packed array into a vector.
+template <typename T>
+void CopyArray(const char*& p, uint64_t count, std::vector<T>& out,
+               const LoadMonitor* monitor) {
+  out.resize(count);
+  char* to = reinterpret_cast<char*>(out.data());
+  for (uint64_t left = count * sizeof(T); left > 0;) {
+    CheckCancelled(monitor);
+    const uint64_t slice = std::min<uint64_t>(left, kCancelCheckBytes);
+    std::memcpy(to, p, slice);
+    to += slice;
+    p += slice;
+    left -= slice;
+  }
+}
+
+}  // namespace
+
+MeshCache::Settings MeshCache::DefaultSettings() {
+  Settings settings;
+  if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+    settings.directory = std::string(xdg) + "/3DViewer/meshes";
+  } else if (const char* home = std::getenv("HOME"); home && *home) {
+    settings.directory = std::string(home) + "/.cache/3DViewer/meshes";
+  }
+  return settings;
+}
+
+bool MeshCache::Stamp(const std::string& source, SourceStamp& stamp) {
+  std::error_code error;
+  const uint64_t size = fs::file_size(source, error);
+  if (error) return false;
+  const fs::file_time_type mtime = fs::last_write_time(source, error);
+  if (error) return false;
+  stamp.size = size;
+  stamp.mtime = mtime.time_since_epoch().count();
+  stamp.content_hash = SampleContentHash(source, size);
+  return true;
+}
+
+bool MeshCache::Unchanged(const std::string& path, const SourceStamp& stamp) {
+  SourceStamp current;
+  if (Stamp(path, current) && current == stamp) return true;
+  LogInfo << path << " changed while it was read; not cached" << std::endl;
+  return false;
+}
+
+std::string MeshCache::EntryPath(const std::string& source,
+                                 std::string_view extension) const {
+  char name[17];
+  std::snprintf(name, sizeof(name), "%016llx",
+                static_cast<unsigned long long>(
+                    Hash64(source.data(), source.size(), kVersion)));
+  return (fs::path(settings_.directory) / (name + std::string(extension)))
+      .string();
+}
+
+bool MeshCache::Load(const std::string& source, OBJData& data,
+                     LoadMonitor* monitor) {
+  if (!Enabled()) return false;
+
+  std::error_code error;
+  const std::string path = fs::absolute(source, error).string();
+  const uint64_t source_size = fs::file_size(path, error);
+  if (error) return false;
+  const std::string entry = EntryPath(path, kExtension);
+
+  int fd = open(entry.c_str(), O_RDONLY);
+  if (fd == -1) return false;
+  struct stat sb;
+  if (fstat(fd, &sb) == -1 ||
+      static_cast<size_t>(sb.st_size) < sizeof(Header)) {
+    close(fd);
+    return false;
+  }
+  const uint64_t entry_size = sb.st_size;
+  void* mapped = mmap(nullptr, entry_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) return false;
+  const char* begin = static_cast<const char*>(mapped);
+
+  bool hit = false;
+  try {
+    Header header;
+    std::memcpy(&header, begin, sizeof(header));
+    const char* payload = begin + sizeof(header);
+    const uint64_t available = entry_size - sizeof(header);
+
+    // Every count is bounded by the file size, so the sums cannot overflow.
+    const bool counts_fit =
+        header.path_size <= available &&
+        header.vertex_count <= available / sizeof(Vec3f) &&
+        header.texcoord_count <= available / sizeof(Vec2f) &&
+        header.normal_count <= available / sizeof(Vec3f) &&
+        header.face_vertex_count <= available / sizeof(VertexIndices) &&
+        header.face_offset_count <= available / sizeof(uint32_t) &&
+        header.structure_size <= available;
+    const bool valid =
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+        header.version == kVersion && header.header_size == sizeof(Header) &&
+        counts_fit &&
+        header.path_size + header.vertex_count * sizeof(Vec3f) +
+                header.texcoord_count * sizeof(Vec2f) +
+                header.normal_count * sizeof(Vec3f) +
+                header.face_vertex_count * sizeof(VertexIndices) +
+                header.face_offset_count * sizeof(uint32_t) +
+                header.structure_size ==
+            available &&
+        header.source_size == source_size &&
+        header.source_mtime == ModificationTime(path) &&
+        std::string_view(payload, header.path_size) == path &&
+        header.content_hash == SampleContentHash(path, source_size) &&
+        header.payload_hash ==
+            HashSections(Sections(header, payload), monitor);
+
+    if (valid) {
+      OBJData loaded;
+      const char* p = payload + header.path_size;
+      CopyArray(p, header.vertex_count, loaded.vertices, monitor);
+      CopyArray(p, header.texcoord_count, loaded.texcoords, monitor);
+      CopyArray(p, header.normal_count, loaded.normals, monitor);
+      CopyArray(p, header.face_vertex_count, loaded.face_vertices, monitor);
+      CopyArray(p, header.face_offset_count, loaded.face_offsets, monitor);
+      loaded.x_min = header.bounds[0];
+      loaded.x_max = header.bounds[1];
+      loaded.y_min = header.bounds[2];
+      loaded.y_max = header.bounds[3];
+      loaded.z_min = header.bounds[4];
+      loaded.z_max = header.bounds[5];
+
+      hit = !loaded.face_offsets.empty() &&
+            loaded.face_offsets.front() == 0 &&
+            loaded.face_offsets.back() == loaded.face_vertices.size() &&
+            DeserializeStructure(ByteReader(p, header.structure_size),
+                                 loaded.FaceCount(), loaded.objects);
+      if (hit) data = std::move(loaded);
+    }
+  } catch (const LoadCancelledException&) {
+    munmap(mapped, entry_size);
+    throw;
+  } catch (const std::exception& e) {
+    LogWarning << "Mesh cache entry " << entry << " unreadable: " << e.what()
+               << std::endl;
+    hit = false;
+  }
+  munmap(mapped, entry_size);
+
+  if (hit) {
+    // The modification time of an entry records its last use.
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), error);
+    LogInfo << "Loaded " << source << " from mesh cache" << std::endl;
+  } else {
+    LogInfo << "Mesh cache entry for " << source << " is stale or corrupt"
+            << std::endl;
+  }
+  return hit;
+}
+
+void MeshCache::Store(const std::string& source, const SourceStamp& stamp,
+                      const OBJData& data, LoadMonitor* monitor) {
+  if (!Enabled() || stamp.size < settings_.min_source_size) return;
+
+  try {
+    const std::string path = fs::absolute(source).string();
+    if (!Unchanged(path, stamp)) return;
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.header_size = sizeof(Header);
+    header.source_size = stamp.size;
+    header.source_mtime = stamp.mtime;
+    header.content_hash = stamp.content_hash;
+
+    const std::string structure = SerializeStructure(data.objects);
+    const std::vector<Section> sections = {
+        {path.data(), path.size()},
+        {data.vertices.data(), data.vertices.size() * sizeof(Vec3f)},
+        {data.texcoords.data(), data.texcoords.size() * sizeof(Vec2f)},
+        {data.normals.data(), data.normals.size() * sizeof(Vec3f)},
+        {data.face_vertices.data(),
+         data.face_vertices.size() * sizeof(VertexIndices)},
+        {data.face_offsets.data(), data.face_offsets.size() * sizeof(uint32_t)},
+        {structure.data(), structure.size()}};
+    header.path_size = path.size();
+    header.vertex_count = data.vertices.size();
+    header.texcoord_count = data.texcoords.size();
+    header.normal_count = data.normals.size();
+    header.face_vertex_count = data.face_vertices.size();
+    header.face_offset_count = data.face_offsets.size();
+    header.structure_size = structure.size();
+    const float bounds[6] = {data.x_min, data.x_max, data.y_min,
+                             data.y_max, data.z_min, data.z_max};
+    std::memcpy(header.bounds, bounds, sizeof(bounds));
+
+    uint64_t size = sizeof(header);
+    for (const Section& section : sections) size += section.size;
+    if (size > settings_.size_limit) return;
+    header.payload_hash = HashSections(sections, monitor);
+
+    const std::string entry = EntryPath(path, kExtension);
+    fs::create_directories(settings_.directory);
+    fs::remove(entry);
+    Evict(size);
+    WriteEntry(entry, &header, sizeof(header), sections, monitor);
+  } catch (const LoadCancelledException&) {
+    throw;
+  } catch (const std::exception& e) {
+    LogWarning << "Could not cache " << source << ": " << e.what()
+               << std::endl;
+  }
+}
+
+bool MeshCache::LoadAttachment(const std::string& source,
+                               std::string_view name, std::string& bytes,
+                               LoadMonitor* monitor) {
+  if (!Enabled()) return false;
+
+  std::error_code error;
+  const std::string path = fs::absolute(source, error).string();
+  const uint64_t source_size = fs::file_size(path, error);
+  if (error) return false;
+  const std::string entry = EntryPath(path, "." + std::string(name));
+
+  bool hit = false;
+  try {
+    std::ifstream in(entry, std::ios::binary);
+    AttachmentHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+      return false;
+    }
+    const uint64_t available = fs::file_size(entry) - sizeof(header);
+    if (std::memcmp(header.magic, kAttachmentMagic,
+                    sizeof(kAttachmentMagic)) != 0 ||
+        header.version != kVersion ||
+        header.header_size != sizeof(AttachmentHeader) ||
+        header.payload_size != available ||
+        header.source_size != source_size ||
+        header.source_mtime != ModificationTime(path) ||
+        header.content_hash != SampleContentHash(path, source_size)) {
+      LogInfo << "Mesh cache attachment " << entry << " is stale"
+              << std::endl;
+      return false;
+    }
+    std::string payload(header.payload_size, '\0');
+    hit = in.read(payload.data(), payload.size()) &&
+          Hash64(payload.data(), payload.size(), 0, monitor) ==
+              header.payload_hash;
+    if (hit) bytes = std::move(payload);
+  } catch (const LoadCancelledException&) {
+    throw;
+  } catch (const std::exception& e) {
+    LogWarning << "Mesh cache attachment " << entry
+               << " unreadable: " << e.what() << std::endl;
+    hit = false;
+  }
+
+  if (hit) {
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), error);
+  } else {
+    LogInfo << "Mesh cache attachment " << entry << " is corrupt"
+            << std::endl;
+  }
+  return hit;
+}
+
+void MeshCache::StoreAttachment(const std::string& source,
+                                const SourceStamp& stamp,
+                                std::string_view name,
+                                std::string_view bytes,
+                                LoadMonitor* monitor) {
+  if (!Enabled() || stamp.size < settings_.min_source_size) return;
+
+  try {
+    const std::string path = fs::absolute(source).string();
+    if (!Unchanged(path, stamp)) return;
+    AttachmentHeader header{};
+    std::memcpy(header.magic, kAttachmentMagic, sizeof(kAttachmentMagic));
+    header.version = kVersion;
+    header.header_size = sizeof(AttachmentHeader);
+    header.source_size = stamp.size;
+    header.source_mtime = stamp.mtime;
+    header.content_hash = stamp.content_hash;
+    header.payload_size = bytes.size();
+    header.payload_hash = Hash64(bytes.data(), bytes.size(), 0, monitor);
+
+    const uint64_t size = sizeof(header) + bytes.size();
+    if (size > settings_.size_limit) return;
+
+    const std::string entry = EntryPath(path, "." + std::string(name));
+    fs::create_directories(settings_.directory);
+    fs::remove(entry);
+    Evict(size);
+    WriteEntry(entry, &header, sizeof(header),
+               {{bytes.data(), bytes.size()}}, monitor);
+  } catch (const LoadCancelledException&) {
+    throw;
+  } catch (const std::exception& e) {
+    LogWarning << "Could not cache " << name << " of " << source << ": "
+               << e.what() << std::endl;
+  }
+}
+
+void MeshCache::Evict(uint64_t incoming) {
+  // Snapshots and attachments of a source share the stem of their name.
+  struct Entry {
+    std::vector<fs::path> paths;
+    fs::file_time_type used;
+    uint64_t size = 0;
+  };
+  std::map<std::string, Entry> entries;
+  uint64_t total = incoming;
+  std::error_code error;
+  for (const auto& file : fs::directory_iterator(settings_.directory, error)) {
+    const std::string extension = file.path().extension().string();
+    // Skip foreign files and temporary files still being written.
+    if (extension.size() < 2 || extension.rfind(".tmp", 0) == 0) continue;
+    const fs::file_time_type used = file.last_write_time(error);
+    const uint64_t size = file.file_size(error);
+    if (error) continue;
+    Entry& entry = entries[file.path().stem().string()];
+    if (entry.paths.empty() || used > entry.used) entry.used = used;
+    entry.paths.push_back(file.path());
+    entry.size += size;
+    total += size;
+  }
+
+  std::vector<Entry*> order;
+  for (auto& [stem, entry] : entries) order.push_back(&entry);
+  std::sort(order.begin(), order.end(), [](const Entry* a, const Entry* b) {
+    return a->used < b->used;
+  });
+  for (const Entry* entry : order) {
+    if (total <= settings_.size_limit) break;
+    for (const fs::path& path : entry->paths) fs::remove(path, error);
+    total -= entry->size;
+  }
+}
+
+}  // namespace s21
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "load_monitor.h"
+#include "obj_data.h"
+
+/**
+ * @namespace s21
+ * @brief Contains classes and structures for parsing and managing OBJ file
+ * data.
+ */
+namespace s21 {
+
+/**
+ * @class MeshCache
+ * @brief Persistent binary snapshots of parsed OBJ files.
+ *
+ * After a file has been parsed, its OBJData is written to a cache directory
+ * as a flat binary file. Opening the same file again maps that snapshot and
+ * copies the arrays out in bulk instead of parsing text.
+ *
+ * A snapshot is used only if its header version matches and the source file
+ * still has the recorded path, size, modification time and sampled content
+ * hash, and the payload checksum is intact. Otherwise Load() reports a miss
+ * and the caller parses the text. The directory is kept under a size limit
+ * by removing the least recently used snapshots.
+ *
+ * Data derived from a source, such as its levels of detail, can be stored
+ * next to the snapshot as a named attachment. Attachments are validated
+ * against the source the same way and evicted together with the snapshot.
+ */
+class MeshCache {
+ public:
+  /**
+   * @struct Settings
+   * @brief Location and limits of the cache.
+   */
+  struct Settings {
+    std::string directory;  ///< Cache directory; empty disables the cache.
+    /// Maximum total size of the cache directory in bytes.
+    uint64_t size_limit = uint64_t{16} << 30;
+    /// Sources smaller than this parse quickly and are not cached.
+    uint64_t min_source_size = uint64_t{1} << 20;
+  };
+
+  /**
+   * @struct SourceStamp
+   * @brief Identifies the contents of a source file.
+   *
+   * Taken before a source is read and recorded in the entries derived from
+   * it, so a file rewritten while it is read is never cached under its new
+   * contents.
+   */
+  struct SourceStamp {
+    uint64_t size = 0;          ///< Size of the source file.
+    int64_t mtime = 0;          ///< Modification time of the source file.
+    uint64_t content_hash = 0;  ///< Sampled hash of the source contents.
+
+    /// Compares all fields.
+    bool operator==(const SourceStamp& other) const {
+      return size == other.size && mtime == other.mtime &&
+             content_hash == other.content_hash;
+    }
+    /// Compares all fields.
+    bool operator!=(const SourceStamp& other) const {
+      return !(*this == other);
+    }
+  };
+
+  /// Format version; bump whenever the snapshot layout or OBJData changes.
+  static constexpr uint32_t kVersion = 2;
+
+  /**
+   * @brief Creates a cache with the given settings.
+   * @param settings Location and limits of the cache.
+   */
+  explicit MeshCache(Settings settings) : settings_(std::move(settings)) {}
+
+  /**
+   * @brief Returns the default settings.
+   * @return Settings using $XDG_CACHE_HOME/3DViewer/meshes, or
+   * ~/.cache/3DViewer/meshes, or a disabled cache if neither is set.
+   */
+  static Settings DefaultSettings();
+
+  /**
+   * @brief Checks whether the cache is enabled.
+   * @return True if a cache directory is configured.
+   */
+  bool Enabled() const { return !settings_.directory.empty(); }
+
+  /**
+   * @brief Takes the stamp of a source file.
+   * @param source Path of the OBJ file.
+   * @param stamp Receives the stamp.
+   * @return False if the file cannot be inspected.
+   */
+  static bool Stamp(const std::string& source, SourceStamp& stamp);
+
+  /**
+   * @brief Loads the snapshot of a source file.
+   * @param source Path of the OBJ file.
+   * @param data Receives the cached data on a hit; untouched on a miss.
+   * @param monitor Checked for cancellation while the snapshot is verified
+   * and copied; optional.
+   * @return True on a hit, false if the snapshot is missing, stale or
+   * corrupt.
+   * @throws LoadCancelledException if the monitor cancels.
+   */
+  bool Load(const std::string& source, OBJData& data,
+            LoadMonitor* monitor = nullptr);
+
+  /**
+   * @brief Writes the snapshot of a parsed source file.
+   * @param source Path of the OBJ file the data was parsed from.
+   * @param stamp Stamp of the source taken before it was parsed; nothing is
+   * stored if the source no longer matches it.
+   * @param data The parsed data.
+   * @param monitor Checked for cancellation while the snapshot is hashed and
+   * written; optional.
+   *
+   * Failures are logged and otherwise ignored, since the cache is only an
+   * optimization. Evicts old snapshots to stay under the size limit.
+   *
+   * @throws LoadCancelledException if the monitor cancels; nothing is then
+   * stored.
+   */
+  void Store(const std::string& source, const SourceStamp& stamp,
+             const OBJData& data, LoadMonitor* monitor = nullptr);
+
+  /**
+   * @brief Loads an attachment of a source file.
+   * @param source Path of the OBJ file.
+   * @param name Kind of attachment, a lowercase word other than "mesh".
+   * @param bytes Receives the attachment on a hit; untouched on a miss.
+   * @param monitor Checked for cancellation while the attachment is
+   * verified; optional.
+   * @return True on a hit, false if the attachment is missing, stale or
+   * corrupt.
+   * @throws LoadCancelledException if the monitor cancels.
+   */
+  bool LoadAttachment(const std::string& source, std::string_view name,
+                      std::string& bytes, LoadMonitor* monitor = nullptr);
+
+  /**
+   * @brief Writes an attachment of a source file.
+   * @param source Path of the OBJ file the attachment was derived from.
+   * @param stamp Stamp of the source taken before it was read, as for
+   * Store().
+   * @param name Kind of attachment, a lowercase word other than "mesh".
+   * @param bytes The attachment.
+   * @param monitor Checked for cancellation as in Store(); optional.
+   *
+   * Like Store(), failures are only logged, small sources are skipped and
+   * old entries are evicted to stay under the size limit.
+   *
+   * @throws LoadCancelledException if the monitor cancels.
+   */
+  void StoreAttachment(const std::string& source, const SourceStamp& stamp,
+                       std::string_view name, std::string_view bytes,
+                       LoadMonitor* monitor = nullptr);
+
+ private:
+  Settings settings_;  ///< Location and limits of the cache.
+
+  /**
+   * @brief Returns the snapshot or attachment path of a source file.
+   * @param source Absolute path of the OBJ file.
+   * @param extension ".mesh" for the snapshot, "." and the name for an
+   * attachment.
+   * @return Path inside the cache directory.
+   */
+  std::string EntryPath(const std::string& source,
+                        std::string_view extension) const;
+
+  /**
+   * @brief Removes least recently used entries above the size limit.
+   * @param incoming Size of a file about to be added.
+   *
+   * A snapshot and its attachments count as one entry, used when the most
+   * recent of them was.
+   */
+  void Evict(uint64_t incoming);
+
+  /**
+   * @brief Checks that a source is still the one a stamp was taken of.
+   * @param path Absolute path of the OBJ file.
+   * @param stamp Stamp taken before the source was read.
+   * @return False, after logging, if the source changed or is gone.
+   */
+  static bool Unchanged(const std::string& path, const SourceStamp& stamp);
+};
+
+}  // namespace s21
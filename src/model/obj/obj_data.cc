@@ -1,59 +1,85 @@
 #include "obj_data.h"
 
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
 namespace s21 {
 
+void OBJData::UpdateBounds() {
+  x_min = y_min = z_min = kEmptyMin;
+  x_max = y_max = z_max = kEmptyMax;
+  for (const Vec3f& vertex : vertices) {
+    ExtendBounds(vertex);
+  }
+}
+
 void OBJData::Normalize() {
   LogInfo << "Normalizing loaded mesh..." << std::endl;
-  using namespace ranges;
 
   // Ensure there is at least one vertex to avoid undefined behavior.
   if (vertices.empty()) {
     return;
   }
-
-  // Find min and max for x coordinate.
-  auto [min_x_it, max_x_it] = minmax_element(
-      vertices, [](const Vec3f& a, const Vec3f& b) { return a.x < b.x; });
-  float min_x = min_x_it->x;
-  float max_x = max_x_it->x;
-
-  // Find min and max for y coordinate.
-  auto [min_y_it, max_y_it] = minmax_element(
-      vertices, [](const Vec3f& a, const Vec3f& b) { return a.y < b.y; });
-  float min_y = min_y_it->y;
-  float max_y = max_y_it->y;
-
-  // Find min and max for z coordinate.
-  auto [min_z_it, max_z_it] = minmax_element(
-      vertices, [](const Vec3f& a, const Vec3f& b) { return a.z < b.z; });
-  float min_z = min_z_it->z;
-  float max_z = max_z_it->z;
+  if (x_min > x_max) UpdateBounds();
 
   // Compute midpoints.
-  float mid_x = (max_x + min_x) / 2.0f;
-  float mid_y = (max_y + min_y) / 2.0f;
-  float mid_z = (max_z + min_z) / 2.0f;
+  float mid_x = (x_max + x_min) / 2.0f;
+  float mid_y = (y_max + y_min) / 2.0f;
+  float mid_z = (z_max + z_min) / 2.0f;
 
   // Compute the maximum distance from the midpoint along any axis.
-  float dx = std::max(std::abs(max_x - mid_x), std::abs(min_x - mid_x));
-  float dy = std::max(std::abs(max_y - mid_y), std::abs(min_y - mid_y));
-  float dz = std::max(std::abs(max_z - mid_z), std::abs(min_z - mid_z));
+  float dx = std::max(std::abs(x_max - mid_x), std::abs(x_min - mid_x));
+  float dy = std::max(std::abs(y_max - mid_y), std::abs(y_min - mid_y));
+  float dz = std::max(std::abs(z_max - mid_z), std::abs(z_min - mid_z));
 
   // Scale factor to normalize within a unit cube (multiplied by 2.0 for full
-  // range).
+  // range). A single point is only moved to the origin.
   float scale_factor = std::max({dx, dy, dz}) * 2.0f;
-
-  // Adjust and scale each vertex using ranges::for_each.
-  for_each(vertices, [=](Vec3f& vertex) {
-    vertex.x = (vertex.x - mid_x) / scale_factor;
-    vertex.y = (vertex.y - mid_y) / scale_factor;
-    vertex.z = (vertex.z - mid_z) / scale_factor;
+  if (scale_factor == 0.0f) scale_factor = 1.0f;
+  const float scale = 1.0f / scale_factor;
+
+  // Treat the packed vertices as one float array, rescaled in parallel
+  // ranges of whole vertices.
+  float* p = &vertices.front().x;
+  constexpr size_t kGrain = size_t{1} << 16;
+  ParallelFor(vertices.size(), kGrain, [=](size_t first, size_t last) {
+    size_t i = first * 3;
+    const size_t end = last * 3;
+#ifdef __SSE2__
+    // Four vertices fill three registers, whose lanes cycle through x, y, z.
+    const __m128 mid0 = _mm_setr_ps(mid_x, mid_y, mid_z, mid_x);
+    const __m128 mid1 = _mm_setr_ps(mid_y, mid_z, mid_x, mid_y);
+    const __m128 mid2 = _mm_setr_ps(mid_z, mid_x, mid_y, mid_z);
+    const __m128 factor = _mm_set1_ps(scale);
+    for (; i + 12 <= end; i += 12) {
+      __m128 a = _mm_loadu_ps(p + i);
+      __m128 b = _mm_loadu_ps(p + i + 4);
+      __m128 c = _mm_loadu_ps(p + i + 8);
+      _mm_storeu_ps(p + i, _mm_mul_ps(_mm_sub_ps(a, mid0), factor));
+      _mm_storeu_ps(p + i + 4, _mm_mul_ps(_mm_sub_ps(b, mid1), factor));
+      _mm_storeu_ps(p + i + 8, _mm_mul_ps(_mm_sub_ps(c, mid2), factor));
+    }
+#endif
+    const float mid[3] = {mid_x, mid_y, mid_z};
+    for (; i < end; ++i) {
+      p[i] = (p[i] - mid[i % 3]) * scale;
+    }
   });
 
+  // The box now describes the normalized vertices.
+  x_min = (x_min - mid_x) * scale;
+  x_max = (x_max - mid_x) * scale;
+  y_min = (y_min - mid_y) * scale;
+  y_max = (y_max - mid_y) * scale;
+  z_min = (z_min - mid_z) * scale;
+  z_max = (z_max - mid_z) * scale;
+
   LogInfo << "Normalization complete." << std::endl;
 }
 
-void OBJData::Parse(const std::string& filename) {
+void OBJData::Parse(const std::string& filename, size_t num_threads,
+                    LoadMonitor* monitor) {
   // Memory mapping
   LogInfo << "Opening file: " << filename << std::endl;
 
@@ -71,27 +97,58 @@ void OBJData::Parse(const std::string& filename) {
     throw MeshLoadException("Failed to map file: " + filename);
   }
   close(fd);
+  monitor_ = monitor;
+  if (monitor_) monitor_->SetTotalBytes(size);
 
-  // Batch reserves
-  vertices.reserve(size / 10);
-  normals.reserve(size / 20);
-  texcoords.reserve(size / 20);
-  objects.reserve(10);
+  if (num_threads == 0) {
+    num_threads = ParallelConcurrency();
+  }
 
   // Process buffer
-  const char* current = buffer;
-  const char* end = buffer + size;
-  while (current < end) {
-    const char* line_start = current;
-    while (current < end && *current != '\n' && *current != '\r') ++current;
-    std::string_view line(line_start, current - line_start);
+  try {
+    if (num_threads > 1) {
+      LogInfo << "Parsing with " << num_threads << " threads" << std::endl;
+      ParseParallel(std::string_view(buffer, size), num_threads);
+    } else {
+      // Batch reserves
+      vertices.reserve(size / 10);
+      normals.reserve(size / 20);
+      texcoords.reserve(size / 20);
+      objects.reserve(10);
+      ParseBuffer(std::string_view(buffer, size));
+    }
+  } catch (...) {
+    munmap(buffer, size);
+    monitor_ = nullptr;
+    throw;
+  }
 
-    while (current < end && (*current == '\r' || *current == '\n')) ++current;
+  munmap(buffer, size);
+  monitor_ = nullptr;
+  LogInfo << "Parsing complete." << std::endl;
+  LogInfo << "Vertices: " << vertices.size() << std::endl;
+  LogInfo << "Normals: " << normals.size() << std::endl;
+  LogInfo << "Texcoords: " << texcoords.size() << std::endl;
+  LogInfo << "Objects: " << objects.size() << std::endl;
+}
 
-    ProcessLine(line);
+void OBJData::ParseGzip(const std::string& filename, LoadMonitor* monitor) {
+  LogInfo << "Opening compressed file: " << filename << std::endl;
+  GzipReader reader(filename);
+  monitor_ = monitor;
+  if (monitor_) monitor_->SetTotalBytes(reader.CompressedSize());
+
+  try {
+    reader.ReadLines([this](std::string_view lines, uint64_t compressed) {
+      ScanBuffer(lines);
+      if (monitor_) monitor_->AddParsedBytes(compressed);
+    });
+  } catch (...) {
+    monitor_ = nullptr;
+    throw;
   }
 
-  munmap(buffer, size);
+  monitor_ = nullptr;
   LogInfo << "Parsing complete." << std::endl;
   LogInfo << "Vertices: " << vertices.size() << std::endl;
   LogInfo << "Normals: " << normals.size() << std::endl;
@@ -99,97 +156,310 @@ void OBJData::Parse(const std::string& filename) {
   LogInfo << "Objects: " << objects.size() << std::endl;
 }
 
+void OBJData::ParseBuffer(std::string_view buffer) {
+  if (!monitor_) {
+    ScanBuffer(buffer);
+    return;
+  }
+
+  // Parse in slices ending at line breaks to report progress in between.
+  while (!buffer.empty()) {
+    size_t end = std::min(kProgressSlice, buffer.size());
+    if (end < buffer.size()) {
+      size_t newline = buffer.find('\n', end - 1);
+      end = newline == std::string_view::npos ? buffer.size() : newline + 1;
+    }
+    ScanBuffer(buffer.substr(0, end));
+    monitor_->AddParsedBytes(end);
+    buffer.remove_prefix(end);
+  }
+}
+
+void OBJData::ScanBuffer(std::string_view buffer) {
+  LineScanner::ScanLines(
+      buffer,
+      [this](const std::string_view* tokens, size_t count) {
+        ProcessTokens(TokenCursor(tokens, count));
+      },
+      [this](std::string_view line) { ProcessLine(line); });
+}
+
+void OBJData::ParseParallel(std::string_view buffer, size_t num_threads) {
+  std::vector<std::string_view> chunks = SplitIntoChunks(buffer, num_threads);
+  std::vector<OBJData> parts(chunks.size());
+  std::vector<ElementCounts> counts(chunks.size());
+  std::vector<std::exception_ptr> errors(chunks.size());
+
+  // Runs task(i) for every chunk on the parallel layer and rethrows the error
+  // of the first failed chunk in file order.
+  auto run_on_chunks = [&](auto task) {
+    ParallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        try {
+          task(i);
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      }
+    });
+    for (const auto& error : errors) {
+      if (error) std::rethrow_exception(error);
+    }
+  };
+
+  // Pass 1: count elements so every chunk knows its global index base.
+  run_on_chunks(
+      [&](size_t i) { counts[i] = parts[i].CountElements(chunks[i]); });
+  if (monitor_) monitor_->ThrowIfCancelled();
+
+  ElementCounts base{vertices.size(), texcoords.size(), normals.size()};
+  for (size_t i = 0; i < parts.size(); ++i) {
+    parts[i].deferred_structure_ = true;
+    parts[i].base_ = base;
+    parts[i].monitor_ = monitor_;
+    parts[i].vertices.reserve(counts[i].vertices);
+    parts[i].texcoords.reserve(counts[i].texcoords);
+    parts[i].normals.reserve(counts[i].normals);
+    base.vertices += counts[i].vertices;
+    base.texcoords += counts[i].texcoords;
+    base.normals += counts[i].normals;
+  }
+
+  // Pass 2: parse chunks concurrently.
+  run_on_chunks([&](size_t i) { parts[i].ParseBuffer(chunks[i]); });
+
+  // Merge in file order.
+  size_t face_vertex_count = face_vertices.size();
+  size_t face_count = FaceCount();
+  for (const auto& part : parts) {
+    face_vertex_count += part.face_vertices.size();
+    face_count += part.FaceCount();
+  }
+  vertices.reserve(base.vertices);
+  texcoords.reserve(base.texcoords);
+  normals.reserve(base.normals);
+  face_vertices.reserve(face_vertex_count);
+  face_offsets.reserve(face_count + 1);
+  for (auto& part : parts) {
+    MergeChunk(part);
+  }
+}
+
+std::vector<std::string_view> OBJData::SplitIntoChunks(std::string_view buffer,
+                                                       size_t count) {
+  std::vector<std::string_view> chunks;
+  chunks.reserve(count);
+  const size_t step = std::max<size_t>(1, buffer.size() / count);
+  size_t start = 0;
+  while (start < buffer.size()) {
+    size_t end = start + step;
+    if (chunks.size() + 1 == count || end >= buffer.size()) {
+      end = buffer.size();
+    } else {
+      // Move the border just past the next line break.
+      end = buffer.find_first_of("\r\n", end);
+      end = (end == std::string_view::npos) ? buffer.size() : end + 1;
+    }
+    chunks.push_back(buffer.substr(start, end - start));
+    start = end;
+  }
+  return chunks;
+}
+
+OBJData::ElementCounts OBJData::CountElements(std::string_view buffer) {
+  ElementCounts counts;
+  LineScanner::ScanLines(
+      buffer,
+      [&counts](const std::string_view* tokens, size_t count) {
+        CountElement(TokenCursor(tokens, count), counts);
+      },
+      [&counts](std::string_view line) {
+        CountElement(TokenCursor(line), counts);
+      });
+  return counts;
+}
+
+void OBJData::CountElement(TokenCursor tokens, ElementCounts& counts) {
+  // Same acceptance rules as ParseVertex, ParseNormal and ParseTexCoord.
+  std::string_view keyword = tokens.Next();
+  if (keyword == "v" && tokens.Count() >= 3) {
+    ++counts.vertices;
+  } else if (keyword == "vn" && tokens.Count() >= 3) {
+    ++counts.normals;
+  } else if (keyword == "vt" && tokens.Count() >= 2) {
+    ++counts.texcoords;
+  }
+}
+
+void OBJData::MergeChunk(OBJData& chunk) {
+  x_min = std::min(x_min, chunk.x_min);
+  x_max = std::max(x_max, chunk.x_max);
+  y_min = std::min(y_min, chunk.y_min);
+  y_max = std::max(y_max, chunk.y_max);
+  z_min = std::min(z_min, chunk.z_min);
+  z_max = std::max(z_max, chunk.z_max);
+  vertices.insert(vertices.end(),
+                  std::make_move_iterator(chunk.vertices.begin()),
+                  std::make_move_iterator(chunk.vertices.end()));
+  texcoords.insert(texcoords.end(),
+                   std::make_move_iterator(chunk.texcoords.begin()),
+                   std::make_move_iterator(chunk.texcoords.end()));
+  normals.insert(normals.end(), std::make_move_iterator(chunk.normals.begin()),
+                 std::make_move_iterator(chunk.normals.end()));
+
+  size_t face = 0;
+  for (const auto& event : chunk.events_) {
+    switch (event.kind) {
+      case StructureEvent::Kind::kObject:
+        current_object_ = HandleObject(event.name);
+        break;
+      case StructureEvent::Kind::kUseMtl:
+        current_mesh_ = HandleUseMtl(event.name, current_object_);
+        break;
+      case StructureEvent::Kind::kFaces:
+        // The target mesh cannot change within a run of face lines.
+        if (Mesh* mesh = SelectFaceMesh(current_object_, current_mesh_)) {
+          AppendFaces(chunk, face, event.count);
+          mesh->face_count += event.count;
+        }
+        face += event.count;
+        break;
+    }
+  }
+}
+
+void OBJData::AppendFaces(const OBJData& chunk, size_t first, size_t count) {
+  const uint32_t begin = chunk.face_offsets[first];
+  const uint32_t end = chunk.face_offsets[first + count];
+  if (face_vertices.size() + (end - begin) >
+      std::numeric_limits<uint32_t>::max()) {
+    throw MeshLoadException("Too many face vertices");
+  }
+  const uint32_t shift = static_cast<uint32_t>(face_vertices.size()) - begin;
+  face_vertices.insert(face_vertices.end(), chunk.face_vertices.begin() + begin,
+                       chunk.face_vertices.begin() + end);
+  for (size_t i = first + 1; i <= first + count; ++i) {
+    face_offsets.push_back(chunk.face_offsets[i] + shift);
+  }
+}
+
 void OBJData::ProcessLine(std::string_view line) {
   line = TrimView(line);
   if (line.empty() || line[0] == '#') return;
 
-  auto tokens = Tokenize(line);
-  if (tokens.empty()) return;
+  ProcessTokens(Tokenize(line));
+}
+
+void OBJData::ProcessTokens(TokenCursor tokens) {
+  std::string_view keyword = tokens.Next();
+  if (keyword.empty() || keyword[0] == '#') return;
 
-  const auto& keyword = tokens[0];
   if (keyword == "v") {
     ParseVertex(tokens);
   } else if (keyword == "vn") {
     ParseNormal(tokens);
   } else if (keyword == "vt") {
     ParseTexCoord(tokens);
-  } else if (keyword == "o") {
-    current_object_ = HandleObject(tokens);
-  } else if (keyword == "usemtl") {
-    current_mesh_ = HandleUseMtl(tokens, current_object_);
+  } else if (keyword == "o" || keyword == "usemtl") {
+    bool is_object = keyword == "o";
+    std::string_view name = tokens.Next();
+    if (deferred_structure_) {
+      events_.push_back({is_object ? StructureEvent::Kind::kObject
+                                   : StructureEvent::Kind::kUseMtl,
+                         std::string(name), 0});
+    } else if (is_object) {
+      current_object_ = HandleObject(name);
+    } else {
+      current_mesh_ = HandleUseMtl(name, current_object_);
+    }
   } else if (keyword == "f") {
-    HandleFace(tokens, current_object_, current_mesh_);
+    if (deferred_structure_) {
+      if (events_.empty() ||
+          events_.back().kind != StructureEvent::Kind::kFaces) {
+        events_.push_back({StructureEvent::Kind::kFaces, {}, 0});
+      }
+      ++events_.back().count;
+      ParseFace(tokens);
+    } else if (Mesh* mesh = SelectFaceMesh(current_object_, current_mesh_)) {
+      ParseFace(tokens);
+      ++mesh->face_count;
+    }
   }
 }
 
-void OBJData::ParseVertex(const std::vector<std::string_view>& tokens) {
-  if (tokens.size() < 4) {
+void OBJData::ParseVertex(TokenCursor args) {
+  // Assuming the vertex coordinates are in the format "v x y z".
+  std::string_view x = args.Next(), y = args.Next(), z = args.Next();
+  if (z.empty()) {
     return;
   }
-  // Assuming the vertex coordinates are in the format "v x y z".
-  vertices.emplace_back(ParseFloat(tokens[1]), ParseFloat(tokens[2]),
-                        ParseFloat(tokens[3]));
+  ExtendBounds(
+      vertices.emplace_back(ParseFloat(x), ParseFloat(y), ParseFloat(z)));
 }
 
-void OBJData::ParseNormal(const std::vector<std::string_view>& tokens) {
-  if (tokens.size() < 4) {
+void OBJData::ParseNormal(TokenCursor args) {
+  // Assuming the vertex coordinates are in the format "vn x y z".
+  std::string_view x = args.Next(), y = args.Next(), z = args.Next();
+  if (z.empty()) {
     return;
   }
-  // Assuming the vertex coordinates are in the format "vn x y z".
-  normals.emplace_back(ParseFloat(tokens[1]), ParseFloat(tokens[2]),
-                       ParseFloat(tokens[3]));
+  normals.emplace_back(ParseFloat(x), ParseFloat(y), ParseFloat(z));
 }
 
-void OBJData::ParseTexCoord(const std::vector<std::string_view>& tokens) {
-  if (tokens.size() < 3) {
+void OBJData::ParseTexCoord(TokenCursor args) {
+  // Assuming the texture coordinates are in the format "vt u v".
+  std::string_view u = args.Next(), v = args.Next();
+  if (v.empty()) {
     return;
   }
-  // Assuming the texture coordinates are in the format "vt u v".
-  texcoords.emplace_back(ParseFloat(tokens[1]), ParseFloat(tokens[2]));
+  texcoords.emplace_back(ParseFloat(u), ParseFloat(v));
 }
 
-Object* OBJData::HandleObject(const std::vector<std::string_view>& tokens) {
-  if (tokens.size() < 2) {
+Object* OBJData::HandleObject(std::string_view name) {
+  if (name.empty()) {
     return nullptr;
   }
   objects.emplace_back();
   Object& obj = objects.back();
-  obj.name = tokens[1];
+  obj.name = name;
   return &obj;
 }
 
-Mesh* OBJData::HandleUseMtl(const std::vector<std::string_view>& tokens,
+Mesh* OBJData::HandleUseMtl(std::string_view material,
                             Object* current_object) {
-  if (tokens.size() < 2 || !current_object) {
+  if (material.empty() || !current_object) {
     return nullptr;
   }
-  std::string_view material = tokens[1];
   if (current_object->meshes.empty() ||
       current_object->meshes.back().material != material) {
     current_object->meshes.emplace_back();
     current_object->meshes.back().material = material;
+    current_object->meshes.back().first_face = FaceCount();
   }
   return &current_object->meshes.back();
 }
 
-void OBJData::HandleFace(const std::vector<std::string_view>& tokens,
-                         Object*& current_object, Mesh*& current_mesh) {
+Mesh* OBJData::SelectFaceMesh(Object*& current_object, Mesh*& current_mesh) {
   if (!current_object) {
     objects.emplace_back();
     current_object = &objects.back();
   }
   if (current_object->meshes.empty()) {
     current_object->meshes.emplace_back();
+    current_object->meshes.back().first_face = FaceCount();
     current_mesh = &current_object->meshes.back();
   }
-  if (!current_mesh) {
-    return;
-  }
+  return current_mesh;
+}
+
+void OBJData::ParseFace(TokenCursor args) {
+  // Indices are resolved against the whole file, including earlier chunks.
+  const size_t vertex_count = base_.vertices + vertices.size();
+  const size_t texcoord_count = base_.texcoords + texcoords.size();
+  const size_t normal_count = base_.normals + normals.size();
 
-  Face face;
-  face.vertices.reserve(tokens.size() - 1);
-  for (size_t i = 1; i < tokens.size(); ++i) {
-    std::string_view part = tokens[i];
+  for (std::string_view part = args.Next(); !part.empty();
+       part = args.Next()) {
     size_t delim1 = part.find('/');
     size_t delim2 = part.find('/', delim1 + 1);
 
@@ -198,24 +468,27 @@ void OBJData::HandleFace(const std::vector<std::string_view>& tokens,
 
     // Parse vertex index (v)
     if (delim1 != 0) {  // Check for leading '/' (e.g., "//vn")
-      v = ParseIndex(part.substr(0, delim1), vertices.size());
+      v = ParseIndex(part.substr(0, delim1), vertex_count);
     }
 
     // Parse texture coordinate (vt)
     if (delim1 != std::string_view::npos && delim2 > delim1 + 1) {
       vt = ParseIndex(part.substr(delim1 + 1, delim2 - delim1 - 1),
-                      texcoords.size());
+                      texcoord_count);
     }
 
     // Parse normal (vn)
     if (delim2 != std::string_view::npos) {
-      vn = ParseIndex(part.substr(delim2 + 1), normals.size());
+      vn = ParseIndex(part.substr(delim2 + 1), normal_count);
     }
 
     // Construct VertexIndices in place
-    face.vertices.emplace_back(v, vt, vn);
+    face_vertices.emplace_back(v, vt, vn);
+  }
+  if (face_vertices.size() > std::numeric_limits<uint32_t>::max()) {
+    throw MeshLoadException("Too many face vertices");
   }
-  current_mesh->faces.push_back(face);
+  face_offsets.push_back(static_cast<uint32_t>(face_vertices.size()));
 }
 
 int OBJData::ParseIndex(const std::string_view& part, size_t current_count) {
@@ -225,7 +498,7 @@ int OBJData::ParseIndex(const std::string_view& part, size_t current_count) {
   }
 
   int idx = 0;
-  auto [ptr, ec] = std::from_chars(part.data(), part.data() + part.size(), idx);
+  auto [ptr, ec] = FastFromChars(part.data(), part.data() + part.size(), idx);
   if (ec != std::errc()) {
     return -1;
   }
@@ -243,7 +516,7 @@ int OBJData::ParseIndex(const std::string_view& part, size_t current_count) {
 
 float OBJData::ParseFloat(std::string_view sv) {
   float value;
-  auto result = std::from_chars(sv.data(), sv.data() + sv.size(), value);
+  auto result = FastFromChars(sv.data(), sv.data() + sv.size(), value);
   if (result.ec != std::errc()) throw MeshLoadException("Invalid file format");
   return value;
 }
@@ -259,23 +532,8 @@ std::string_view OBJData::TrimView(std::string_view sv) {
   return sv.substr(start, end - start + 1);
 }
 
-std::vector<std::string_view> OBJData::Tokenize(std::string_view line) {
-  std::vector<std::string_view> tokens;
-  tokens.reserve(6);
-  size_t start = 0, end = 0;
-
-  while ((end = line.find_first_of(" \t", start)) != std::string_view::npos) {
-    if (end != start) {  // Skip empty tokens
-      tokens.emplace_back(line.substr(start, end - start));
-    }
-    start = line.find_first_not_of(" \t", end);
-  }
-
-  if (start != line.size()) {
-    tokens.emplace_back(line.substr(start));
-  }
-
-  return tokens;
+OBJData::TokenCursor OBJData::Tokenize(std::string_view line) {
+  return TokenCursor(line);
 }
 
 std::string OBJData::toString() {
@@ -287,7 +545,7 @@ std::string OBJData::toString() {
     ss << "Object: " << object.name << "\n";
     for (const auto& mesh : object.meshes) {
       ss << "  Group material: " << mesh.material << "\n"
-         << "  Faces count: " << mesh.faces.size() << "\n";
+         << "  Faces count: " << mesh.face_count << "\n";
     }
   }
 
@@ -6,8 +6,12 @@
 
 #include <algorithm>
 #include <charconv>
+#include <cstdint>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -15,7 +19,12 @@
 #include "../data_structures.h"
 #include "../exceptions.h"
 #include "../math/transform_matrix_builder.h"
+#include "../parallel.h"
 #include "Logger.h"
+#include "fast_from_chars.h"
+#include "gzip_reader.h"
+#include "line_scanner.h"
+#include "load_monitor.h"
 #include "range/v3/all.hpp"
 
 /**
@@ -40,21 +49,126 @@ struct VertexIndices {
   int v{-1};   ///< Index of the vertex, -1 if not specified.
   int vt{-1};  ///< Index of the texture coordinate, -1 if not specified.
   int vn{-1};  ///< Index of the normal, -1 if not specified.
-  // add ctor
+  VertexIndices() = default;
   explicit VertexIndices(int v, int vt = -1, int vn = -1)
       : v(v), vt(vt), vn(vn) {}
 };
 
 /**
  * @struct Face
- * @brief Represents a face in a mesh, consisting of multiple vertex indices.
+ * @brief Read-only view of a face, consisting of multiple vertex indices.
  *
  * A face is defined by a collection of VertexIndices, each specifying the
- * vertex, texture coordinate, and normal for that point in the face.
+ * vertex, texture coordinate, and normal for that point in the face. The
+ * indices live in the flat OBJData::face_vertices array; a Face only points
+ * into it and stays valid until that array is modified.
  */
 struct Face {
-  std::vector<VertexIndices>
-      vertices;  ///< List of vertex indices defining the face.
+  /**
+   * @struct Indices
+   * @brief Contiguous read-only range of VertexIndices.
+   */
+  struct Indices {
+    const VertexIndices* data = nullptr;  ///< First index of the face.
+    size_t count = 0;                     ///< Number of indices.
+
+    /// @return Number of vertex references in the face.
+    size_t size() const { return count; }
+    /// @return True if the face has no vertex references.
+    bool empty() const { return count == 0; }
+    /// @return The i-th vertex reference of the face.
+    const VertexIndices& operator[](size_t i) const { return data[i]; }
+    /// @return Pointer to the first vertex reference.
+    const VertexIndices* begin() const { return data; }
+    /// @return Pointer past the last vertex reference.
+    const VertexIndices* end() const { return data + count; }
+  };
+
+  Indices vertices;  ///< List of vertex indices defining the face.
+};
+
+/**
+ * @class FaceRange
+ * @brief Read-only, random-access range of faces stored in CSR form.
+ *
+ * Yields Face views built from the flat index array and the face offset
+ * array of an OBJData, so iterating faces touches contiguous memory only.
+ */
+class FaceRange {
+ public:
+  /**
+   * @class Iterator
+   * @brief Forward iterator producing Face views by value.
+   */
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Face;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Face*;
+    using reference = Face;
+
+    /**
+     * @brief Creates an iterator at the given face.
+     * @param range The range being iterated.
+     * @param index Position of the face within the range.
+     */
+    Iterator(const FaceRange* range, size_t index)
+        : range_(range), index_(index) {}
+
+    /// @return The face at the current position.
+    Face operator*() const { return (*range_)[index_]; }
+    /// @brief Advances to the next face.
+    Iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    /// @brief Advances to the next face, returning the previous position.
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      ++index_;
+      return copy;
+    }
+    /// @return True if both iterators point at the same face.
+    bool operator==(const Iterator& other) const {
+      return index_ == other.index_;
+    }
+    /// @return True if the iterators point at different faces.
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    const FaceRange* range_;  ///< The range being iterated.
+    size_t index_;            ///< Position within the range.
+  };
+
+  /**
+   * @brief Creates a range of faces.
+   * @param indices The flat array of vertex references.
+   * @param offsets Offsets of the faces into indices; face i spans
+   * [offsets[i], offsets[i + 1]).
+   * @param count Number of faces in the range.
+   */
+  FaceRange(const VertexIndices* indices, const uint32_t* offsets,
+            size_t count)
+      : indices_(indices), offsets_(offsets), count_(count) {}
+
+  /// @return Number of faces in the range.
+  size_t size() const { return count_; }
+  /// @return True if the range has no faces.
+  bool empty() const { return count_ == 0; }
+  /// @return A view of the i-th face of the range.
+  Face operator[](size_t i) const {
+    return Face{{indices_ + offsets_[i], offsets_[i + 1] - offsets_[i]}};
+  }
+  /// @return Iterator to the first face.
+  Iterator begin() const { return Iterator(this, 0); }
+  /// @return Iterator past the last face.
+  Iterator end() const { return Iterator(this, count_); }
+
+ private:
+  const VertexIndices* indices_;  ///< Flat array of vertex references.
+  const uint32_t* offsets_;       ///< Offset of the first face in range.
+  size_t count_;                  ///< Number of faces in the range.
 };
 
 /**
@@ -62,11 +176,13 @@ struct Face {
  * @brief Represents a mesh within an object, associated with a material and
  * consisting of multiple faces.
  *
- * A mesh groups faces that share the same material.
+ * A mesh groups faces that share the same material. Its faces are a
+ * contiguous range of the OBJData face arrays, see OBJData::Faces().
  */
 struct Mesh {
-  std::string material;     ///< Name of the material used for this mesh.
-  std::vector<Face> faces;  ///< List of faces that make up the mesh.
+  std::string material;   ///< Name of the material used for this mesh.
+  size_t first_face = 0;  ///< Index of the first face of the mesh.
+  size_t face_count = 0;  ///< Number of faces that make up the mesh.
 };
 
 /**
@@ -96,30 +212,104 @@ struct Object {
  */
 class OBJData {
  public:
+  OBJData() = default;
+  /// Parsed geometry is large, so it is only ever moved.
+  OBJData(const OBJData&) = delete;
+  OBJData& operator=(const OBJData&) = delete;
+  OBJData(OBJData&&) = default;
+  OBJData& operator=(OBJData&&) = default;
+
   std::vector<Vec3f> vertices;   ///< List of 3D vertices.
   std::vector<Vec2f> texcoords;  ///< List of 2D texture coordinates.
   std::vector<Vec3f> normals;    ///< List of 3D normals.
   std::vector<Object> objects;   ///< List of objects parsed from the file.
-  float x_min = 0.0f, x_max = 0.0f, y_min = 0.0f, y_max = 0.0f, z_min = 0.0f,
-        z_max = 0.0f;
-  ///< Bounding box of the vertex data.
+  std::vector<VertexIndices>
+      face_vertices;  ///< Vertex references of all faces, face after face.
+  std::vector<uint32_t> face_offsets{
+      0};  ///< Start of every face in face_vertices, plus the final end.
+  /// Bounding box of the vertex data, kept up to date by Parse(). Empty
+  /// (min above max) while there are no vertices.
+  float x_min = kEmptyMin, x_max = kEmptyMax, y_min = kEmptyMin,
+        y_max = kEmptyMax, z_min = kEmptyMin, z_max = kEmptyMax;
 
   /**
    * @brief Parses an OBJ file and populates the data structures.
    * @param filename The path to the OBJ file to parse.
+   * @param num_threads Number of chunks parsed in parallel; 1 parses
+   * serially, 0 uses as many as the parallel layer has threads.
+   * @param monitor Receives progress and may cancel the parse; optional.
+   * @throws LoadCancelledException if the monitor cancels the parse.
    *
    * This method reads the specified OBJ file, processes its contents, and fills
    * the vertices, texcoords, normals, and objects vectors accordingly. Any
    * parsing errors are collected and can be accessed via the errors_ vector.
+   *
+   * With more than one thread the mapped file is split into chunks at line
+   * boundaries which are parsed concurrently and merged in file order. The
+   * result is identical to the serial parse.
    */
-  void Parse(const std::string& filename);
+  void Parse(const std::string& filename, size_t num_threads = 1,
+             LoadMonitor* monitor = nullptr);
+
+  /**
+   * @brief Parses a gzip-compressed OBJ file without unpacking it to disk.
+   * @param filename The path to the .obj.gz file to parse.
+   * @param monitor Receives progress, counted in compressed bytes, and may
+   * cancel the parse; optional.
+   * @throws MeshLoadException if the file cannot be read or is not valid
+   * gzip.
+   * @throws LoadCancelledException if the monitor cancels the parse.
+   *
+   * The file is inflated by a GzipReader on a second thread while this
+   * thread parses the previous block of lines. The result is identical to
+   * Parse() of the uncompressed file.
+   */
+  void ParseGzip(const std::string& filename, LoadMonitor* monitor = nullptr);
+
+  /**
+   * @brief Returns the number of faces stored.
+   * @return Number of faces of all objects and meshes.
+   */
+  size_t FaceCount() const { return face_offsets.size() - 1; }
+
+  /**
+   * @brief Returns all faces in file order.
+   * @return A read-only range over every face of every mesh.
+   *
+   * Meshes own consecutive face ranges, so this equals iterating objects,
+   * their meshes and the meshes' faces in order.
+   */
+  FaceRange Faces() const {
+    return FaceRange(face_vertices.data(), face_offsets.data(), FaceCount());
+  }
+
+  /**
+   * @brief Returns the faces of a mesh.
+   * @param mesh A mesh of one of the objects.
+   * @return A read-only range over the faces of the mesh.
+   */
+  FaceRange Faces(const Mesh& mesh) const {
+    return FaceRange(face_vertices.data(),
+                     face_offsets.data() + mesh.first_face, mesh.face_count);
+  }
+
+  /**
+   * @brief Recomputes the bounding box from the vertices in one pass.
+   *
+   * Parse() maintains the bounding box itself; this is only needed after
+   * the vertices have been changed directly.
+   */
+  void UpdateBounds();
 
   /**
    * @brief Normalizes the vertex data to fit within a unit cube.
    *
    * This method adjusts the vertex coordinates so that the entire model fits
    * within a cube ranging from (-1, -1, -1) to (1, 1, 1), based on the bounding
-   * box defined by x_min, x_max, y_min, y_max, z_min, and z_max.
+   * box defined by x_min, x_max, y_min, y_max, z_min, and z_max. The box
+   * gathered while parsing is used, so the vertices are swept only once; it is
+   * computed first if it is empty. Afterwards the box describes the
+   * normalized vertices.
    */
   void Normalize();
 
@@ -133,6 +323,108 @@ class OBJData {
   std::string toString();
 
  private:
+  static constexpr float kEmptyMin =
+      std::numeric_limits<float>::infinity();  ///< x_min of an empty box.
+  static constexpr float kEmptyMax =
+      -std::numeric_limits<float>::infinity();  ///< x_max of an empty box.
+
+  /**
+   * @brief Grows the bounding box to contain a point.
+   * @param point The point to include.
+   */
+  void ExtendBounds(const Vec3f& point) {
+    x_min = std::min(x_min, point.x);
+    x_max = std::max(x_max, point.x);
+    y_min = std::min(y_min, point.y);
+    y_max = std::max(y_max, point.y);
+    z_min = std::min(z_min, point.z);
+    z_max = std::max(z_max, point.z);
+  }
+
+  /**
+   * @class TokenCursor
+   * @brief Iterates over the whitespace-separated tokens of a line.
+   *
+   * Replaces a vector of tokens on the parsing hot path: tokens are produced
+   * on demand as views into the line, so no memory is allocated. A cursor
+   * can also walk tokens already split by LineScanner.
+   */
+  class TokenCursor {
+   public:
+    /**
+     * @brief Creates a cursor positioned before the first token.
+     * @param line The line to iterate over.
+     */
+    explicit TokenCursor(std::string_view line) : rest_(line) {}
+
+    /**
+     * @brief Creates a cursor over tokens that are already split.
+     * @param tokens The tokens of the line.
+     * @param count Number of tokens.
+     */
+    TokenCursor(const std::string_view* tokens, size_t count)
+        : tokens_(tokens), tokens_end_(tokens + count) {}
+
+    /**
+     * @brief Returns the next token and advances past it.
+     * @return The token, or an empty view when the line is exhausted.
+     */
+    std::string_view Next() {
+      if (tokens_) {
+        return tokens_ != tokens_end_ ? *tokens_++ : std::string_view();
+      }
+      size_t start = rest_.find_first_not_of(" \t");
+      if (start == std::string_view::npos) {
+        rest_ = {};
+        return {};
+      }
+      size_t end = std::min(rest_.find_first_of(" \t", start), rest_.size());
+      std::string_view token = rest_.substr(start, end - start);
+      rest_.remove_prefix(end);
+      return token;
+    }
+
+    /**
+     * @brief Counts the remaining tokens without advancing.
+     * @return Number of tokens left on the line.
+     */
+    size_t Count() const {
+      if (tokens_) return tokens_end_ - tokens_;
+      TokenCursor copy = *this;
+      size_t count = 0;
+      while (!copy.Next().empty()) ++count;
+      return count;
+    }
+
+   private:
+    std::string_view rest_;  ///< Part of the line not yet consumed.
+    const std::string_view* tokens_ = nullptr;      ///< Next pre-split token.
+    const std::string_view* tokens_end_ = nullptr;  ///< End of the tokens.
+  };
+
+  /**
+   * @struct ElementCounts
+   * @brief Number of vertices, texture coordinates and normals in a chunk.
+   */
+  struct ElementCounts {
+    size_t vertices = 0;   ///< Number of accepted 'v' lines.
+    size_t texcoords = 0;  ///< Number of accepted 'vt' lines.
+    size_t normals = 0;    ///< Number of accepted 'vn' lines.
+  };
+
+  /**
+   * @struct StructureEvent
+   * @brief An 'o', 'usemtl' or run of 'f' lines recorded by a chunk parser.
+   *
+   * Chunks cannot know which object and mesh are current at their first line,
+   * so they record structure changes in order and the merge step replays them.
+   */
+  struct StructureEvent {
+    enum class Kind { kObject, kUseMtl, kFaces } kind;  ///< Event type.
+    std::string name;  ///< Object or material name, empty if missing.
+    size_t count = 0;  ///< Number of faces for kFaces events.
+  };
+
   Object* current_object_ =
       nullptr;  ///< Pointer to the current object being processed.
   Mesh* current_mesh_ =
@@ -140,6 +432,80 @@ class OBJData {
   std::vector<std::string>
       errors_;  ///< List of errors encountered during parsing.
 
+  bool deferred_structure_ =
+      false;  ///< Record structure events instead of building objects.
+  std::vector<StructureEvent>
+      events_;  ///< Structure events recorded in deferred mode.
+  ElementCounts base_;  ///< Elements preceding this chunk in the file.
+  LoadMonitor* monitor_ =
+      nullptr;  ///< Progress and cancellation of the running parse.
+
+  /// Bytes parsed between two progress reports.
+  static constexpr size_t kProgressSlice = size_t{4} << 20;
+
+  /**
+   * @brief Parses every line of a buffer in order.
+   * @param buffer The text to parse.
+   *
+   * With a monitor, reports progress every kProgressSlice bytes.
+   */
+  void ParseBuffer(std::string_view buffer);
+
+  /**
+   * @brief Feeds every line of a buffer to the line handlers.
+   * @param buffer The text to parse.
+   */
+  void ScanBuffer(std::string_view buffer);
+
+  /**
+   * @brief Parses a buffer on several threads and merges the results.
+   * @param buffer The text to parse.
+   * @param num_threads Number of chunks to parse concurrently.
+   */
+  void ParseParallel(std::string_view buffer, size_t num_threads);
+
+  /**
+   * @brief Splits a buffer into up to count chunks ending at line breaks.
+   * @param buffer The text to split.
+   * @param count Desired number of chunks.
+   * @return Chunks covering the whole buffer in order.
+   */
+  static std::vector<std::string_view> SplitIntoChunks(std::string_view buffer,
+                                                       size_t count);
+
+  /**
+   * @brief Counts the elements a buffer will add without parsing numbers.
+   * @param buffer The text to scan.
+   * @return Number of vertices, texture coordinates and normals.
+   *
+   * Used to resolve relative face indices in chunks before parsing them.
+   */
+  ElementCounts CountElements(std::string_view buffer);
+
+  /**
+   * @brief Adds the element a tokenized line will produce to counts.
+   * @param tokens The tokens of the line.
+   * @param counts The counts to update.
+   */
+  static void CountElement(TokenCursor tokens, ElementCounts& counts);
+
+  /**
+   * @brief Appends consecutive faces of a parsed chunk.
+   * @param chunk A chunk parsed in deferred mode.
+   * @param first Index of the first face within the chunk.
+   * @param count Number of faces to append.
+   */
+  void AppendFaces(const OBJData& chunk, size_t first, size_t count);
+
+  /**
+   * @brief Appends a parsed chunk and replays its structure events.
+   * @param chunk A chunk parsed in deferred mode.
+   *
+   * The chunk's bounding box is merged into this one, so the vertices do not
+   * have to be scanned again.
+   */
+  void MergeChunk(OBJData& chunk);
+
   /**
    * @brief Processes a single line from the OBJ file.
    * @param line The line to process.
@@ -149,51 +515,63 @@ class OBJData {
    */
   void ProcessLine(std::string_view line);
 
+  /**
+   * @brief Processes the tokens of a single line.
+   * @param tokens The tokens of the line, starting with its keyword.
+   */
+  void ProcessTokens(TokenCursor tokens);
+
   /**
    * @brief Parses a vertex line and adds the vertex to the vertices vector.
-   * @param tokens The tokenized parts of the line.
+   * @param args The tokens following the keyword.
    */
-  void ParseVertex(const std::vector<std::string_view>& tokens);
+  void ParseVertex(TokenCursor args);
 
   /**
    * @brief Parses a normal line and adds the normal to the normals vector.
-   * @param tokens The tokenized parts of the line.
+   * @param args The tokens following the keyword.
    */
-  void ParseNormal(const std::vector<std::string_view>& tokens);
+  void ParseNormal(TokenCursor args);
 
   /**
    * @brief Parses a texture coordinate line and adds it to the texcoords
    * vector.
-   * @param tokens The tokenized parts of the line.
+   * @param args The tokens following the keyword.
    */
-  void ParseTexCoord(const std::vector<std::string_view>& tokens);
+  void ParseTexCoord(TokenCursor args);
 
   /**
    * @brief Handles the creation or selection of an object based on the 'o'
    * command.
-   * @param tokens The tokenized parts of the line.
+   * @param name The object name, empty if the line has none.
    * @return A pointer to the current object.
    */
-  Object* HandleObject(const std::vector<std::string_view>& tokens);
+  Object* HandleObject(std::string_view name);
 
   /**
    * @brief Handles the 'usemtl' command to associate a material with the
    * current mesh.
-   * @param tokens The tokenized parts of the line.
+   * @param material The material name, empty if the line has none.
    * @param current_object Pointer to the current object.
    * @return A pointer to the current mesh.
    */
-  Mesh* HandleUseMtl(const std::vector<std::string_view>& tokens,
-                     Object* current_object);
+  Mesh* HandleUseMtl(std::string_view material, Object* current_object);
 
   /**
-   * @brief Parses a face line and adds the face to the current mesh.
-   * @param tokens The tokenized parts of the line.
+   * @brief Selects the mesh a face line is added to, creating the object and
+   * mesh if needed.
    * @param current_object Reference to the pointer of the current object.
    * @param current_mesh Reference to the pointer of the current mesh.
+   * @return The target mesh, or nullptr if the face must be dropped.
+   */
+  Mesh* SelectFaceMesh(Object*& current_object, Mesh*& current_mesh);
+
+  /**
+   * @brief Parses the vertex references of a face line and appends the face
+   * to face_vertices and face_offsets.
+   * @param args The tokens following the keyword.
    */
-  void HandleFace(const std::vector<std::string_view>& tokens,
-                  Object*& current_object, Mesh*& current_mesh);
+  void ParseFace(TokenCursor args);
 
   /**
    * @brief Parses an index from a string view, handling negative indices.
@@ -222,8 +600,8 @@ class OBJData {
    * @brief Tokenizes a line into words, ignoring comments and trimming
    * whitespace.
    * @param line The line to tokenize.
-   * @return A vector of string views representing the tokens.
+   * @return A cursor yielding the tokens as string views.
    */
-  std::vector<std::string_view> Tokenize(std::string_view line);
+  TokenCursor Tokenize(std::string_view line);
 };
 }  // namespace s21
\ No newline at end of file
@@ -1,12 +1,123 @@
 #include <gtest/gtest.h>
+#include <zlib.h>
 
+#include <atomic>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <new>
+#include <random>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "exceptions.h"
+#include "fast_from_chars.h"
+#include "gzip_reader.h"
+#include "line_scanner.h"
+#include "mesh_cache.h"
 #include "obj_data.h"
 
+// Counts every heap allocation made by the test binary. All forms of the
+// global operators are replaced, so every new is paired with its delete.
+static std::atomic<size_t> allocation_count{0};
+
+namespace {
+
+void* CountedAlloc(size_t size) {
+  ++allocation_count;
+  return std::malloc(size ? size : 1);
+}
+
+void* CountedAlignedAlloc(size_t size, std::align_val_t align) {
+  ++allocation_count;
+  const size_t alignment = static_cast<size_t>(align);
+  // aligned_alloc wants a size that is a multiple of the alignment
+  return std::aligned_alloc(alignment,
+                            (size + alignment - 1) / alignment * alignment);
+}
+
+// Kept out of line: once the operators are inlined, GCC pairs this free()
+// with the operator new at the call site and warns about a mismatch
+[[gnu::noinline]] void CountedFree(void* ptr) noexcept { std::free(ptr); }
+
+}  // namespace
+
+void* operator new(size_t size) {
+  if (void* ptr = CountedAlloc(size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return CountedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return CountedAlloc(size);
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+  if (void* ptr = CountedAlignedAlloc(size, align)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+  return operator new(size, align);
+}
+
+void* operator new(size_t size, std::align_val_t align,
+                   const std::nothrow_t&) noexcept {
+  return CountedAlignedAlloc(size, align);
+}
+
+void* operator new[](size_t size, std::align_val_t align,
+                     const std::nothrow_t&) noexcept {
+  return CountedAlignedAlloc(size, align);
+}
+
+void operator delete(void* ptr) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr) noexcept { CountedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { CountedFree(ptr); }
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+  CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+  CountedFree(ptr);
+}
+
 // Helper function to create a temporary OBJ file with given content
 std::string CreateTempObjFile(const std::string& content) {
   std::string filename = "temp_test.obj";
@@ -51,8 +162,8 @@ TEST(OBJDataParserTest, ParseValidOBJFile) {
   // Ensure that the object has at least one mesh with one face.
   ASSERT_FALSE(objData.objects[0].meshes.empty());
   const s21::Mesh& mesh = objData.objects[0].meshes[0];
-  ASSERT_FALSE(mesh.faces.empty());
-  const s21::Face& face = mesh.faces[0];
+  ASSERT_FALSE(objData.Faces(mesh).empty());
+  const s21::Face& face = objData.Faces(mesh)[0];
   EXPECT_EQ(face.vertices.size(), 3);
 
   // Check that the vertex indices have been converted to zero-based indices.
@@ -110,6 +221,738 @@ TEST(OBJDataParserTest, ParseNonexistentFile) {
   EXPECT_THROW(objData.Parse("nonexistent.obj"), s21::MeshLoadException);
 }
 
+// OBJ content exercising state that crosses chunk borders: relative indices,
+// objects and materials spanning chunks, CRLF line ends and dropped lines.
+const char* chunked_obj_content =
+    "v 1.5 -2.25 3\r\n"
+    "v 0.1 0.2 0.3\n"
+    "f 1 2 -1\n"
+    "o First\n"
+    "usemtl red\n"
+    "vt 0.5 0.5\n"
+    "vn 0 0 1\n"
+    "v 4 5 6\n"
+    "f 1/1/1 -2/-1/-1 -1//1\n"
+    "usemtl red\n"
+    "f -3 -2 -1\n"
+    "\n\n   # comment\n"
+    "usemtl\n"
+    "f 1 2 3\n"
+    "usemtl blue\n"
+    "v 7 8 9\n"
+    "f 4/ 3 99 0 -99 abc\n"
+    "o\n"
+    "usemtl green\n"
+    "f 1 2 4\n"
+    "o Second\n"
+    "v 1e3 -1e-3 .5\n"
+    "f -1 -2 -3 -4\n"
+    "v 1 2\n"
+    "f -1 -2 -3\n";
+
+// Asserts that two parse results are identical down to the float bits.
+void ExpectSameData(const s21::OBJData& a, const s21::OBJData& b) {
+  ASSERT_EQ(a.vertices.size(), b.vertices.size());
+  ASSERT_EQ(a.texcoords.size(), b.texcoords.size());
+  ASSERT_EQ(a.normals.size(), b.normals.size());
+  for (size_t i = 0; i < a.vertices.size(); ++i) {
+    EXPECT_EQ(std::memcmp(&a.vertices[i], &b.vertices[i], sizeof(s21::Vec3f)),
+              0);
+  }
+  for (size_t i = 0; i < a.texcoords.size(); ++i) {
+    EXPECT_EQ(
+        std::memcmp(&a.texcoords[i], &b.texcoords[i], sizeof(s21::Vec2f)), 0);
+  }
+  for (size_t i = 0; i < a.normals.size(); ++i) {
+    EXPECT_EQ(std::memcmp(&a.normals[i], &b.normals[i], sizeof(s21::Vec3f)),
+              0);
+  }
+
+  EXPECT_EQ(a.face_offsets, b.face_offsets);
+  EXPECT_EQ(a.x_min, b.x_min);
+  EXPECT_EQ(a.x_max, b.x_max);
+  EXPECT_EQ(a.y_min, b.y_min);
+  EXPECT_EQ(a.y_max, b.y_max);
+  EXPECT_EQ(a.z_min, b.z_min);
+  EXPECT_EQ(a.z_max, b.z_max);
+  ASSERT_EQ(a.objects.size(), b.objects.size());
+  for (size_t o = 0; o < a.objects.size(); ++o) {
+    EXPECT_EQ(a.objects[o].name, b.objects[o].name);
+    ASSERT_EQ(a.objects[o].meshes.size(), b.objects[o].meshes.size());
+    for (size_t m = 0; m < a.objects[o].meshes.size(); ++m) {
+      const s21::Mesh& mesh_a = a.objects[o].meshes[m];
+      const s21::Mesh& mesh_b = b.objects[o].meshes[m];
+      EXPECT_EQ(mesh_a.material, mesh_b.material);
+      EXPECT_EQ(mesh_a.first_face, mesh_b.first_face);
+      ASSERT_EQ(mesh_a.face_count, mesh_b.face_count);
+      for (size_t f = 0; f < mesh_a.face_count; ++f) {
+        const auto va = a.Faces(mesh_a)[f].vertices;
+        const auto vb = b.Faces(mesh_b)[f].vertices;
+        ASSERT_EQ(va.size(), vb.size());
+        for (size_t k = 0; k < va.size(); ++k) {
+          EXPECT_EQ(va[k].v, vb[k].v);
+          EXPECT_EQ(va[k].vt, vb[k].vt);
+          EXPECT_EQ(va[k].vn, vb[k].vn);
+        }
+      }
+    }
+  }
+}
+
+// Test: Parallel parsing gives the same result as serial parsing for any
+// number of chunks, including more chunks than lines.
+TEST(OBJDataParserTest, ParallelParseMatchesSerial) {
+  std::string filename = CreateTempObjFile(chunked_obj_content);
+  s21::OBJData serial;
+  serial.Parse(filename);
+
+  for (size_t threads : {2, 3, 4, 7, 16, 64}) {
+    SCOPED_TRACE(threads);
+    s21::OBJData parallel;
+    parallel.Parse(filename, threads);
+    ExpectSameData(serial, parallel);
+  }
+  std::remove(filename.c_str());
+
+  // Sanity check of cross-border resolution in the serial result.
+  ASSERT_EQ(serial.objects.size(), 4);
+  EXPECT_EQ(serial.objects[1].name, "First");
+  ASSERT_EQ(serial.objects[1].meshes.size(), 2);
+  const s21::Mesh& red = serial.objects[1].meshes[0];
+  EXPECT_EQ(red.face_count, 2);
+  EXPECT_EQ(serial.Faces(red)[1].vertices[0].v, 0);
+}
+
+// Test: The bounding box gathered while parsing matches the vertices, and
+// normalization rescales every vertex, including the ones past the last full
+// SIMD block, into the unit cube.
+TEST(OBJDataParserTest, BoundsTrackedWhileParsing) {
+  std::string filename = CreateTempObjFile(chunked_obj_content);
+  s21::OBJData data;
+  data.Parse(filename, 3);
+  std::remove(filename.c_str());
+
+  ASSERT_EQ(data.vertices.size(), 5);
+  EXPECT_FLOAT_EQ(data.x_min, 0.1f);
+  EXPECT_FLOAT_EQ(data.x_max, 1000.0f);
+  EXPECT_FLOAT_EQ(data.y_min, -2.25f);
+  EXPECT_FLOAT_EQ(data.y_max, 8.0f);
+  EXPECT_FLOAT_EQ(data.z_min, 0.3f);
+  EXPECT_FLOAT_EQ(data.z_max, 9.0f);
+
+  std::vector<s21::Vec3f> expected = data.vertices;
+  const float mid_x = (data.x_min + data.x_max) / 2;
+  const float mid_y = (data.y_min + data.y_max) / 2;
+  const float mid_z = (data.z_min + data.z_max) / 2;
+  const float scale = data.x_max - data.x_min;
+  for (auto& vertex : expected) {
+    vertex = {(vertex.x - mid_x) / scale, (vertex.y - mid_y) / scale,
+              (vertex.z - mid_z) / scale};
+  }
+
+  data.Normalize();
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(data.vertices[i].x, expected[i].x, 1e-6);
+    EXPECT_NEAR(data.vertices[i].y, expected[i].y, 1e-6);
+    EXPECT_NEAR(data.vertices[i].z, expected[i].z, 1e-6);
+  }
+  EXPECT_FLOAT_EQ(data.x_min, -0.5f);
+  EXPECT_FLOAT_EQ(data.x_max, 0.5f);
+}
+
+// Test: An invalid number fails the parallel parse like the serial one.
+TEST(OBJDataParserTest, ParallelParseInvalidFloat) {
+  std::string filename =
+      CreateTempObjFile("v 1 2 3\nv 4 5 6\nv 1 x 3\nv 7 8 9\n");
+  s21::OBJData objData;
+  EXPECT_THROW(objData.Parse(filename, 4), s21::MeshLoadException);
+  std::remove(filename.c_str());
+}
+
+// Returns the heap allocations made by a serial parse of the given content.
+size_t CountParseAllocations(const std::string& content) {
+  std::string filename = CreateTempObjFile(content);
+  size_t before = allocation_count;
+  {
+    s21::OBJData objData;
+    objData.Parse(filename);
+  }
+  size_t allocations = allocation_count - before;
+  std::remove(filename.c_str());
+  return allocations;
+}
+
+// Returns the extra allocations caused by adding lines_count copies of line.
+// Amortized container growth contributes a few allocations in total, so
+// anything proportional to the number of lines shows up immediately.
+size_t CountAllocationsPerLines(const std::string& header,
+                                const std::string& line, size_t lines_count) {
+  std::string small = header, large = header;
+  for (size_t i = 0; i < lines_count; ++i) small += line;
+  for (size_t i = 0; i < 2 * lines_count; ++i) large += line;
+  return CountParseAllocations(large) - CountParseAllocations(small);
+}
+
+// Test: Vertex, normal, texcoord and comment lines do not allocate.
+TEST(OBJDataAllocationTest, ElementLinesDoNotAllocate) {
+  const size_t lines = 10000;
+  EXPECT_LE(CountAllocationsPerLines("", "v 1.5 -2.5 3.25\n", lines), 8);
+  EXPECT_LE(CountAllocationsPerLines("", "vn 0 0 1\n", lines), 8);
+  EXPECT_LE(CountAllocationsPerLines("", "vt 0.5 0.25\n", lines), 8);
+  EXPECT_LE(CountAllocationsPerLines("", "  # comment line\n", lines), 8);
+}
+
+// Test: Face lines append to the flat face arrays without allocating.
+TEST(OBJDataAllocationTest, FaceLinesDoNotAllocate) {
+  const size_t lines = 10000;
+  const std::string header = "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\n";
+  EXPECT_LE(CountAllocationsPerLines(header, "f 1 2 3 4\n", lines), 8);
+  EXPECT_LE(CountAllocationsPerLines(header, "f -1/-1/-1 -2//-2 -3/4\n", lines),
+            8);
+}
+
+// Test: Faces of consecutive meshes are stored back to back.
+TEST(OBJDataParserTest, FacesAreStoredContiguously) {
+  std::string filename = CreateTempObjFile(
+      "v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+      "o A\nusemtl m1\nf 1 2 3\nf 1 2\nusemtl m2\nf 3 2 1\n"
+      "o B\nf 1 2 3 1\n");
+  s21::OBJData objData;
+  objData.Parse(filename);
+  std::remove(filename.c_str());
+
+  ASSERT_EQ(objData.FaceCount(), 4);
+  EXPECT_EQ(objData.face_vertices.size(), 12);
+  EXPECT_EQ(objData.face_offsets,
+            (std::vector<uint32_t>{0, 3, 5, 8, 12}));
+
+  const s21::Mesh& m2 = objData.objects[0].meshes[1];
+  EXPECT_EQ(m2.first_face, 2);
+  ASSERT_EQ(m2.face_count, 1);
+  EXPECT_EQ(objData.Faces(m2)[0].vertices[0].v, 2);
+
+  const s21::Mesh& b = objData.objects[1].meshes[0];
+  EXPECT_EQ(b.first_face, 3);
+  EXPECT_EQ(objData.Faces(b)[0].vertices.size(), 4);
+
+  size_t total = 0;
+  for (const s21::Face& face : objData.Faces()) total += face.vertices.size();
+  EXPECT_EQ(total, objData.face_vertices.size());
+}
+
+// Asserts that FastFromChars and std::from_chars agree on a string,
+// including the consumed length, the error code and the exact float bits.
+template <typename T>
+void ExpectSameAsFromChars(const std::string& text) {
+  SCOPED_TRACE(text);
+  const char* first = text.data();
+  const char* last = text.data() + text.size();
+  T expected{}, actual{};
+  std::memset(&expected, 0x5a, sizeof(T));
+  std::memset(&actual, 0x5a, sizeof(T));
+  auto std_result = std::from_chars(first, last, expected);
+  auto fast_result = s21::FastFromChars(first, last, actual);
+  ASSERT_EQ(fast_result.ec, std_result.ec);
+  ASSERT_EQ(fast_result.ptr, std_result.ptr);
+  ASSERT_EQ(std::memcmp(&actual, &expected, sizeof(T)), 0);
+}
+
+// Test: Hand-picked edge cases of both the fast path and the fallback.
+TEST(FastFromCharsTest, EdgeCases) {
+  for (const char* text :
+       {"", "-", ".", "-.", "0", "-0", "-0.0", "0.5", ".5", "-.5", "5.",
+        "1.5e3", "1.5E-3", "1e", "1.2.3", "16777216", "16777217", "16777216.5",
+        "0.1234567890", "0.12345678901", "123456789012345678901234567890",
+        "0.000000000000000000001", "3.4028236e38", "1e-50", "inf",
+        "-Infinity", "nan", "NaN(123)", "+1", "1/2", "12abc", " 1", "0x10",
+        "1,5"}) {
+    ExpectSameAsFromChars<float>(text);
+    ExpectSameAsFromChars<int>(text);
+  }
+  for (const char* text : {"2147483647", "-2147483648", "2147483648",
+                           "-2147483649", "999999999", "1000000000",
+                           "-000000000001", "0000000000000000007"}) {
+    ExpectSameAsFromChars<int>(text);
+  }
+  // Odd integers above 2^24 are exactly halfway between two floats.
+  for (int i = 0; i < 1000; ++i) {
+    ExpectSameAsFromChars<float>(std::to_string(16777217 + 2 * i) + ".0");
+  }
+}
+
+// Test: Random scanner-style decimals and random float bit patterns.
+TEST(FastFromCharsTest, FuzzDecimals) {
+  std::mt19937 rng(20240601);
+  std::uniform_int_distribution<int> int_digits(0, 9);
+  std::uniform_int_distribution<int> frac_digits(0, 12);
+  std::uniform_int_distribution<uint32_t> bits;
+  char buffer[64];
+  for (int i = 0; i < 200000; ++i) {
+    std::string text = (rng() & 1) ? "-" : "";
+    int n = int_digits(rng), m = frac_digits(rng);
+    for (int k = 0; k < n; ++k) text += static_cast<char>('0' + rng() % 10);
+    if (m > 0 || rng() % 4 == 0) text += '.';
+    for (int k = 0; k < m; ++k) text += static_cast<char>('0' + rng() % 10);
+    ExpectSameAsFromChars<float>(text);
+    ExpectSameAsFromChars<int>(text);
+
+    uint32_t raw = bits(rng);
+    float value;
+    std::memcpy(&value, &raw, sizeof(value));
+    std::snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(rng() % 8),
+                  value);
+    ExpectSameAsFromChars<float>(buffer);
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    ExpectSameAsFromChars<float>(buffer);
+  }
+}
+
+// Test: Random strings over the characters that matter to the grammar.
+TEST(FastFromCharsTest, FuzzRandomStrings) {
+  const std::string alphabet = "0123456789.-+eEinfaINF x/";
+  std::mt19937 rng(7);
+  for (int i = 0; i < 200000; ++i) {
+    std::string text(rng() % 16, ' ');
+    for (char& c : text) c = alphabet[rng() % alphabet.size()];
+    ExpectSameAsFromChars<float>(text);
+    ExpectSameAsFromChars<int>(text);
+  }
+}
+
+// Splits a buffer into the non-blank lines' tokens one character at a time.
+std::vector<std::vector<std::string>> ReferenceSplit(std::string_view text) {
+  std::vector<std::vector<std::string>> lines(1);
+  std::string token;
+  for (char c : text) {
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+      if (!token.empty()) lines.back().push_back(token);
+      token.clear();
+      if ((c == '\n' || c == '\r') && !lines.back().empty()) {
+        lines.emplace_back();
+      }
+    } else {
+      token += c;
+    }
+  }
+  if (!token.empty()) lines.back().push_back(token);
+  if (lines.back().empty()) lines.pop_back();
+  return lines;
+}
+
+// Splits a buffer with LineScanner, tokenizing long lines by reference.
+std::vector<std::vector<std::string>> ScannerSplit(std::string_view text) {
+  std::vector<std::vector<std::string>> lines;
+  s21::LineScanner::ScanLines(
+      text,
+      [&](const std::string_view* tokens, size_t count) {
+        lines.emplace_back(tokens, tokens + count);
+      },
+      [&](std::string_view line) {
+        for (auto& tokens : ReferenceSplit(line)) lines.push_back(tokens);
+      });
+  return lines;
+}
+
+// Test: Scanner splits random buffers like a byte-by-byte loop.
+TEST(LineScannerTest, MatchesReferenceSplit) {
+  const std::string alphabet = "ab1.-/#  \t\t\r\n\n";
+  std::mt19937 rng(5);
+  for (int i = 0; i < 20000; ++i) {
+    std::string text(rng() % 300, ' ');
+    // Mostly short lines, sometimes lines longer than a window.
+    const size_t break_chance = rng() % 2 ? 8 : 200;
+    for (char& c : text) {
+      c = rng() % break_chance == 0 ? '\n' : alphabet[rng() % alphabet.size()];
+    }
+    ASSERT_EQ(ScannerSplit(text), ReferenceSplit(text)) << text;
+  }
+}
+
+// Test: Long lines, tabs, CRLF and a missing final newline parse correctly.
+TEST(OBJDataParserTest, ParsesLongLinesAndMixedSeparators) {
+  std::string content =
+      "v 0 0 0\r\nv\t1 0 0\r\n  v 1 1 0 \r\nv 0 1 0\r\n"
+      "f 1/1/1    2/2/2    3/3/3    4/4/4    1/1/1    2/2/2    3/3/3    "
+      "4/4/4\r\n# trailing comment with many words that is longer than 64\n"
+      "\tf 1 2 3";
+  std::string filename = CreateTempObjFile(content);
+  s21::OBJData data;
+  data.Parse(filename);
+  std::remove(filename.c_str());
+
+  EXPECT_EQ(data.vertices.size(), 4u);
+  EXPECT_FLOAT_EQ(data.vertices[2].y, 1.0f);
+  ASSERT_EQ(data.FaceCount(), 2u);
+  EXPECT_EQ(data.face_offsets[1], 8u);
+  EXPECT_EQ(data.face_offsets[2], 11u);
+}
+
+// Cache in a fresh directory with two small source files.
+class MeshCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::filesystem::remove_all(directory_);
+    settings_.directory = directory_;
+    settings_.min_source_size = 0;
+    WriteSource(first_, chunked_obj_content);
+    WriteSource(second_, sample_obj_content);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove_all(directory_);
+    std::remove(first_.c_str());
+    std::remove(second_.c_str());
+  }
+
+  static void WriteSource(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+  }
+
+  // Parses and normalizes a source and stores it in the cache.
+  s21::OBJData ParseAndStore(s21::MeshCache& cache, const std::string& path) {
+    s21::OBJData data;
+    data.Parse(path);
+    data.Normalize();
+    cache.Store(path, Stamp(path), data);
+    return data;
+  }
+
+  // Returns the current stamp of a source.
+  static s21::MeshCache::SourceStamp Stamp(const std::string& path) {
+    s21::MeshCache::SourceStamp stamp;
+    EXPECT_TRUE(s21::MeshCache::Stamp(path, stamp));
+    return stamp;
+  }
+
+  // Returns the only cache entry.
+  std::string EntryPath() const {
+    std::vector<std::string> entries;
+    for (const auto& file :
+         std::filesystem::directory_iterator(directory_)) {
+      entries.push_back(file.path().string());
+    }
+    EXPECT_EQ(entries.size(), 1u);
+    return entries.empty() ? std::string() : entries.front();
+  }
+
+  // Overwrites one byte of a file.
+  static void PatchByte(const std::string& path, std::streamoff offset,
+                        char value) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.put(value);
+  }
+
+  const std::string directory_ = "mesh_cache_test";
+  const std::string first_ = "mesh_cache_first.obj";
+  const std::string second_ = "mesh_cache_second.obj";
+  s21::MeshCache::Settings settings_;
+};
+
+// Test: A stored snapshot loads back identical to the parsed data.
+TEST_F(MeshCacheTest, RoundTrip) {
+  s21::MeshCache cache(settings_);
+  s21::OBJData parsed = ParseAndStore(cache, first_);
+
+  s21::OBJData loaded;
+  ASSERT_TRUE(cache.Load(first_, loaded));
+  ExpectSameData(parsed, loaded);
+  EXPECT_EQ(loaded.face_vertices.size(), parsed.face_vertices.size());
+}
+
+// Test: Changed sources miss, even with the same size.
+TEST_F(MeshCacheTest, StaleSourceMisses) {
+  s21::MeshCache cache(settings_);
+  ParseAndStore(cache, first_);
+
+  std::string changed = chunked_obj_content;
+  changed[2] = '2';
+  WriteSource(first_, changed);
+  s21::OBJData loaded;
+  EXPECT_FALSE(cache.Load(first_, loaded));
+  EXPECT_TRUE(loaded.vertices.empty());
+
+  // Storing again replaces the stale snapshot.
+  ParseAndStore(cache, first_);
+  EXPECT_TRUE(cache.Load(first_, loaded));
+}
+
+// Test: Data read from a source that changed meanwhile is not cached under
+// the new contents.
+TEST_F(MeshCacheTest, SourceChangedWhileReadIsNotStored) {
+  s21::MeshCache cache(settings_);
+  const s21::MeshCache::SourceStamp before = Stamp(first_);
+  s21::OBJData data;
+  data.Parse(first_);
+  data.Normalize();
+
+  std::string changed = chunked_obj_content;
+  changed[2] = '2';
+  WriteSource(first_, changed);
+  cache.Store(first_, before, data);
+  cache.StoreAttachment(first_, before, "lod", "level");
+
+  s21::OBJData loaded;
+  EXPECT_FALSE(cache.Load(first_, loaded));
+  std::string bytes;
+  EXPECT_FALSE(cache.LoadAttachment(first_, "lod", bytes));
+  EXPECT_TRUE(!std::filesystem::exists(directory_) ||
+              std::filesystem::is_empty(directory_));
+}
+
+// Test: A cancelled load stops verifying or writing a snapshot.
+TEST_F(MeshCacheTest, CancelStopsLoadAndStore) {
+  s21::MeshCache cache(settings_);
+  s21::OBJData parsed = ParseAndStore(cache, first_);
+  s21::LoadMonitor monitor;
+  monitor.Cancel();
+
+  s21::OBJData loaded;
+  EXPECT_THROW(cache.Load(first_, loaded, &monitor),
+               s21::LoadCancelledException);
+  EXPECT_TRUE(loaded.vertices.empty());
+
+  std::filesystem::remove_all(directory_);
+  EXPECT_THROW(cache.Store(second_, Stamp(second_), parsed, &monitor),
+               s21::LoadCancelledException);
+  EXPECT_FALSE(cache.Load(second_, loaded));
+  EXPECT_TRUE(!std::filesystem::exists(directory_) ||
+              std::filesystem::is_empty(directory_));
+}
+
+// Test: Corrupt, truncated or old-version snapshots miss.
+TEST_F(MeshCacheTest, CorruptEntryMisses) {
+  s21::MeshCache cache(settings_);
+  ParseAndStore(cache, first_);
+  const std::string entry = EntryPath();
+  const auto size = std::filesystem::file_size(entry);
+  s21::OBJData loaded;
+
+  PatchByte(entry, size - 20, 0x7f);
+  EXPECT_FALSE(cache.Load(first_, loaded));
+
+  ParseAndStore(cache, first_);
+  std::filesystem::resize_file(entry, size - 1);
+  EXPECT_FALSE(cache.Load(first_, loaded));
+
+  ParseAndStore(cache, first_);
+  PatchByte(entry, 8, static_cast<char>(s21::MeshCache::kVersion + 1));
+  EXPECT_FALSE(cache.Load(first_, loaded));
+  EXPECT_TRUE(loaded.vertices.empty());
+}
+
+// Test: The least recently used snapshot is evicted over the size limit.
+TEST_F(MeshCacheTest, EvictsLeastRecentlyUsed) {
+  const std::string third = "mesh_cache_third.obj";
+  WriteSource(third, sample_obj_content);
+  uintmax_t sizes = 0;
+  for (const std::string& path : {first_, second_}) {
+    s21::MeshCache cache(settings_);
+    ParseAndStore(cache, path);
+    sizes += std::filesystem::file_size(EntryPath());
+    std::filesystem::remove_all(directory_);
+  }
+
+  // Room for the first two snapshots; using the first makes the second the
+  // least recently used one.
+  settings_.size_limit = sizes;
+  s21::MeshCache cache(settings_);
+  ParseAndStore(cache, first_);
+  ParseAndStore(cache, second_);
+  s21::OBJData loaded;
+  EXPECT_TRUE(cache.Load(first_, loaded));
+  ParseAndStore(cache, third);
+
+  EXPECT_TRUE(cache.Load(first_, loaded));
+  EXPECT_FALSE(cache.Load(second_, loaded));
+  EXPECT_TRUE(cache.Load(third, loaded));
+  std::remove(third.c_str());
+}
+
+// Test: Attachments load back until the source changes and are evicted
+// together with their snapshot.
+TEST_F(MeshCacheTest, AttachmentsFollowTheirSnapshot) {
+  s21::MeshCache cache(settings_);
+  ParseAndStore(cache, first_);
+  const std::string bytes("level\0data", 10);
+  cache.StoreAttachment(first_, Stamp(first_), "lod", bytes);
+
+  std::string loaded;
+  ASSERT_TRUE(cache.LoadAttachment(first_, "lod", loaded));
+  EXPECT_EQ(loaded, bytes);
+  EXPECT_FALSE(cache.LoadAttachment(first_, "other", loaded));
+  EXPECT_FALSE(cache.LoadAttachment(second_, "lod", loaded));
+
+  std::string changed = chunked_obj_content;
+  changed[2] = '2';
+  WriteSource(first_, changed);
+  EXPECT_FALSE(cache.LoadAttachment(first_, "lod", loaded));
+
+  // Only one of the two sources fits; storing the second evicts both files
+  // of the first.
+  WriteSource(first_, chunked_obj_content);
+  ParseAndStore(cache, first_);
+  cache.StoreAttachment(first_, Stamp(first_), "lod", bytes);
+  uintmax_t sizes = 0;
+  for (const auto& file : std::filesystem::directory_iterator(directory_)) {
+    sizes += file.file_size();
+  }
+  settings_.size_limit = sizes;
+  s21::MeshCache small(settings_);
+  ParseAndStore(small, second_);
+  EXPECT_FALSE(small.LoadAttachment(first_, "lod", loaded));
+  s21::OBJData data;
+  EXPECT_FALSE(small.Load(first_, data));
+  EXPECT_TRUE(small.Load(second_, data));
+}
+
+// Test: An empty directory disables the cache.
+TEST_F(MeshCacheTest, DisabledCacheDoesNothing) {
+  settings_.directory.clear();
+  s21::MeshCache cache(settings_);
+  ParseAndStore(cache, first_);
+
+  s21::OBJData loaded;
+  EXPECT_FALSE(cache.Load(first_, loaded));
+  EXPECT_FALSE(std::filesystem::exists(directory_));
+}
+
+// Writes about 12 MB of vertex and face lines, three progress slices.
+std::string CreateLargeObjFile() {
+  std::string content;
+  for (int i = 0; i < 300000; ++i) {
+    content += "v " + std::to_string(i) + ".25 -1.5 " + std::to_string(i % 7) +
+               "\nf -1 -1 -1\nvn 0 0 1\n";
+  }
+  return CreateTempObjFile(content);
+}
+
+// Test: Parsing with a monitor reports every byte and gives the same data.
+TEST(OBJDataParserTest, ParseReportsProgress) {
+  std::string filename = CreateLargeObjFile();
+  const uint64_t size = std::filesystem::file_size(filename);
+  s21::OBJData expected;
+  expected.Parse(filename);
+
+  for (size_t threads : {1, 4}) {
+    SCOPED_TRACE(threads);
+    size_t reports = 0;
+    s21::LoadProgress last;
+    s21::LoadMonitor monitor([&](const s21::LoadProgress& progress) {
+      ++reports;
+      last = progress;
+    });
+    s21::OBJData data;
+    data.Parse(filename, threads, &monitor);
+    EXPECT_GE(reports, 3u);
+    EXPECT_EQ(last.bytes_parsed, size);
+    EXPECT_EQ(last.bytes_total, size);
+    ExpectSameData(expected, data);
+  }
+  std::remove(filename.c_str());
+}
+
+// Test: Cancelling from a progress report stops the parse.
+TEST(OBJDataParserTest, ParseCanBeCancelled) {
+  std::string filename = CreateLargeObjFile();
+  for (size_t threads : {1, 4}) {
+    SCOPED_TRACE(threads);
+    s21::LoadMonitor* self = nullptr;
+    s21::LoadMonitor monitor(
+        [&](const s21::LoadProgress&) { self->Cancel(); });
+    self = &monitor;
+    s21::OBJData data;
+    EXPECT_THROW(data.Parse(filename, threads, &monitor),
+                 s21::LoadCancelledException);
+  }
+  std::remove(filename.c_str());
+}
+
+// Compresses content into a new .gz file, as count concatenated members.
+std::string CreateTempGzipFile(const std::string& content, int count = 1) {
+  std::string filename = "temp_test.obj.gz";
+  const size_t part = content.size() / count + 1;
+  for (int i = 0; i < count; ++i) {
+    gzFile file = gzopen(filename.c_str(), i == 0 ? "wb" : "ab");
+    std::string_view piece = std::string_view(content).substr(
+        std::min(content.size(), i * part), part);
+    if (!piece.empty()) gzwrite(file, piece.data(), piece.size());
+    gzclose(file);
+  }
+  return filename;
+}
+
+// Test: Blocks end at line breaks and add up to the text, also when lines are
+// longer than the buffers and the file has several gzip members.
+TEST(GzipReaderTest, BlocksEndAtLineBreaks) {
+  const std::string content = std::string(chunked_obj_content) + "v 1 2 3";
+  for (int members : {1, 3}) {
+    SCOPED_TRACE(members);
+    std::string filename = CreateTempGzipFile(content, members);
+    s21::GzipReader reader(filename, 8);
+    std::string text;
+    uint64_t compressed = 0;
+    reader.ReadLines([&](std::string_view lines, uint64_t bytes) {
+      text += lines;
+      compressed += bytes;
+      if (text.size() < content.size()) {
+        EXPECT_TRUE(lines.back() == '\n' || lines.back() == '\r');
+      }
+    });
+    EXPECT_EQ(text, content);
+    EXPECT_EQ(compressed, reader.CompressedSize());
+    std::remove(filename.c_str());
+  }
+}
+
+// Test: Parsing a compressed file gives the same data as the plain file and
+// reports progress in compressed bytes.
+TEST(OBJDataParserTest, ParseGzipMatchesPlain) {
+  std::string filename = CreateLargeObjFile();
+  std::ifstream in(filename, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+  std::string compressed = CreateTempGzipFile(content);
+  s21::OBJData expected;
+  expected.Parse(filename);
+  std::remove(filename.c_str());
+
+  s21::LoadProgress last;
+  s21::LoadMonitor monitor(
+      [&](const s21::LoadProgress& progress) { last = progress; });
+  s21::OBJData data;
+  data.ParseGzip(compressed, &monitor);
+  ExpectSameData(expected, data);
+  EXPECT_EQ(last.bytes_parsed, std::filesystem::file_size(compressed));
+  EXPECT_EQ(last.bytes_total, last.bytes_parsed);
+
+  s21::LoadMonitor* self = nullptr;
+  s21::LoadMonitor cancelling(
+      [&](const s21::LoadProgress&) { self->Cancel(); });
+  self = &cancelling;
+  s21::OBJData cancelled;
+  EXPECT_THROW(cancelled.ParseGzip(compressed, &cancelling),
+               s21::LoadCancelledException);
+  std::remove(compressed.c_str());
+}
+
+// Test: Truncated or non-gzip input fails with a load error.
+TEST(OBJDataParserTest, ParseGzipRejectsBadInput) {
+  std::string compressed = CreateTempGzipFile(sample_obj_content);
+  std::filesystem::resize_file(compressed,
+                               std::filesystem::file_size(compressed) - 10);
+  s21::OBJData truncated;
+  EXPECT_THROW(truncated.ParseGzip(compressed), s21::MeshLoadException);
+  std::remove(compressed.c_str());
+
+  std::string plain = CreateTempObjFile(sample_obj_content);
+  s21::OBJData data;
+  EXPECT_THROW(data.ParseGzip(plain), s21::MeshLoadException);
+  EXPECT_THROW(data.ParseGzip(plain + ".missing"), s21::MeshLoadException);
+  std::remove(plain.c_str());
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
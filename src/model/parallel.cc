@@ -0,0 +1,149 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#ifdef S21_WITH_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#endif
+
+namespace s21 {
+
+/**
+ * @struct ThreadPool::Job
+ * @brief A parallel loop being run, owned by the thread that started it.
+ */
+struct ThreadPool::Job {
+  const RangeBody& body;            ///< The loop body.
+  size_t count;                     ///< Number of indices.
+  size_t grain;                     ///< Indices per chunk.
+  size_t chunks;                    ///< Number of chunks.
+  std::atomic<size_t> next{0};      ///< Next chunk to claim.
+  std::atomic<bool> failed{false};  ///< Set once a chunk has thrown.
+  std::exception_ptr error;         ///< First exception, under error_mutex.
+  std::mutex error_mutex;           ///< Guards error.
+  size_t active = 0;                ///< Workers inside Work(), under mutex_.
+
+  Job(const RangeBody& body, size_t count, size_t grain)
+      : body(body),
+        count(count),
+        grain(grain),
+        chunks((count + grain - 1) / grain) {}
+
+  /// Runs chunks until none are left to claim.
+  void Work() {
+    for (size_t chunk = next++; chunk < chunks; chunk = next++) {
+      if (failed) continue;
+      const size_t begin = chunk * grain;
+      try {
+        body(begin, std::min(count, begin + grain));
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+        failed = true;
+      }
+    }
+  }
+};
+
+ThreadPool::ThreadPool(size_t workers) {
+  workers_.reserve(workers);
+  for (size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+ThreadPool& ThreadPool::Shared() {
+  static ThreadPool pool(
+      std::max(1u, std::thread::hardware_concurrency()) - 1);
+  return pool;
+}
+
+void ThreadPool::For(size_t count, size_t grain, const RangeBody& body) {
+  if (count == 0) return;
+  grain = std::max<size_t>(grain, 1);
+  if (workers_.empty() || count <= grain) {
+    body(0, count);
+    return;
+  }
+
+  Job job(body, count, grain);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(&job);
+  }
+  work_.notify_all();
+
+  job.Work();
+  {
+    // Chunks are done once no worker is inside the job any more.
+    std::unique_lock<std::mutex> lock(mutex_);
+    Dequeue(&job);
+    idle_.wait(lock, [&job] { return job.active == 0; });
+  }
+  if (job.error) std::rethrow_exception(job.error);
+}
+
+void ThreadPool::WorkerLoop() {
+  for (;;) {
+    Job* job = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+      if (stop_) return;
+      // The newest job is the innermost loop, which outer loops wait for.
+      job = jobs_.back();
+      ++job->active;
+    }
+    job->Work();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Dequeue(job);
+      --job->active;
+    }
+    idle_.notify_all();
+  }
+}
+
+void ThreadPool::Dequeue(Job* job) {
+  auto it = std::find(jobs_.begin(), jobs_.end(), job);
+  if (it != jobs_.end()) jobs_.erase(it);
+}
+
+void ParallelFor(size_t count, size_t grain, const RangeBody& body) {
+  grain = std::max<size_t>(grain, 1);
+#ifdef S21_WITH_TBB
+  if (count <= grain) {
+    if (count > 0) body(0, count);
+    return;
+  }
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, count, grain),
+                    [&body](const tbb::blocked_range<size_t>& range) {
+                      body(range.begin(), range.end());
+                    });
+#else
+  ThreadPool::Shared().For(count, grain, body);
+#endif
+}
+
+size_t ParallelConcurrency() {
+#ifdef S21_WITH_TBB
+  return static_cast<size_t>(tbb::this_task_arena::max_concurrency());
+#else
+  return ThreadPool::Shared().Concurrency();
+#endif
+}
+
+}  // namespace s21
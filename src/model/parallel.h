@@ -0,0 +1,102 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace s21 {
+
+/// Processes the index range [begin, end) of a parallel loop.
+using RangeBody = std::function<void(size_t begin, size_t end)>;
+
+/**
+ * @class ThreadPool
+ * @brief Persistent worker threads running parallel loops.
+ *
+ * A loop is split into chunks that are claimed one at a time by the calling
+ * thread and by idle workers, so the caller always works on its own loop
+ * and never waits for a free thread. Loops started from inside a chunk are
+ * served by idle workers before the outer ones, which lets nested loops
+ * share the workers without creating threads or deadlocking.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Starts the workers.
+   * @param workers Number of threads besides the callers; 0 runs every
+   * loop on the calling thread.
+   */
+  explicit ThreadPool(size_t workers);
+
+  /// Stops and joins the workers; no loop may be running.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Returns the pool shared by the application.
+   * @return A pool with one worker less than the hardware threads.
+   */
+  static ThreadPool& Shared();
+
+  /**
+   * @brief Returns the number of threads a loop can run on.
+   * @return Workers plus the calling thread.
+   */
+  size_t Concurrency() const { return workers_.size() + 1; }
+
+  /**
+   * @brief Runs body over [0, count) in chunks and waits for all of them.
+   * @param count Number of indices.
+   * @param grain Number of indices per chunk; at least 1.
+   * @param body Called once per chunk, possibly on several threads at once.
+   *
+   * If a chunk throws, the chunks not yet started are skipped and the first
+   * exception is rethrown once the running ones have finished.
+   */
+  void For(size_t count, size_t grain, const RangeBody& body);
+
+ private:
+  struct Job;
+
+  std::vector<std::thread> workers_;  ///< The worker threads.
+  std::mutex mutex_;                  ///< Guards jobs_, stop_ and Job::active.
+  std::condition_variable work_;      ///< Signals new jobs or stop_.
+  std::condition_variable idle_;      ///< Signals a worker leaving a job.
+  std::vector<Job*> jobs_;            ///< Loops with chunks left, newest last.
+  bool stop_ = false;                 ///< Set to end the workers.
+
+  /// Claims chunks of the newest job until stopped.
+  void WorkerLoop();
+
+  /**
+   * @brief Removes a job from the queue if it is still there.
+   * @param job The job; mutex_ must be held.
+   */
+  void Dequeue(Job* job);
+};
+
+/**
+ * @brief Runs a parallel loop on the application's execution layer.
+ * @param count Number of indices.
+ * @param grain Minimum number of indices worth a separate task.
+ * @param body Called for disjoint ranges covering [0, count), possibly on
+ * several threads at once.
+ *
+ * Uses TBB when the project is built with S21_WITH_TBB and the shared
+ * ThreadPool otherwise. Loops with at most grain indices run directly on
+ * the calling thread.
+ */
+void ParallelFor(size_t count, size_t grain, const RangeBody& body);
+
+/**
+ * @brief Returns how many threads ParallelFor() can use.
+ * @return Number of threads, at least 1.
+ */
+size_t ParallelConcurrency();
+
+}  // namespace s21
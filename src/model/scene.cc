@@ -1,77 +1,220 @@
 #include "scene.h"
 
+#include <limits>
+
+#include "math/vertex_transform.h"
+#include "parallel.h"
+
 namespace s21 {
-std::shared_ptr<DrawSceneData> Scene::LoadSceneMeshData(OBJData obj_data) {
+std::shared_ptr<DrawSceneData> Scene::LoadSceneMeshData(OBJData&& obj_data,
+                                                        LoadMonitor* monitor) {
+  if (monitor) monitor->SetStage(LoadProgress::Stage::kBuildingEdges);
+  if (order_ == VertexOrder::kMorton) SortVertices(obj_data);
   draw_scene_data_ = std::make_shared<DrawSceneData>();
-  // Store initial mesh vetrex coordinates
-  mesh_vertexes_.assign(obj_data.vertices.begin(), obj_data.vertices.end());
+  source_vertices_.clear();
+  source_arrays_ = layout_ == VertexLayout::kArrays
+                       ? PositionArrays(obj_data.vertices)
+                       : PositionArrays();
 
-  // Vertices for render
-  draw_scene_data_->vertices.reserve(mesh_vertexes_.size() * 3);
+  ExtractEdges(obj_data, monitor, *draw_scene_data_);
 
-  // Flatten vertices into x,y,z components
-  for (const auto& [x, y, z, w] : mesh_vertexes_) {
-    draw_scene_data_->vertices.insert(draw_scene_data_->vertices.end(),
-                                      {x, y, z});
-  }
+  draw_scene_data_->info = obj_data.toString() + "Edges count: " +
+                           std::to_string(draw_scene_data_->edge_count) + "\n";
+  // Hand the parsed positions to the renderer without copying them
+  draw_scene_data_->vertices = std::move(obj_data.vertices);
 
-  // Process mesh faces and edges using range-based iteration
-  auto processFace = [this](const Face& face) {
-    size_t vertices_size = face.vertices.size();
-    if (vertices_size >= 2) {
-      for (size_t i = 0; i < vertices_size; ++i) {
-        draw_scene_data_->vertex_indices.push_back(face.vertices[i].v);
-        draw_scene_data_->vertex_indices.push_back(
-            face.vertices[(i + 1) % vertices_size].v);
+  return draw_scene_data_;
+}
+
+void Scene::ExtractEdges(const OBJData& obj_data, LoadMonitor* monitor,
+                         DrawSceneData& data) {
+  const FaceRange faces = obj_data.Faces();
+  const size_t vertex_count = obj_data.vertices.size();
+
+  // Calls side(a, b) for every polygon side whose ends are distinct, valid
+  // vertices, checking for cancellation between batches of faces.
+  auto for_each_side = [&](auto side) {
+    constexpr size_t kBatch = size_t{1} << 16;
+    for (size_t first = 0; first < faces.size(); first += kBatch) {
+      if (monitor) monitor->ThrowIfCancelled();
+      const size_t last = std::min(first + kBatch, faces.size());
+      for (size_t i = first; i < last; ++i) {
+        const auto& vertices = faces[i].vertices;
+        const size_t n = vertices.size();
+        if (n < 2) continue;
+        // Invalid references are -1 and become huge when unsigned.
+        uint32_t a = static_cast<uint32_t>(vertices[n - 1].v);
+        for (size_t k = 0; k < n; ++k) {
+          const uint32_t b = static_cast<uint32_t>(vertices[k].v);
+          if (a != b && a < vertex_count && b < vertex_count) {
+            side(std::min(a, b), std::max(a, b));
+          }
+          a = b;
+        }
       }
     }
   };
 
-  for (const auto& object : obj_data.objects) {
-    for (const auto& mesh : object.meshes) {
-      std::for_each(mesh.faces.begin(), mesh.faces.end(), processFace);
+  // Only vertices referenced by faces need a bucket.
+  int max_vertex = -1;
+  for (const VertexIndices& reference : obj_data.face_vertices) {
+    if (static_cast<size_t>(reference.v) < vertex_count) {
+      max_vertex = std::max(max_vertex, reference.v);
     }
   }
+  const size_t bucket_count = static_cast<size_t>(max_vertex + 1);
 
-  draw_scene_data_->info = obj_data.toString();
+  // Bucket the larger end of every side by its smaller end, a counting sort
+  // on the smaller end. The parser keeps face vertices below 2^32, so 32-bit
+  // offsets suffice. Counts become bucket ends, and scattering backwards
+  // turns them into bucket starts.
+  std::vector<uint32_t> starts(bucket_count + 1, 0);
+  for_each_side([&](uint32_t low, uint32_t) { ++starts[low]; });
+  for (size_t v = 1; v < bucket_count; ++v) starts[v] += starts[v - 1];
+  if (bucket_count > 0) starts[bucket_count] = starts[bucket_count - 1];
 
-  return draw_scene_data_;
-}
+  std::vector<uint32_t> highs(starts[bucket_count]);
+  for_each_side(
+      [&](uint32_t low, uint32_t high) { highs[--starts[low]] = high; });
 
-void Scene::TransformSceneMeshData(Mat4f& transform_matrix) {
-  if (!draw_scene_data_) return;
-  const size_t vertexCount = mesh_vertexes_.size();
+  // A bucket holds the few neighbours of one vertex, so an insertion sort is
+  // cheapest. Buckets are deduplicated in parallel, marking the end of the
+  // distinct neighbours of a shortened bucket with kNoVertex.
+  constexpr uint32_t kNoVertex = std::numeric_limits<uint32_t>::max();
+  constexpr size_t kBucketGrain = size_t{1} << 14;
+  ParallelFor(bucket_count, kBucketGrain, [&](size_t first, size_t last) {
+    for (size_t low = first; low < last; ++low) {
+      uint32_t* begin = highs.data() + starts[low];
+      uint32_t* end = highs.data() + starts[low + 1];
+      for (uint32_t* it = begin + 1; it < end; ++it) {
+        const uint32_t value = *it;
+        uint32_t* hole = it;
+        for (; hole > begin && hole[-1] > value; --hole) *hole = hole[-1];
+        *hole = value;
+      }
+      uint32_t* unique_end = std::unique(begin, end);
+      if (unique_end != end) *unique_end = kNoVertex;
+    }
+  });
 
-  LogInfoOnce << "First transform..." << std::endl;
-  size_t num_threads = std::thread::hardware_concurrency();  // Auto-detect
-  num_threads = (num_threads == 0) ? 1 : num_threads;        // Handle failure
+  // Pack the distinct neighbours to the front of highs and rewrite starts to
+  // the packed buckets.
+  uint32_t packed = 0;
+  for (size_t low = 0; low < bucket_count; ++low) {
+    const uint32_t end = starts[low + 1];
+    uint32_t i = starts[low];
+    starts[low] = packed;
+    for (; i < end && highs[i] != kNoVertex; ++i) highs[packed++] = highs[i];
+  }
+  if (bucket_count > 0) starts[bucket_count] = packed;
+
+  // Each distinct neighbour gives one undirected edge. Edges go into 16-bit
+  // batches covering 2^16 vertices from their base; the rare edges longer
+  // than that are collected for a final 32-bit batch.
+  constexpr uint32_t kShortRange = uint32_t{1} << 16;
+  data.edge_count = packed;
+  data.edge_batches.clear();
+  data.index_data.clear();
+  data.index_data.reserve(size_t{packed} * 2);
+  std::vector<uint32_t> wide_indices;
+  EdgeBatch batch;
+  for (size_t low = 0; low < bucket_count; ++low) {
+    for (uint32_t i = starts[low]; i < starts[low + 1]; ++i) {
+      const uint32_t high = highs[i];
+      if (high - low >= kShortRange) {
+        wide_indices.push_back(static_cast<uint32_t>(low));
+        wide_indices.push_back(high);
+        continue;
+      }
+      if (high - batch.base_vertex >= kShortRange) {
+        if (batch.count > 0) data.edge_batches.push_back(batch);
+        batch = EdgeBatch{static_cast<uint32_t>(low),
+                          data.index_data.size() * sizeof(uint16_t), 0, false};
+      }
+      data.index_data.push_back(
+          static_cast<uint16_t>(low - batch.base_vertex));
+      data.index_data.push_back(
+          static_cast<uint16_t>(high - batch.base_vertex));
+      batch.count += 2;
+    }
+  }
+  if (batch.count > 0) data.edge_batches.push_back(batch);
 
-  LogInfoOnce << "Threads count: " << num_threads << std::endl;
-  const size_t chunk_size = (vertexCount + num_threads - 1) / num_threads;
+  if (!wide_indices.empty()) {
+    // 32-bit indices must start at a 4-byte boundary.
+    if (data.index_data.size() % 2 != 0) data.index_data.push_back(0);
+    const size_t offset = data.index_data.size();
+    data.edge_batches.push_back(EdgeBatch{
+        0, offset * sizeof(uint16_t), wide_indices.size(), true});
+    data.index_data.resize(offset + wide_indices.size() * 2);
+    std::memcpy(data.index_data.data() + offset, wide_indices.data(),
+                wide_indices.size() * sizeof(uint32_t));
+  }
+  data.index_data.shrink_to_fit();
+}
 
-  std::vector<std::thread> threads;
-  threads.reserve(num_threads);
+void Scene::SortVertices(OBJData& obj_data) {
+  constexpr size_t kGrain = size_t{1} << 16;
+  const size_t count = obj_data.vertices.size();
+  const std::vector<uint32_t> order =
+      SpatialOrder::Morton(obj_data.vertices.data(), count);
+  const std::vector<uint32_t> place = SpatialOrder::Invert(order);
 
-  // Create and launch threads
-  for (size_t i = 0; i < num_threads; ++i) {
-    const size_t start = i * chunk_size;
-    const size_t end = std::min(start + chunk_size, vertexCount);
+  std::vector<Vec3f> sorted(count);
+  ParallelFor(count, kGrain, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      sorted[i] = obj_data.vertices[order[i]];
+    }
+  });
+  obj_data.vertices = std::move(sorted);
 
-    // Skip empty chunks if vertexCount < num_threads
-    if (start >= end) break;
+  std::vector<VertexIndices>& references = obj_data.face_vertices;
+  ParallelFor(references.size(), kGrain, [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      const int v = references[i].v;
+      if (v >= 0 && static_cast<size_t>(v) < count) {
+        references[i].v = static_cast<int>(place[v]);
+      }
+    }
+  });
+}
 
-    threads.emplace_back([this, &transform_matrix, start, end] {
-      for (size_t j = start; j < end; ++j) {
-        auto [x, y, z, w] = mesh_vertexes_[j] * transform_matrix;
-        draw_scene_data_->vertices[j * 3] = x;
-        draw_scene_data_->vertices[j * 3 + 1] = y;
-        draw_scene_data_->vertices[j * 3 + 2] = z;
+double DrawSceneData::MeanIndexJump() const {
+  uint64_t total = 0, indices = 0;
+  uint32_t previous = 0;
+  for (const EdgeBatch& batch : edge_batches) {
+    for (size_t i = 0; i < batch.count; ++i) {
+      const uint32_t index = EdgeIndex(batch, i);
+      if (indices++ > 0) {
+        total += index > previous ? index - previous : previous - index;
       }
-    });
+      previous = index;
+    }
   }
-  // Wait for all threads to complete
-  for (auto& thread : threads) {
-    thread.join();
+  return indices > 1 ? static_cast<double>(total) / (indices - 1) : 0.0;
+}
+
+void Scene::TransformSceneMeshData(Mat4f& transform_matrix) {
+  if (!draw_scene_data_) return;
+  // Small models are transformed on the calling thread.
+  constexpr size_t kGrain = size_t{1} << 14;
+  Vec3f* target = draw_scene_data_->vertices.data();
+
+  if (layout_ == VertexLayout::kArrays) {
+    const PositionArrays& source = source_arrays_;
+    ParallelFor(source.size(), kGrain, [&](size_t begin, size_t end) {
+      VertexTransform::ApplyArrays(transform_matrix, source.x() + begin,
+                                   source.y() + begin, source.z() + begin,
+                                   target + begin, end - begin);
+    });
+    return;
   }
+
+  if (source_vertices_.empty()) source_vertices_ = draw_scene_data_->vertices;
+  const Vec3f* source = source_vertices_.data();
+  ParallelFor(source_vertices_.size(), kGrain, [&](size_t begin, size_t end) {
+    VertexTransform::Apply(transform_matrix, source + begin, target + begin,
+                           end - begin);
+  });
 }
 }  // namespace s21
@@ -1,13 +1,42 @@
 #pragma once
 
 #include <algorithm>
-#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <vector>
 
+#include "math/position_arrays.h"
+#include "math/quantized_positions.h"
+#include "math/spatial_order.h"
 #include "obj/obj_data.h"
 
 namespace s21 {
 
+/**
+ * @enum SceneChange
+ * @brief What changed in a scene when listeners are notified.
+ *
+ * Tells the renderer whether the buffers it holds are still valid: only
+ * kGeometry requires the vertex and index data to be uploaded again.
+ */
+enum class SceneChange {
+  kTransform,  ///< Scene parameters changed; positions are untouched.
+  kStyle,      ///< Display settings changed; the scene is untouched.
+  kGeometry,   ///< Vertices or edges changed, or a new scene was loaded.
+};
+
+/**
+ * @struct EdgeBatch
+ * @brief A run of edge indices drawn with one call and one index type.
+ */
+struct EdgeBatch {
+  uint32_t base_vertex = 0;  ///< Added to every index of the batch.
+  size_t offset = 0;         ///< Start in DrawSceneData::index_data in bytes.
+  size_t count = 0;          ///< Number of indices, two per edge.
+  bool wide = false;         ///< 32-bit indices instead of 16-bit ones.
+};
+
 /**
  * @struct DrawSceneData
  * @brief Holds the data required for rendering the scene, including vertices,
@@ -16,13 +45,46 @@ namespace s21 {
  * This structure encapsulates the essential data needed to draw a 3D scene. It
  * includes vertex coordinates, indices for constructing the mesh topology, and
  * a string for additional scene information.
+ *
+ * Edge indices use 16 bits wherever possible. Edges are grouped into batches
+ * whose indices are stored relative to a base vertex, so a model with fewer
+ * than 65,536 vertices is a single 16-bit batch, and larger models get one
+ * 16-bit batch per range of 65,536 vertices. Only edges spanning more than
+ * that range are stored in a final 32-bit batch.
  */
 struct DrawSceneData {
-  std::vector<float> vertices;      ///< Vertex coordinates stored as floats,
-                                    ///< representing the mesh geometry.
-  std::vector<int> vertex_indices;  ///< Indices that define the mesh topology
-                                    ///< by connecting vertices.
+  std::vector<Vec3f> vertices;  ///< Vertex positions, packed as x, y, z
+                                ///< floats for direct upload.
+  std::vector<uint16_t>
+      index_data;  ///< Index data of all batches, uploaded as one buffer; a
+                   ///< 32-bit index takes two elements.
+  std::vector<EdgeBatch> edge_batches;  ///< Batches in index_data order.
+  size_t edge_count = 0;                ///< Number of unique edges.
   std::string info;  ///< Additional metadata or information about the scene.
+  /// The vertices as 16-bit positions; null unless the loader encoded them.
+  std::shared_ptr<const QuantizedPositions> quantized;
+
+  /**
+   * @brief Returns an index of a batch as an absolute vertex index.
+   * @param batch One of edge_batches.
+   * @param i Position of the index within the batch.
+   * @return The vertex index.
+   */
+  uint32_t EdgeIndex(const EdgeBatch& batch, size_t i) const {
+    const uint16_t* data = index_data.data() + batch.offset / sizeof(uint16_t);
+    if (!batch.wide) return batch.base_vertex + data[i];
+    uint32_t index;
+    std::memcpy(&index, data + 2 * i, sizeof(index));
+    return batch.base_vertex + index;
+  }
+
+  /**
+   * @brief Measures how far apart consecutive edge indices are.
+   * @return The mean absolute difference between consecutive vertex indices
+   * of all batches; 0 without edges. Smaller values mean fewer cache misses
+   * when the edges are drawn.
+   */
+  double MeanIndexJump() const;
 };
 
 /**
@@ -31,24 +93,44 @@ struct DrawSceneData {
  *
  * The `Scene` class is designed to handle mesh data operations, such as loading
  * from an `OBJData` object and applying transformations to the mesh vertices.
- * It maintains a private vector of vertices in homogeneous coordinates and a
- * shared pointer to rendering data.
+ * It maintains a shared pointer to rendering data. Vertex positions are moved
+ * from the parser into that data without being copied; a copy of the original
+ * positions is only made if the CPU transform is used. With
+ * VertexLayout::kArrays, that copy is made at load time as coordinate arrays,
+ * which the CPU transform reads without shuffling. With VertexOrder::kMorton,
+ * the vertices are sorted spatially at load time and the faces renumbered.
  */
 class Scene {
  public:
+  /**
+   * @brief Creates an empty scene.
+   * @param layout How the original positions are kept for the CPU transform.
+   * @param order Order of the vertices of loaded scenes.
+   */
+  explicit Scene(VertexLayout layout = VertexLayout::kInterleaved,
+                 VertexOrder order = VertexOrder::kFile)
+      : layout_(layout), order_(order) {}
+
   /**
    * @brief Loads mesh data from an `OBJData` object into a format suitable for
    * rendering.
    * @param obj_data The `OBJData` object containing the raw mesh data to be
-   * processed.
+   * processed. Its vertices are moved into the returned data; with
+   * VertexOrder::kMorton, its face references are renumbered to the new
+   * vertex order.
+   * @param monitor Receives progress and may cancel the load; optional.
    * @return A shared pointer to a `DrawSceneData` object containing the
    * prepared mesh data.
    *
    * This method extracts mesh information from the provided `OBJData` object
    * and organizes it into a `DrawSceneData` structure, which includes vertices,
-   * indices, and metadata for rendering.
+   * indices, and metadata for rendering. Every edge is listed once, even if
+   * several faces share it, and the info reports the number of edges.
+   *
+   * @throws LoadCancelledException if the monitor cancels the load.
    */
-  std::shared_ptr<DrawSceneData> LoadSceneMeshData(OBJData obj_data);
+  std::shared_ptr<DrawSceneData> LoadSceneMeshData(
+      OBJData&& obj_data, LoadMonitor* monitor = nullptr);
 
   /**
    * @brief Applies a transformation matrix to the scene's mesh vertices.
@@ -57,14 +139,42 @@ class Scene {
    *
    * This method transforms each vertex in the mesh by applying the specified
    * 4x4 transformation matrix, which can represent operations such as
-   * translation, rotation, or scaling. The transformed vertices are stored
-   * internally for further use.
+   * translation, rotation, or scaling. The original positions are saved on
+   * the first call, so repeated transforms do not accumulate. Ranges of
+   * vertices are transformed in parallel with the VertexTransform kernels.
    */
   void TransformSceneMeshData(Mat4f& transform_matrix);
 
  private:
-  std::vector<Vec4f> mesh_vertexes_;  ///< Mesh vertices stored as 4D vectors in
-                                      ///< homogeneous coordinates.
+  /**
+   * @brief Collects every undirected edge of the faces once.
+   * @param obj_data The parsed mesh data.
+   * @param monitor Checked for cancellation between batches; optional.
+   * @param data Receives the edge batches, index data and edge count.
+   *
+   * Sides shared by adjacent faces are drawn once instead of once per face.
+   * Sides touching an invalid or out-of-range vertex reference and
+   * degenerate sides are dropped, so every index is a valid vertex. Edges
+   * are ordered by their smaller vertex index.
+   */
+  static void ExtractEdges(const OBJData& obj_data, LoadMonitor* monitor,
+                           DrawSceneData& data);
+
+  /**
+   * @brief Sorts the vertices in Morton order and renumbers the faces.
+   * @param obj_data The parsed mesh data.
+   *
+   * Invalid and out-of-range references are left as they are.
+   */
+  static void SortVertices(OBJData& obj_data);
+
+  VertexLayout layout_;  ///< Layout of the untransformed positions.
+  VertexOrder order_;    ///< Order of the vertices of loaded scenes.
+  std::vector<Vec3f>
+      source_vertices_;  ///< Untransformed positions, saved by the first
+                         ///< TransformSceneMeshData() call.
+  PositionArrays source_arrays_;  ///< Untransformed positions, split at load
+                                  ///< time with VertexLayout::kArrays.
   std::shared_ptr<DrawSceneData>
       draw_scene_data_;  ///< Shared pointer to the rendering data of the scene.
 };
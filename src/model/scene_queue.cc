@@ -0,0 +1,75 @@
+#include "scene_queue.h"
+
+#include <algorithm>
+
+#include "filereader.h"
+
+namespace s21 {
+
+SceneQueue::SceneQueue(std::vector<std::string> paths, size_t workers,
+                       size_t ahead, MeshCache::Settings cache)
+    : cache_(std::move(cache)),
+      items_(paths.size()),
+      ready_(paths.size(), false),
+      ahead_(std::max<size_t>(ahead, 1)) {
+  for (size_t i = 0; i < paths.size(); ++i) {
+    items_[i].path = std::move(paths[i]);
+  }
+  workers = std::clamp<size_t>(workers, 1, std::max<size_t>(items_.size(), 1));
+  for (size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+SceneQueue::~SceneQueue() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  changed_.notify_all();
+  for (std::thread& worker : workers_) worker.join();
+}
+
+bool SceneQueue::Next(Item& item) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (returned_ == items_.size()) return false;
+  changed_.wait(lock, [this] { return ready_[returned_]; });
+  item = std::move(items_[returned_]);
+  ++returned_;
+  // Frees a look-ahead slot
+  changed_.notify_all();
+  return true;
+}
+
+void SceneQueue::WorkerLoop() {
+  // Readers are cheap and keep the workers independent of each other
+  FileReader reader(cache_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    changed_.wait(lock, [this] {
+      return stop_ || claimed_ == items_.size() ||
+             claimed_ < returned_ + ahead_;
+    });
+    if (stop_ || claimed_ == items_.size()) return;
+
+    const size_t index = claimed_++;
+    const std::string path = items_[index].path;
+    lock.unlock();
+
+    std::shared_ptr<DrawSceneData> data;
+    std::exception_ptr error;
+    try {
+      data = Scene().LoadSceneMeshData(reader.ReadFile(path.c_str()));
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    items_[index].data = std::move(data);
+    items_[index].error = error;
+    ready_[index] = true;
+    changed_.notify_all();
+  }
+}
+
+}  // namespace s21
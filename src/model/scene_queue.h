@@ -0,0 +1,86 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "obj/mesh_cache.h"
+#include "scene.h"
+
+namespace s21 {
+
+/**
+ * @class SceneQueue
+ * @brief Loads a list of files on worker threads ahead of their consumer.
+ *
+ * Batch jobs such as thumbnail rendering spend most of their time parsing.
+ * The queue keeps worker threads parsing the next files while the consumer
+ * works on the current one, and hands the scenes out in list order. At most
+ * a fixed number of files past the consumer are loaded or being loaded, so
+ * memory stays bounded however long the list is.
+ */
+class SceneQueue {
+ public:
+  /**
+   * @struct Item
+   * @brief A loaded file, or the error that stopped loading it.
+   */
+  struct Item {
+    std::string path;                     ///< The file.
+    std::shared_ptr<DrawSceneData> data;  ///< The scene; null on error.
+    std::exception_ptr error;             ///< Why loading failed, if it did.
+  };
+
+  /**
+   * @brief Starts loading the first files.
+   * @param paths Files in the order Next() returns them.
+   * @param workers Number of loading threads; at least 1.
+   * @param ahead Files past the one last returned that may be loaded at
+   * once; at least 1.
+   * @param cache Cache used by the workers' readers. Empty by default, so a
+   * batch does not evict the snapshots of interactively opened files.
+   */
+  SceneQueue(std::vector<std::string> paths, size_t workers, size_t ahead,
+             MeshCache::Settings cache = {});
+
+  /// Lets the workers finish their current files and joins them.
+  ~SceneQueue();
+
+  SceneQueue(const SceneQueue&) = delete;
+  SceneQueue& operator=(const SceneQueue&) = delete;
+
+  /**
+   * @brief Returns the next file in list order, waiting until it is loaded.
+   * @param item Receives the file.
+   * @return False once every file has been returned.
+   */
+  bool Next(Item& item);
+
+  /**
+   * @brief Returns the number of files in the list.
+   * @return Size of the list passed to the constructor.
+   */
+  size_t size() const { return items_.size(); }
+
+ private:
+  MeshCache::Settings cache_;         ///< Settings of the workers' readers.
+  std::vector<Item> items_;           ///< One per file, in list order.
+  std::vector<bool> ready_;           ///< Whether items_[i] is loaded.
+  size_t ahead_;                      ///< Look-ahead limit.
+  size_t claimed_ = 0;                ///< Files taken by workers so far.
+  size_t returned_ = 0;               ///< Files returned by Next() so far.
+  bool stop_ = false;                 ///< Set to end the workers.
+  std::mutex mutex_;                  ///< Guards the state above.
+  std::condition_variable changed_;   ///< Signals a loaded or taken file.
+  std::vector<std::thread> workers_;  ///< The loading threads.
+
+  /// Loads files until the list is done or the queue is destroyed.
+  void WorkerLoop();
+};
+
+}  // namespace s21
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "parallel.h"
+
+// Test: Every index of a loop is processed exactly once.
+TEST(ThreadPoolTest, CoversRangeOnce) {
+  s21::ThreadPool pool(3);
+  std::vector<std::atomic<int>> hits(100003);
+  pool.For(hits.size(), 100, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) ++hits[i];
+  });
+  for (const auto& hit : hits) ASSERT_EQ(hit, 1);
+}
+
+// Test: Without workers the whole loop runs as one range on the caller.
+TEST(ThreadPoolTest, NoWorkersRunsInline) {
+  s21::ThreadPool pool(0);
+  const auto caller = std::this_thread::get_id();
+  std::vector<std::pair<size_t, size_t>> ranges;
+  pool.For(1000, 10, [&](size_t begin, size_t end) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    ranges.emplace_back(begin, end);
+  });
+  EXPECT_EQ(ranges, (std::vector<std::pair<size_t, size_t>>{{0, 1000}}));
+}
+
+// Test: Loops started inside a chunk complete on the same threads.
+TEST(ThreadPoolTest, NestedLoopsShareThreads) {
+  s21::ThreadPool pool(2);
+  std::atomic<size_t> sum{0};
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  pool.For(16, 1, [&](size_t, size_t) {
+    pool.For(1000, 10, [&](size_t begin, size_t end) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+      }
+      sum += end - begin;
+    });
+  });
+  EXPECT_EQ(sum, 16000u);
+  EXPECT_LE(threads.size(), pool.Concurrency());
+}
+
+// Test: An exception of a chunk reaches the caller and the pool stays usable.
+TEST(ThreadPoolTest, PropagatesExceptions) {
+  s21::ThreadPool pool(3);
+  EXPECT_THROW(pool.For(1000, 1,
+                        [](size_t begin, size_t) {
+                          if (begin == 500) throw std::runtime_error("chunk");
+                        }),
+               std::runtime_error);
+
+  std::atomic<size_t> count{0};
+  pool.For(1000, 1, [&](size_t begin, size_t end) { count += end - begin; });
+  EXPECT_EQ(count, 1000u);
+}
+
+// Test: Loops no larger than the grain run on the calling thread.
+TEST(ParallelForTest, SmallLoopsRunOnCaller) {
+  const auto caller = std::this_thread::get_id();
+  size_t calls = 0;
+  s21::ParallelFor(100, 100, [&](size_t begin, size_t end) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    EXPECT_EQ(begin, 0u);
+    EXPECT_EQ(end, 100u);
+    ++calls;
+  });
+  EXPECT_EQ(calls, 1u);
+  EXPECT_GE(s21::ParallelConcurrency(), 1u);
+}
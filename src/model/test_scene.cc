@@ -0,0 +1,372 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "facade.h"
+#include "filereader.h"
+#include "scene.h"
+#include "scene_queue.h"
+
+// Writes an OBJ file and returns its name.
+std::string CreateObjFile(const std::string& name, const std::string& content) {
+  std::ofstream out(name);
+  out << content;
+  return name;
+}
+
+// Reads a "Vm..." line of /proc/self/status in bytes, or 0 if unavailable.
+size_t ReadStatusBytes(const std::string& field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, field.size() + 1, field + ":") == 0) {
+      return std::stoul(line.substr(field.size() + 1)) * 1024;
+    }
+  }
+  return 0;
+}
+
+// Resets the peak resident set size so VmHWM tracks what follows.
+bool ResetPeakRss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  clear_refs.flush();
+  return clear_refs.good() && ReadStatusBytes("VmHWM") > 0;
+}
+
+// Returns all edge indices of a scene as absolute vertex indices.
+std::vector<int> EdgeIndices(const s21::DrawSceneData& data) {
+  std::vector<int> indices;
+  for (const auto& batch : data.edge_batches) {
+    for (size_t i = 0; i < batch.count; ++i) {
+      indices.push_back(static_cast<int>(data.EdgeIndex(batch, i)));
+    }
+  }
+  return indices;
+}
+
+// Test: Parsed vertices reach the render data without being copied.
+TEST(SceneTest, LoadSceneMovesVertices) {
+  std::string filename = CreateObjFile(
+      "scene_test.obj", "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3 4\n");
+  s21::OBJData data;
+  data.Parse(filename);
+  std::remove(filename.c_str());
+
+  const s21::Vec3f* parsed = data.vertices.data();
+  s21::Scene scene;
+  auto draw_data = scene.LoadSceneMeshData(std::move(data));
+
+  EXPECT_EQ(draw_data->vertices.data(), parsed);
+  ASSERT_EQ(draw_data->vertices.size(), 4u);
+  EXPECT_FLOAT_EQ(draw_data->vertices[2].y, 1.0f);
+  EXPECT_EQ(EdgeIndices(*draw_data),
+            (std::vector<int>{0, 1, 0, 3, 1, 2, 2, 3}));
+}
+
+// Test: Sides shared by faces become one edge, and invalid references never
+// reach the index buffer.
+TEST(SceneTest, ExtractsUniqueEdges) {
+  std::string filename = CreateObjFile(
+      "scene_test.obj",
+      "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+      "f 1 2 3\nf 1 3 4\nf 3 1 2\nf 2 2 1\nf 4 99 1\nf 3 4\n");
+  s21::OBJData data;
+  data.Parse(filename);
+  std::remove(filename.c_str());
+
+  s21::Scene scene;
+  auto draw_data = scene.LoadSceneMeshData(std::move(data));
+  EXPECT_EQ(EdgeIndices(*draw_data),
+            (std::vector<int>{0, 1, 0, 2, 0, 3, 1, 2, 2, 3}));
+  EXPECT_EQ(draw_data->edge_count, 5u);
+  EXPECT_NE(draw_data->info.find("Edges count: 5"), std::string::npos);
+}
+
+// Test: Small models use a single 16-bit batch; large ones get a 16-bit batch
+// per vertex range and a 32-bit batch for edges spanning more than a range.
+TEST(SceneTest, ChoosesIndexWidthPerRange) {
+  std::string content;
+  for (int i = 0; i < 70000; ++i) content += "v 0 0 0\n";
+  content += "f 1 2 3\nf 69999 70000 1\nf 65536 65537 65538\n";
+  std::string filename = CreateObjFile("scene_test.obj", content);
+  s21::OBJData data;
+  data.Parse(filename);
+  std::remove(filename.c_str());
+
+  s21::Scene scene;
+  auto draw_data = scene.LoadSceneMeshData(std::move(data));
+  ASSERT_EQ(draw_data->edge_batches.size(), 3u);
+  const auto& first = draw_data->edge_batches[0];
+  const auto& second = draw_data->edge_batches[1];
+  const auto& wide = draw_data->edge_batches[2];
+  EXPECT_FALSE(first.wide);
+  EXPECT_EQ(first.base_vertex, 0u);
+  EXPECT_FALSE(second.wide);
+  EXPECT_EQ(second.base_vertex, 65535u);
+  EXPECT_TRUE(wide.wide);
+  EXPECT_EQ(wide.offset % 4, 0u);
+  EXPECT_EQ(EdgeIndices(*draw_data),
+            (std::vector<int>{0, 1, 0, 2, 1, 2, 65535, 65536, 65535, 65537,
+                              65536, 65537, 69998, 69999, 0, 69998, 0, 69999}));
+  EXPECT_EQ(draw_data->edge_count, 9u);
+}
+
+// Test: When no edge touches the first vertex range, no empty batch is
+// emitted for it.
+TEST(SceneTest, SkipsEmptyVertexRanges) {
+  std::string content;
+  for (int i = 0; i < 70000; ++i) content += "v 0 0 0\n";
+  content += "f 65537 65538 65539\nf 69998 69999 70000\n";
+  std::string filename = CreateObjFile("scene_test.obj", content);
+  s21::OBJData data;
+  data.Parse(filename);
+  std::remove(filename.c_str());
+
+  s21::Scene scene;
+  auto draw_data = scene.LoadSceneMeshData(std::move(data));
+  ASSERT_EQ(draw_data->edge_batches.size(), 1u);
+  const auto& batch = draw_data->edge_batches[0];
+  EXPECT_FALSE(batch.wide);
+  EXPECT_EQ(batch.base_vertex, 65536u);
+  EXPECT_EQ(batch.offset, 0u);
+  EXPECT_EQ(batch.count, 12u);
+  EXPECT_EQ(EdgeIndices(*draw_data),
+            (std::vector<int>{65536, 65537, 65536, 65538, 65537, 65538,
+                              69997, 69998, 69997, 69999, 69998, 69999}));
+}
+
+// Test: Morton order keeps every edge between the same positions and brings
+// the ends of the edges closer in the vertex buffer.
+TEST(SceneTest, MortonOrderKeepsEdges) {
+  constexpr int kSide = 32;
+  std::vector<int> shuffled(kSide * kSide);
+  for (int i = 0; i < kSide * kSide; ++i) {
+    shuffled[i] = i * 337 % (kSide * kSide);
+  }
+  std::string content;
+  for (int i : shuffled) {
+    content += "v " + std::to_string(i / kSide) + " " +
+               std::to_string(i % kSide) + " 0\n";
+  }
+  std::vector<int> line(kSide * kSide);
+  for (int i = 0; i < kSide * kSide; ++i) line[shuffled[i]] = i + 1;
+  for (int i = 0; i + 1 < kSide; ++i) {
+    for (int j = 0; j + 1 < kSide; ++j) {
+      const int a = i * kSide + j;
+      content += "f " + std::to_string(line[a]) + " " +
+                 std::to_string(line[a + 1]) + " " +
+                 std::to_string(line[a + kSide]) + "\n";
+    }
+  }
+  std::string filename = CreateObjFile("scene_test.obj", content);
+
+  // Each edge as its two positions, sorted, to compare across orders.
+  auto edge_positions = [](const s21::DrawSceneData& data) {
+    std::vector<std::vector<float>> edges;
+    const std::vector<int> indices = EdgeIndices(data);
+    for (size_t i = 0; i < indices.size(); i += 2) {
+      s21::Vec3f a = data.vertices[indices[i]];
+      s21::Vec3f b = data.vertices[indices[i + 1]];
+      if (std::tie(b.x, b.y) < std::tie(a.x, a.y)) std::swap(a, b);
+      edges.push_back({a.x, a.y, b.x, b.y});
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+  };
+
+  s21::OBJData file_data;
+  file_data.Parse(filename);
+  s21::Scene file_scene;
+  auto file_order = file_scene.LoadSceneMeshData(std::move(file_data));
+  s21::OBJData morton_data;
+  morton_data.Parse(filename);
+  std::remove(filename.c_str());
+  s21::Scene morton_scene(s21::VertexLayout::kInterleaved,
+                          s21::VertexOrder::kMorton);
+  auto morton = morton_scene.LoadSceneMeshData(std::move(morton_data));
+
+  EXPECT_EQ(morton->edge_count, file_order->edge_count);
+  EXPECT_EQ(edge_positions(*morton), edge_positions(*file_order));
+  EXPECT_LT(morton->MeanIndexJump(), file_order->MeanIndexJump() / 4);
+}
+
+// Test: The CPU transform always starts from the original positions.
+TEST(SceneTest, TransformDoesNotAccumulate) {
+  std::string filename = CreateObjFile("scene_test.obj", "v 1 2 3\n");
+  s21::OBJData data;
+  data.Parse(filename);
+  std::remove(filename.c_str());
+
+  s21::Scene scene;
+  auto draw_data = scene.LoadSceneMeshData(std::move(data));
+  s21::Mat4f scale =
+      s21::TransformMatrixBuilder::CreateScaleMatrix(2.0f, 2.0f, 2.0f);
+  scene.TransformSceneMeshData(scale);
+  scene.TransformSceneMeshData(scale);
+
+  EXPECT_FLOAT_EQ(draw_data->vertices[0].x, 2.0f);
+  EXPECT_FLOAT_EQ(draw_data->vertices[0].y, 4.0f);
+  EXPECT_FLOAT_EQ(draw_data->vertices[0].z, 6.0f);
+}
+
+// Test: The coordinate-array layout transforms like the packed one.
+TEST(SceneTest, ArrayLayoutTransformDoesNotAccumulate) {
+  std::string filename =
+      CreateObjFile("scene_test.obj", "v 1 2 3\nv -1 0 4\nv 2 2 2\n");
+  s21::OBJData data;
+  data.Parse(filename);
+  std::remove(filename.c_str());
+
+  s21::Scene scene(s21::VertexLayout::kArrays);
+  auto draw_data = scene.LoadSceneMeshData(std::move(data));
+  s21::Mat4f scale =
+      s21::TransformMatrixBuilder::CreateScaleMatrix(2.0f, 2.0f, 2.0f);
+  scene.TransformSceneMeshData(scale);
+  scene.TransformSceneMeshData(scale);
+
+  ASSERT_EQ(draw_data->vertices.size(), 3u);
+  EXPECT_FLOAT_EQ(draw_data->vertices[1].x, -2.0f);
+  EXPECT_FLOAT_EQ(draw_data->vertices[1].y, 0.0f);
+  EXPECT_FLOAT_EQ(draw_data->vertices[1].z, 8.0f);
+}
+
+// Test: A batched transform commits every parameter with one notification.
+TEST(SceneTest, ApplyTransformNotifiesOnce) {
+  std::string filename = CreateObjFile("scene_test.obj", "v 1 2 3\n");
+  auto facade = s21::Facade::GetInstance();
+  facade->LoadScene(filename.c_str());
+  std::remove(filename.c_str());
+
+  int notifications = 0;
+  s21::SceneChange change = s21::SceneChange::kGeometry;
+  facade->SetSceneUpdateCallback(
+      [&](const std::shared_ptr<s21::DrawSceneData>&, s21::SceneChange kind) {
+        ++notifications;
+        change = kind;
+      });
+  s21::SceneParameters parameters;
+  parameters.SetScaleX(0.5f);
+  parameters.SetRotationY(90.0f);
+  parameters.SetLocationZ(0.25f);
+  facade->ApplyTransform(parameters);
+  facade->SetSceneUpdateCallback(nullptr);
+
+  EXPECT_EQ(notifications, 1);
+  EXPECT_EQ(change, s21::SceneChange::kTransform);
+  auto [tx, ty, tz, rx, ry, rz, sx, sy, sz] = facade->GetSceneParameters();
+  EXPECT_FLOAT_EQ(tz, 0.25f);
+  EXPECT_FLOAT_EQ(ry, parameters.GetRotationY());
+  EXPECT_FLOAT_EQ(sx, 0.5f);
+  EXPECT_FLOAT_EQ(sy, 1.0f);
+}
+
+// Test: The facade encodes 16-bit positions only when asked to.
+TEST(SceneTest, LoadEncodesQuantizedPositions) {
+  std::string filename =
+      CreateObjFile("scene_test.obj", "v 1 2 3\nv -1 0 2\nf 1 2 1\n");
+  auto facade = s21::Facade::GetInstance();
+  EXPECT_EQ(facade->LoadScene(filename.c_str())->quantized, nullptr);
+
+  facade->SetQuantizedPositions(true);
+  auto draw_data = facade->LoadScene(filename.c_str());
+  facade->SetQuantizedPositions(false);
+  std::remove(filename.c_str());
+
+  ASSERT_NE(draw_data->quantized, nullptr);
+  ASSERT_EQ(draw_data->quantized->size(), draw_data->vertices.size());
+  for (size_t i = 0; i < draw_data->vertices.size(); ++i) {
+    const s21::Vec3f decoded = draw_data->quantized->Decode(i);
+    EXPECT_NEAR(decoded.x, draw_data->vertices[i].x,
+                draw_data->quantized->MaxError() + 1e-6f);
+    EXPECT_NEAR(decoded.z, draw_data->vertices[i].z,
+                draw_data->quantized->MaxError() + 1e-6f);
+  }
+}
+
+// Test: Building the scene allocates no second copy of the geometry, and the
+// whole load peaks below three times the geometry size.
+TEST(SceneTest, LoadPeakRss) {
+  std::string content;
+  for (int i = 0; i < 1000000; ++i) {
+    content += "v " + std::to_string(i % 1000) + " 1.5 -2\n";
+  }
+  content += "f 1 2 3\n";
+  std::string filename = CreateObjFile("scene_test_large.obj", content);
+  content.clear();
+  content.shrink_to_fit();
+  const size_t geometry_bytes = 1000000 * sizeof(s21::Vec3f);
+  if (!ResetPeakRss()) GTEST_SKIP() << "Peak RSS is not available";
+
+  const size_t before_load = ReadStatusBytes("VmRSS");
+  s21::FileReader reader(s21::MeshCache::Settings{});
+  s21::OBJData data = reader.ReadFile(filename.c_str());
+  std::remove(filename.c_str());
+  // Read before the reset below, which forgets the parse peak
+  const size_t parse_peak = ReadStatusBytes("VmHWM") - before_load;
+
+  ASSERT_TRUE(ResetPeakRss());
+  const size_t before_scene = ReadStatusBytes("VmRSS");
+  s21::Scene scene;
+  auto draw_data = scene.LoadSceneMeshData(std::move(data));
+  const size_t scene_peak = ReadStatusBytes("VmHWM") - before_scene;
+  const size_t load_peak =
+      std::max(parse_peak, ReadStatusBytes("VmHWM") - before_load);
+
+  RecordProperty("GeometryKiB", static_cast<int>(geometry_bytes / 1024));
+  RecordProperty("SceneBuildPeakKiB", static_cast<int>(scene_peak / 1024));
+  RecordProperty("LoadPeakKiB", static_cast<int>(load_peak / 1024));
+  EXPECT_EQ(draw_data->vertices.size(), 1000000u);
+  EXPECT_LT(scene_peak, geometry_bytes / 4);
+  EXPECT_LT(load_peak, geometry_bytes * 3);
+}
+
+// Test: The queue returns every file in list order, failed ones with their
+// error, however the workers finish.
+TEST(SceneQueueTest, ReturnsFilesInOrder) {
+  std::vector<std::string> paths;
+  for (int i = 1; i <= 6; ++i) {
+    std::string content;
+    for (int v = 0; v < i; ++v) content += "v 0 0 " + std::to_string(v) + "\n";
+    paths.push_back(CreateObjFile("scene_queue_" + std::to_string(i) + ".obj",
+                                  content));
+  }
+  paths.insert(paths.begin() + 2, "scene_queue_missing.obj");
+
+  {
+    s21::SceneQueue queue(paths, 3, 2);
+    EXPECT_EQ(queue.size(), 7u);
+    s21::SceneQueue::Item item;
+    size_t vertices = 0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+      ASSERT_TRUE(queue.Next(item));
+      EXPECT_EQ(item.path, paths[i]);
+      if (i == 2) {
+        EXPECT_FALSE(item.data);
+        EXPECT_TRUE(item.error);
+        continue;
+      }
+      ASSERT_TRUE(item.data);
+      EXPECT_EQ(item.data->vertices.size(), ++vertices);
+    }
+    EXPECT_FALSE(queue.Next(item));
+  }
+  for (const std::string& path : paths) std::remove(path.c_str());
+}
+
+// Test: Destroying a queue before its files are taken stops the workers.
+TEST(SceneQueueTest, StopsWhenDestroyedEarly) {
+  std::string filename = CreateObjFile("scene_queue.obj", "v 1 2 3\n");
+  {
+    s21::SceneQueue queue(std::vector<std::string>(20, filename), 2, 4);
+    s21::SceneQueue::Item item;
+    ASSERT_TRUE(queue.Next(item));
+    EXPECT_TRUE(item.data);
+  }
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,57 @@
+#include "buffer_stream.h"
+
+#include <algorithm>
+
+BufferStream::BufferStream(QOpenGLBuffer::Type type) : buffer_(type) {}
+
+void BufferStream::Create() {
+  if (!buffer_.isCreated()) buffer_.create();
+  // A new buffer has no store yet
+  uploaded_ = 0;
+  allocated_ = false;
+}
+
+void BufferStream::Destroy() {
+  buffer_.destroy();
+  uploaded_ = 0;
+  allocated_ = false;
+}
+
+bool BufferStream::Start(const void *data, qint64 bytes,
+                         std::shared_ptr<const void> owner) {
+  if (bytes > kMaxBytes) {
+    Clear();
+    return false;
+  }
+  data_ = static_cast<const char *>(data);
+  bytes_ = bytes;
+  uploaded_ = 0;
+  allocated_ = false;
+  owner_ = std::move(owner);
+  return true;
+}
+
+void BufferStream::Clear() {
+  data_ = nullptr;
+  bytes_ = 0;
+  uploaded_ = 0;
+  owner_.reset();
+}
+
+qint64 BufferStream::Upload(qint64 budget) {
+  if (!buffer_.isCreated() || Done()) return 0;
+
+  // Start() keeps every size and offset below kMaxBytes, so they fit an int
+  buffer_.bind();
+  if (!allocated_) {
+    // Orphans the old store: the driver hands out a fresh one instead of
+    // waiting for queued draws that still read the old contents
+    buffer_.allocate(static_cast<int>(bytes_));
+    allocated_ = true;
+  }
+  const qint64 slice = std::min(budget, bytes_ - uploaded_);
+  buffer_.write(static_cast<int>(uploaded_), data_ + uploaded_,
+                static_cast<int>(slice));
+  uploaded_ += slice;
+  return slice;
+}
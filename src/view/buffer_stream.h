@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QOpenGLBuffer>
+#include <limits>
+#include <memory>
+
+/**
+ * @class BufferStream
+ * @brief Uploads the contents of an OpenGL buffer in slices across frames.
+ *
+ * Uploading a large model in one call blocks the GUI thread until the driver
+ * has copied every byte. A stream instead orphans the buffer when new data is
+ * started, so frames still reading the old store do not stall the upload, and
+ * then writes at most a given number of bytes per call. The caller draws only
+ * what is already uploaded and calls Upload() again on the next frame until
+ * Done().
+ *
+ * The stream keeps the source alive while it is being uploaded. All calls but
+ * the accessors need the OpenGL context of the buffer to be current.
+ */
+class BufferStream {
+ public:
+  /// Largest data a stream takes: QOpenGLBuffer sizes and offsets are ints
+  static constexpr qint64 kMaxBytes = std::numeric_limits<int>::max();
+
+  /**
+   * @brief Constructs a stream for a buffer that is not created yet.
+   * @param type Target the buffer is bound to.
+   */
+  explicit BufferStream(QOpenGLBuffer::Type type);
+
+  /**
+   * @brief Creates the buffer in the current context.
+   *
+   * Data started before is uploaded again from its beginning.
+   */
+  void Create();
+
+  /**
+   * @brief Destroys the buffer before its context goes away.
+   *
+   * The data stays referenced, so Create() in a new context restarts its
+   * upload.
+   */
+  void Destroy();
+
+  /**
+   * @brief Starts uploading new data, dropping any upload in progress.
+   * @param data First byte of the data.
+   * @param bytes Size of the data.
+   * @param owner Keeps data alive until the next Start() or Clear().
+   * @return False if the data is larger than kMaxBytes; the stream is then
+   * left without data.
+   */
+  bool Start(const void *data, qint64 bytes,
+             std::shared_ptr<const void> owner);
+
+  /**
+   * @brief Drops the data; the buffer keeps its store.
+   */
+  void Clear();
+
+  /**
+   * @brief Uploads the next slice of the data.
+   *
+   * The first slice of new data allocates the store without contents first.
+   * The buffer is left bound.
+   *
+   * @param budget Largest number of bytes to write.
+   * @return Bytes written; 0 if the upload is done.
+   */
+  qint64 Upload(qint64 budget);
+
+  /**
+   * @brief Returns the number of bytes of the data already in the buffer.
+   * @return Bytes uploaded since the data was started.
+   */
+  qint64 Uploaded() const { return uploaded_; }
+
+  /**
+   * @brief Returns the size of the data.
+   * @return Bytes passed to Start(); 0 without data.
+   */
+  qint64 Size() const { return bytes_; }
+
+  /**
+   * @brief Returns whether all of the data is in the buffer.
+   * @return True once the last slice is written.
+   */
+  bool Done() const { return uploaded_ == bytes_; }
+
+  /**
+   * @brief Returns the buffer to bind for drawing.
+   * @return The buffer object.
+   */
+  QOpenGLBuffer &Buffer() { return buffer_; }
+
+ private:
+  QOpenGLBuffer buffer_;               ///< Buffer the data is written to
+  const char *data_ = nullptr;         ///< Data being uploaded
+  qint64 bytes_ = 0;                   ///< Size of the data
+  qint64 uploaded_ = 0;                ///< Bytes of the data written so far
+  bool allocated_ = false;             ///< Whether the store holds bytes_
+  std::shared_ptr<const void> owner_;  ///< Keeps data_ alive
+};
@@ -79,8 +79,8 @@ ControlWindow::ControlWindow(QWidget* parent) : QWidget(parent) {
 }
 
 void ControlWindow::OpenFile() {
-  QString filename = QFileDialog::getOpenFileName(this, tr("Open file"), "./",
-                                                  tr("Images (*.obj)"));
+  QString filename = QFileDialog::getOpenFileName(
+      this, tr("Open file"), "./", tr("Images (*.obj *.obj.gz)"));
   if (!filename.isEmpty()) Q_EMIT signalOpenFile(filename);
 }
 
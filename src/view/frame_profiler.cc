@@ -0,0 +1,214 @@
+#include "frame_profiler.h"
+
+#include <QFile>
+#include <QOpenGLContext>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/// Names of the series, also the column names of Dump()
+constexpr const char *kSeriesNames[FrameProfiler::kSeriesCount] = {
+    "buffer_update", "uniforms",  "edges",   "vertices",
+    "cpu_frame",     "gpu_frame", "interval"};
+
+constexpr double kNan = std::numeric_limits<double>::quiet_NaN();
+
+}  // namespace
+
+void FrameProfiler::Initialize() {
+  Release();
+  QOpenGLContext *context = QOpenGLContext::currentContext();
+  if (!context || context->isOpenGLES()) return;
+  // GL_TIME_ELAPSED is core since 3.3
+  if (context->format().version() < qMakePair(3, 3) &&
+      !context->hasExtension("GL_ARB_timer_query")) {
+    return;
+  }
+  for (int i = 0; i < kQueries; ++i) {
+    Query query;
+    query.query = std::make_unique<QOpenGLTimerQuery>();
+    if (!query.query->create()) {
+      Release();
+      return;
+    }
+    queries_.push_back(std::move(query));
+  }
+}
+
+void FrameProfiler::Release() {
+  for (Query &query : queries_) query.query->destroy();
+  queries_.clear();
+  activeQuery_ = nullptr;
+}
+
+void FrameProfiler::BeginFrame() {
+  const qint64 number = frameCount_++;
+  Frame &frame = frames_[number % kWindow];
+  frame.number = number;
+  frame.ms.fill(kNan);
+  if (frameTimer_.isValid()) {
+    // A longer gap is a pause between requested frames
+    const double interval = frameTimer_.nsecsElapsed() / 1e6;
+    if (interval <= kIdleMs) frame.ms[kInterval] = interval;
+  }
+  frameTimer_.start();
+  phaseStartNs_ = 0;
+
+  // A frame finding every query still pending goes without GPU time
+  activeQuery_ = nullptr;
+  for (Query &query : queries_) {
+    if (query.frame < 0) {
+      activeQuery_ = &query;
+      break;
+    }
+  }
+  if (activeQuery_) {
+    activeQuery_->frame = number;
+    activeQuery_->query->begin();
+  }
+}
+
+void FrameProfiler::EndPhase(Series phase) {
+  if (frameCount_ == 0) return;
+  const qint64 now = frameTimer_.nsecsElapsed();
+  frames_[(frameCount_ - 1) % kWindow].ms[phase] =
+      (now - phaseStartNs_) / 1e6;
+  phaseStartNs_ = now;
+}
+
+void FrameProfiler::EndFrame() {
+  if (frameCount_ == 0) return;
+  if (activeQuery_) {
+    activeQuery_->query->end();
+    activeQuery_ = nullptr;
+  }
+  frames_[(frameCount_ - 1) % kWindow].ms[kCpuFrame] =
+      frameTimer_.nsecsElapsed() / 1e6;
+  CollectQueries();
+}
+
+FrameProfiler::Percentiles FrameProfiler::Compute(Series series) const {
+  std::vector<double> values = Values(series);
+  Percentiles result;
+  result.count = static_cast<int>(values.size());
+  if (values.empty()) return result;
+
+  std::sort(values.begin(), values.end());
+  // Nearest rank: the smallest value with at least p of the values below
+  auto rank = [&values](double p) {
+    const size_t index = static_cast<size_t>(std::ceil(p * values.size()));
+    return values[std::max<size_t>(index, 1) - 1];
+  };
+  result.p50 = rank(0.50);
+  result.p95 = rank(0.95);
+  result.p99 = rank(0.99);
+  return result;
+}
+
+double FrameProfiler::FramesPerSecond() const {
+  const std::vector<double> intervals = Values(kInterval);
+  double total = 0.0;
+  for (double ms : intervals) total += ms;
+  return total > 0.0 ? 1000.0 * intervals.size() / total : 0.0;
+}
+
+QString FrameProfiler::Summary() const {
+  QString text = QString("FPS %1\n%2%3%4%5 ms")
+                     .arg(FramesPerSecond(), 0, 'f', 1)
+                     .arg(QString(), -14)
+                     .arg(QStringLiteral("p50"), 7)
+                     .arg(QStringLiteral("p95"), 7)
+                     .arg(QStringLiteral("p99"), 7);
+  for (int s = 0; s < kSeriesCount; ++s) {
+    text += QString("\n%1").arg(QLatin1String(kSeriesNames[s]), -14);
+    const Percentiles percentiles = Compute(static_cast<Series>(s));
+    if (percentiles.count == 0) {
+      text += QString("%1").arg(QStringLiteral("n/a"), 7);
+      continue;
+    }
+    text += QString("%1%2%3")
+                .arg(percentiles.p50, 7, 'f', 2)
+                .arg(percentiles.p95, 7, 'f', 2)
+                .arg(percentiles.p99, 7, 'f', 2);
+  }
+  return text;
+}
+
+bool FrameProfiler::Dump(const QString &path) const {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+  QTextStream out(&file);
+
+  out << "# frames: " << std::min<qint64>(frameCount_, kWindow)
+      << ", fps: " << FramesPerSecond()
+      << ", gpu timer: " << (HasGpuTimer() ? "yes" : "no") << '\n';
+  out << "series,p50_ms,p95_ms,p99_ms,count\n";
+  for (int s = 0; s < kSeriesCount; ++s) {
+    const Percentiles p = Compute(static_cast<Series>(s));
+    out << kSeriesNames[s] << ',' << p.p50 << ',' << p.p95 << ',' << p.p99
+        << ',' << p.count << '\n';
+  }
+
+  // Frame times per bucket; the last bucket also counts longer frames
+  out << "\nbucket_ms";
+  for (int s = 0; s < kSeriesCount; ++s) out << ',' << kSeriesNames[s];
+  out << '\n';
+  std::vector<std::array<int, kSeriesCount>> histogram(kBuckets);
+  for (int s = 0; s < kSeriesCount; ++s) {
+    for (double ms : Values(static_cast<Series>(s))) {
+      const int bucket = std::min(static_cast<int>(ms / kBucketMs),
+                                  kBuckets - 1);
+      ++histogram[bucket][s];
+    }
+  }
+  for (int b = 0; b < kBuckets; ++b) {
+    out << b * kBucketMs;
+    for (int count : histogram[b]) out << ',' << count;
+    out << '\n';
+  }
+
+  // Recorded frames from the oldest; unmeasured times are left empty
+  out << "\nframe";
+  for (int s = 0; s < kSeriesCount; ++s) out << ',' << kSeriesNames[s];
+  out << '\n';
+  for (qint64 n = std::max<qint64>(frameCount_ - kWindow, 0);
+       n < frameCount_; ++n) {
+    const Frame &frame = frames_[n % kWindow];
+    out << frame.number;
+    for (double ms : frame.ms) {
+      out << ',';
+      if (!std::isnan(ms)) out << ms;
+    }
+    out << '\n';
+  }
+  return out.status() == QTextStream::Ok;
+}
+
+FrameProfiler::Frame *FrameProfiler::Find(qint64 number) {
+  Frame &frame = frames_[number % kWindow];
+  return frame.number == number ? &frame : nullptr;
+}
+
+std::vector<double> FrameProfiler::Values(Series series) const {
+  std::vector<double> values;
+  values.reserve(kWindow);
+  for (const Frame &frame : frames_) {
+    if (frame.number >= 0 && !std::isnan(frame.ms[series])) {
+      values.push_back(frame.ms[series]);
+    }
+  }
+  return values;
+}
+
+void FrameProfiler::CollectQueries() {
+  for (Query &query : queries_) {
+    if (query.frame < 0 || !query.query->isResultAvailable()) continue;
+    // Available results return without waiting
+    const GLuint64 ns = query.query->waitForResult();
+    if (Frame *frame = Find(query.frame)) frame->ms[kGpuFrame] = ns / 1e6;
+    query.frame = -1;
+  }
+}
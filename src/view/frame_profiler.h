@@ -0,0 +1,176 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QOpenGLTimerQuery>
+#include <QString>
+#include <array>
+#include <memory>
+#include <vector>
+
+/**
+ * @class FrameProfiler
+ * @brief Measures where the time of each drawn frame goes.
+ *
+ * The viewport marks the end of every phase of paintGL(); the profiler keeps
+ * the CPU time of each phase, of the whole frame and the interval between
+ * frames for the last kWindow frames. Where the context supports
+ * GL_TIME_ELAPSED queries, the GPU time of the frame's commands is measured
+ * too. Query results are collected a few frames later, when they are
+ * available, so measuring never waits for the GPU; a frame whose query is
+ * still pending gets no GPU time. Software rasterizers such as Mesa's
+ * llvmpipe support the queries; without them the GPU series stays empty.
+ *
+ * Frames are only drawn on request, so a pause between interactions would
+ * show up as one long interval. Intervals longer than kIdleMs are therefore
+ * not recorded, and the frame rate covers back-to-back frames only.
+ */
+class FrameProfiler {
+ public:
+  /**
+   * @enum Series
+   * @brief Times recorded per frame.
+   */
+  enum Series {
+    kBufferUpdate,  ///< Level selection and buffer uploads.
+    kUniforms,      ///< Shader binding and uniform setup.
+    kEdges,         ///< Edge draw calls.
+    kVertices,      ///< Vertex draw call.
+    kCpuFrame,      ///< The whole frame on the CPU.
+    kGpuFrame,      ///< The frame's commands on the GPU.
+    kInterval,      ///< Time since the previous frame began, if not idle.
+    kSeriesCount
+  };
+
+  /**
+   * @struct Percentiles
+   * @brief Distribution of a series over the recorded frames.
+   */
+  struct Percentiles {
+    double p50 = 0.0;  ///< Median, in milliseconds.
+    double p95 = 0.0;  ///< 95th percentile, in milliseconds.
+    double p99 = 0.0;  ///< 99th percentile, in milliseconds.
+    int count = 0;     ///< Frames with a value.
+  };
+
+  /// Number of most recent frames kept
+  static constexpr int kWindow = 600;
+  /// Longest interval between frames that is not idle time, in milliseconds
+  static constexpr double kIdleMs = 100.0;
+
+  /**
+   * @brief Creates the GPU timer queries in the current context.
+   *
+   * Leaves GPU timing off if the context does not support the queries.
+   */
+  void Initialize();
+
+  /**
+   * @brief Destroys the GPU timer queries; the context must be current.
+   */
+  void Release();
+
+  /**
+   * @brief Returns whether GPU times are measured.
+   * @return True if timer queries were created.
+   */
+  bool HasGpuTimer() const { return !queries_.empty(); }
+
+  /**
+   * @brief Starts measuring a frame.
+   */
+  void BeginFrame();
+
+  /**
+   * @brief Ends a phase of the current frame.
+   *
+   * The phase lasts from the previous mark, or the start of the frame.
+   *
+   * @param phase One of kBufferUpdate to kVertices.
+   */
+  void EndPhase(Series phase);
+
+  /**
+   * @brief Ends the current frame and collects finished GPU times.
+   */
+  void EndFrame();
+
+  /**
+   * @brief Computes the distribution of a series over the recorded frames.
+   * @param series The series.
+   * @return Its percentiles; all 0 without values.
+   */
+  Percentiles Compute(Series series) const;
+
+  /**
+   * @brief Returns the mean frame rate over the recorded frames.
+   * @return Frames per second over the intervals of at most kIdleMs; 0
+   * without such an interval.
+   */
+  double FramesPerSecond() const;
+
+  /**
+   * @brief Formats the current statistics for the overlay.
+   * @return One line per series with its last value and percentiles.
+   */
+  QString Summary() const;
+
+  /**
+   * @brief Writes the statistics, a histogram and the recorded frames.
+   * @param path File to write.
+   * @return False if the file cannot be written.
+   */
+  bool Dump(const QString &path) const;
+
+ private:
+  /// Number of GPU queries in flight at most
+  static constexpr int kQueries = 4;
+  /// Width of a histogram bucket in Dump(), in milliseconds
+  static constexpr double kBucketMs = 1.0;
+  /// Number of histogram buckets; the last also holds longer frames
+  static constexpr int kBuckets = 50;
+
+  /**
+   * @struct Frame
+   * @brief Times of one frame; NaN where a time was not measured.
+   */
+  struct Frame {
+    qint64 number = -1;                     ///< Frame number; -1 if unused
+    std::array<double, kSeriesCount> ms{};  ///< Times in milliseconds
+  };
+
+  /**
+   * @struct Query
+   * @brief A GPU timer query and the frame it measures.
+   */
+  struct Query {
+    std::unique_ptr<QOpenGLTimerQuery> query;  ///< The query
+    qint64 frame = -1;                         ///< Frame measured; -1 if free
+  };
+
+  /// Records of the last kWindow frames, frame n at n % kWindow
+  std::vector<Frame> frames_ = std::vector<Frame>(kWindow);
+  qint64 frameCount_ = 0;         ///< Frames begun so far
+  QElapsedTimer frameTimer_;      ///< Runs since the current frame began
+  qint64 phaseStartNs_ = 0;       ///< End of the previous phase
+  std::vector<Query> queries_;    ///< GPU timer queries
+  Query *activeQuery_ = nullptr;  ///< Query of the current frame, if any
+
+  /**
+   * @brief Returns the record of a frame if it is still in the window.
+   * @param number Frame number.
+   * @return The record, or nullptr.
+   */
+  Frame *Find(qint64 number);
+
+  /**
+   * @brief Copies the measured values of a series.
+   * @param series The series.
+   * @return Values of the recorded frames in milliseconds, in any order.
+   */
+  std::vector<double> Values(Series series) const;
+
+  /**
+   * @brief Stores the results of the finished GPU queries.
+   */
+  void CollectQueries();
+};
@@ -0,0 +1,27 @@
+#include "frame_scheduler.h"
+
+FrameScheduler::FrameScheduler(QObject *parent) : QObject(parent) {
+  timer_.setSingleShot(true);
+  timer_.setTimerType(Qt::PreciseTimer);
+  timer_.setInterval(kFrameIntervalMs);
+  connect(&timer_, &QTimer::timeout, this, &FrameScheduler::Flush);
+}
+
+void FrameScheduler::Request(int changes) {
+  if (changes == kNone) return;
+
+  ++stats_.events;
+  // A request adding nothing new is served by the pending frame
+  if ((pending_ & changes) == changes) ++stats_.coalesced;
+  pending_ |= changes;
+  if (!timer_.isActive()) timer_.start();
+}
+
+void FrameScheduler::Flush() {
+  if (pending_ == kNone) return;
+
+  const int changes = pending_;
+  pending_ = kNone;
+  ++stats_.frames;
+  Q_EMIT signalFrame(changes);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+
+/**
+ * @class FrameScheduler
+ * @brief Collects view changes and hands them out at most once per frame.
+ *
+ * Sliders, mouse drags and style widgets can report several changes within
+ * one display frame. The scheduler merges them into a set of pending
+ * changes and emits that set once when the frame interval ends, so the
+ * receiver applies the transformation, recomputes the projection and paints
+ * only once per frame.
+ */
+class FrameScheduler : public QObject {
+  Q_OBJECT
+
+ public:
+  /**
+   * @enum Change
+   * @brief Kinds of pending work, combined as bit flags.
+   */
+  enum Change {
+    kNone = 0,             ///< Nothing to do.
+    kTransform = 1 << 0,   ///< Scene parameters changed.
+    kProjection = 1 << 1,  ///< Projection mode or aspect ratio changed.
+    kPaint = 1 << 2,       ///< Only display settings changed.
+  };
+
+  /**
+   * @struct Stats
+   * @brief Counters of the scheduler since it was created.
+   */
+  struct Stats {
+    qint64 events = 0;     ///< Change requests received.
+    qint64 frames = 0;     ///< Frames emitted.
+    qint64 coalesced = 0;  ///< Requests already covered by a pending frame.
+  };
+
+  /**
+   * @brief Constructs a scheduler with an idle frame timer.
+   *
+   * @param parent Pointer to the parent object (default is nullptr).
+   */
+  explicit FrameScheduler(QObject *parent = nullptr);
+
+  /**
+   * @brief Adds changes to the next frame, starting it if none is pending.
+   *
+   * @param changes A combination of Change flags.
+   */
+  void Request(int changes);
+
+  /**
+   * @brief Returns the counters.
+   *
+   * @return Events received, frames emitted and coalesced requests.
+   */
+  const Stats &GetStats() const { return stats_; }
+
+ Q_SIGNALS:
+  /**
+   * @brief Signal emitted once per frame with the changes collected for it.
+   *
+   * @param changes A combination of Change flags, never kNone.
+   */
+  void signalFrame(int changes);
+
+ private:
+  /// Frame length in milliseconds, about one frame of a 60 Hz display
+  static constexpr int kFrameIntervalMs = 16;
+
+  QTimer timer_;         ///< Ends the current frame
+  int pending_ = kNone;  ///< Changes collected for the current frame
+  Stats stats_;          ///< Counters
+
+  /**
+   * @brief Emits the pending changes and clears them.
+   */
+  void Flush();
+};
@@ -20,37 +20,37 @@ MainWindow::MainWindow(std::shared_ptr<s21::Controller> ctrl, QWidget *parent)
           &MainWindow::SaveUserSettings);
 
   // Location coordinates
-  connect(
-      locationSlidersBox_, &SlidersBox::signalChangeX, this,
-      [this](int value) { slotTransform(TransformType::LocationX, value); });
-  connect(
-      locationSlidersBox_, &SlidersBox::signalChangeY, this,
-      [this](int value) { slotTransform(TransformType::LocationY, value); });
-  connect(
-      locationSlidersBox_, &SlidersBox::signalChangeZ, this,
-      [this](int value) { slotTransform(TransformType::LocationZ, value); });
-  connect(controlWindow_, &ControlWindow::signalChangeMoveCoords,
-          locationSlidersBox_, &SlidersBox::SetCoords);
+  connect(locationSlidersBox_, &SlidersBox::signalChangeX, this,
+          &MainWindow::slotTransform);
+  connect(locationSlidersBox_, &SlidersBox::signalChangeY, this,
+          &MainWindow::slotTransform);
+  connect(locationSlidersBox_, &SlidersBox::signalChangeZ, this,
+          &MainWindow::slotTransform);
+  connect(controlWindow_, &ControlWindow::signalChangeMoveCoords, this,
+          [this](std::pair<int, int> shift) {
+            DragTransform(locationSlidersBox_, shift);
+          });
 
   // scale coordinates
   connect(scaleSlidersBox_, &SlidersBox::signalChangeX, this,
-          [this](int value) { slotTransform(TransformType::Scale, value); });
-  connect(controlWindow_, &ControlWindow::signalChangeScaleCoords,
-          scaleSlidersBox_, &SlidersBox::SetCoords);
+          &MainWindow::slotTransform);
+  connect(controlWindow_, &ControlWindow::signalChangeScaleCoords, this,
+          [this](std::pair<int, int> shift) {
+            DragTransform(scaleSlidersBox_, shift);
+          });
 
   // rotate coordinates
 
-  connect(
-      rotateSlidersBox_, &SlidersBox::signalChangeX, this,
-      [this](int value) { slotTransform(TransformType::RotationX, value); });
-  connect(
-      rotateSlidersBox_, &SlidersBox::signalChangeY, this,
-      [this](int value) { slotTransform(TransformType::RotationY, value); });
-  connect(
-      rotateSlidersBox_, &SlidersBox::signalChangeZ, this,
-      [this](int value) { slotTransform(TransformType::RotationZ, value); });
-  connect(controlWindow_, &ControlWindow::signalChangeRotateCoords,
-          rotateSlidersBox_, &SlidersBox::SetCoords);
+  connect(rotateSlidersBox_, &SlidersBox::signalChangeX, this,
+          &MainWindow::slotTransform);
+  connect(rotateSlidersBox_, &SlidersBox::signalChangeY, this,
+          &MainWindow::slotTransform);
+  connect(rotateSlidersBox_, &SlidersBox::signalChangeZ, this,
+          &MainWindow::slotTransform);
+  connect(controlWindow_, &ControlWindow::signalChangeRotateCoords, this,
+          [this](std::pair<int, int> shift) {
+            DragTransform(rotateSlidersBox_, shift);
+          });
 
   // vertex prop
   connect(verticesBox_, &ElemBox::signalChangeType, this,
@@ -73,11 +73,25 @@ MainWindow::MainWindow(std::shared_ptr<s21::Controller> ctrl, QWidget *parent)
   // perspective
   connect(perspectiveProj_, &QRadioButton::clicked, this, [this]() {
     userSetting_->SetProjection(false);
-    renderWindow_->Repaint();
+    frameScheduler_->Request(FrameScheduler::kProjection);
   });
   connect(parallelProj_, &QRadioButton::clicked, this, [this]() {
     userSetting_->SetProjection(true);
-    renderWindow_->Repaint();
+    frameScheduler_->Request(FrameScheduler::kProjection);
+  });
+  // Also toggled when restored or reset settings change the format
+  connect(quantizedPositions_, &QCheckBox::toggled, this, [this](bool checked) {
+    userSetting_->SetQuantizedPositions(checked);
+    controller_->SetQuantizedPositions(checked);
+    renderWindow_->ReloadBuffers();
+  });
+  connect(spatialOrder_, &QCheckBox::toggled, this, [this](bool checked) {
+    userSetting_->SetSpatialOrder(checked);
+    controller_->SetSpatialOrder(checked);
+  });
+  connect(timingOverlay_, &QCheckBox::toggled, this, [this](bool checked) {
+    userSetting_->SetTimingOverlay(checked);
+    frameScheduler_->Request(FrameScheduler::kPaint);
   });
 
   // Work with file
@@ -132,71 +146,83 @@ void MainWindow::ResetCoords() {
 void MainWindow::slotBackgroundColor(const QColor &color) {
   userSetting_->SetBackgroundColor(color);
 
-  renderWindow_->update();
+  frameScheduler_->Request(FrameScheduler::kPaint);
 }
 
 void MainWindow::slotVerticesColor(const QColor &color) {
   userSetting_->SetVerticesColor(color);
 
-  renderWindow_->update();
+  frameScheduler_->Request(FrameScheduler::kPaint);
 }
 
 void MainWindow::slotVerticesType(const QString &text) {
   userSetting_->SetVerticesType(text);
 
-  renderWindow_->update();
+  frameScheduler_->Request(FrameScheduler::kPaint);
 }
 
 void MainWindow::slotVerticesSize(const int value) {
   userSetting_->SetVerticesSize(value);
 
-  renderWindow_->update();
+  frameScheduler_->Request(FrameScheduler::kPaint);
 }
 
 void MainWindow::slotEdgesColor(const QColor &color) {
   userSetting_->SetEdgesColor(color);
 
-  renderWindow_->update();
+  frameScheduler_->Request(FrameScheduler::kPaint);
 }
 
 void MainWindow::slotEdgesType(const QString &text) {
   userSetting_->SetEdgesType(text);
 
-  renderWindow_->update();
+  frameScheduler_->Request(FrameScheduler::kPaint);
 }
 
 void MainWindow::slotEdgesSize(const int value) {
   userSetting_->SetEdgesSize(value);
 
-  renderWindow_->update();
+  frameScheduler_->Request(FrameScheduler::kPaint);
 }
 
-void MainWindow::slotTransform(TransformType type, int value) {
-  switch (type) {
-    case TransformType::LocationX:
-      controller_->SetLocationX(value);
-      break;
-    case TransformType::LocationY:
-      controller_->SetLocationY(value);
-      break;
-    case TransformType::LocationZ:
-      controller_->SetLocationZ(value);
-      break;
-    case TransformType::RotationX:
-      controller_->SetRotationX(value);
-      break;
-    case TransformType::RotationY:
-      controller_->SetRotationY(value);
-      break;
-    case TransformType::RotationZ:
-      controller_->SetRotationZ(value);
-      break;
-    case TransformType::Scale:
-      controller_->SetScaleX(value);
-      break;
+void MainWindow::slotTransform() {
+  // The sliders hold the new value; the next frame applies all of them.
+  frameScheduler_->Request(FrameScheduler::kTransform);
+}
+
+s21::TransformValues MainWindow::SliderTransform() const {
+  const std::array<int, 3> location = locationSlidersBox_->GetCoords();
+  const std::array<int, 3> rotation = rotateSlidersBox_->GetCoords();
+  s21::TransformValues values;
+  values.scale = scaleSlidersBox_->GetCoords()[0];
+  values.rotation_x = rotation[0];
+  values.rotation_y = rotation[1];
+  values.rotation_z = rotation[2];
+  values.location_x = location[0];
+  values.location_y = location[1];
+  values.location_z = location[2];
+  return values;
+}
+
+void MainWindow::DragTransform(SlidersBox *box, std::pair<int, int> shift) {
+  {
+    // Each moved slider would otherwise transform the scene on its own
+    const QSignalBlocker blocker(box);
+    box->SetCoords(shift);
+  }
+  frameScheduler_->Request(FrameScheduler::kTransform);
+}
+
+void MainWindow::ApplyFrame(int changes) {
+  // One controller call and one paint for everything changed in the frame
+  if (changes & FrameScheduler::kTransform) {
+    controller_->ApplyTransform(SliderTransform());
+  }
+  if (changes & FrameScheduler::kProjection) {
+    renderWindow_->Repaint();
+  } else {
+    renderWindow_->update();
   }
-  renderWindow_->UpdateModelMatrix();
-  renderWindow_->update();
 }
 
 void MainWindow::SetupUI() {
@@ -211,6 +237,9 @@ void MainWindow::SetupUI() {
   QGridLayout *mainLayout = new QGridLayout();
   mainLayout->setContentsMargins(0, 0, 0, 0);
   renderWindow_ = new Viewport3D(userSetting_, this);
+  frameScheduler_ = new FrameScheduler(this);
+  connect(frameScheduler_, &FrameScheduler::signalFrame, this,
+          &MainWindow::ApplyFrame);
   controlWindow_ = new ControlWindow(this);
   mainLayout->addWidget(renderWindow_);
   mainLayout->addWidget(controlWindow_, 0, 0);
@@ -243,9 +272,14 @@ void MainWindow::SetupUI() {
 
   // Connect controller's scene update callback to viewport
   controller_->SetSceneUpdateCallback(
-      [this](const std::shared_ptr<s21::DrawSceneData> &sceneData) {
-        // This will be called whenever the scene is transformed
-        renderWindow_->SetScene(sceneData);
+      [this](const std::shared_ptr<s21::DrawSceneData> &sceneData,
+             s21::SceneChange change) {
+        // Transforms only update the model matrix, not the GPU buffers
+        renderWindow_->SetScene(sceneData, change);
+      });
+  controller_->SetLodReadyCallback(
+      [this](const std::shared_ptr<const s21::LodChain> &lods) {
+        renderWindow_->SetLods(lods);
       });
 }
 
@@ -270,6 +304,26 @@ void MainWindow::CreateDockWidgets() {
   QVBoxLayout *projLayout = new QVBoxLayout();
   projLayout->addWidget(perspectiveProj_);
   projLayout->addWidget(parallelProj_);
+  quantizedPositions_ = new QCheckBox("16-bit positions", this);
+  quantizedPositions_->setToolTip(
+      "Halves GPU memory for vertices at a small loss of precision; "
+      "applies to files opened from now on");
+  quantizedPositions_->setChecked(userSetting_->IsQuantizedPositions());
+  controller_->SetQuantizedPositions(userSetting_->IsQuantizedPositions());
+  projLayout->addWidget(quantizedPositions_);
+  spatialOrder_ = new QCheckBox("Spatial vertex order", this);
+  spatialOrder_->setToolTip(
+      "Sorts the vertices of files opened from now on by position, so edges "
+      "reference nearby memory");
+  spatialOrder_->setChecked(userSetting_->IsSpatialOrder());
+  controller_->SetSpatialOrder(userSetting_->IsSpatialOrder());
+  projLayout->addWidget(spatialOrder_);
+  timingOverlay_ = new QCheckBox("Frame timings", this);
+  timingOverlay_->setToolTip(
+      "Shows CPU time per drawing phase, GPU time and frame rate over the "
+      "scene");
+  timingOverlay_->setChecked(userSetting_->IsTimingOverlay());
+  projLayout->addWidget(timingOverlay_);
   projBox->setLayout(projLayout);
   (userSetting_->IsParallelProjection()) ? parallelProj_->setChecked(true)
                                          : perspectiveProj_->setChecked(true);
@@ -339,8 +393,41 @@ void MainWindow::CreateStatusBar() {
 
   sceneInfoWindow_ = new InfoWindow(this);
 
+  loadProgress_ = new QProgressBar(propBox);
+  loadProgress_->setFixedWidth(200);
+  loadProgress_->hide();
+
+  cancelLoadButton_ = new QPushButton("Cancel", propBox);
+  cancelLoadButton_->setFixedSize(80, 30);
+  cancelLoadButton_->hide();
+  connect(cancelLoadButton_, &QPushButton::clicked, this,
+          [this]() { controller_->CancelLoad(); });
+
+  uploadInfo_ = new QLabel(propBox);
+  uploadInfo_->setMinimumWidth(200);
+  connect(renderWindow_, &Viewport3D::signalFrameUploaded, this,
+          &MainWindow::ShowUploadStats);
+  // Queued, so the message box does not open in the middle of painting
+  connect(
+      renderWindow_, &Viewport3D::signalUploadRejected, this,
+      [this](const QString &message) {
+        QMessageBox::warning(this, tr("Unable to draw model"), message);
+      },
+      Qt::QueuedConnection);
+
+  saveTimingsButton_ = new QPushButton("Save timings", propBox);
+  saveTimingsButton_->setFixedSize(100, 30);
+  saveTimingsButton_->setToolTip(
+      "Writes percentiles, a histogram and the times of the recent frames");
+  connect(saveTimingsButton_, &QPushButton::clicked, this,
+          &MainWindow::SaveFrameTimings);
+
   propBox->addPermanentWidget(fileNameLabel);
   propBox->addPermanentWidget(filenameInfo_);
+  propBox->addPermanentWidget(loadProgress_);
+  propBox->addPermanentWidget(cancelLoadButton_);
+  propBox->addPermanentWidget(uploadInfo_);
+  propBox->addPermanentWidget(saveTimingsButton_);
   propBox->addPermanentWidget(sceneInfoButton_);
 
   setStatusBar(propBox);
@@ -350,14 +437,102 @@ void MainWindow::CreateStatusBar() {
 void MainWindow::LoadScene(QString &fname) {
   if (fname.isEmpty()) return;
 
-  ResetCoords();
+  ShowLoadProgress(s21::LoadProgress{});
+  loadProgress_->show();
+  cancelLoadButton_->show();
+
+  const QString filename = fname;
+  controller_->LoadSceneAsync(
+      fname.toUtf8().data(),
+      [this](std::function<void()> task) {
+        // Runs the task in the GUI thread's event loop.
+        QMetaObject::invokeMethod(this, std::move(task), Qt::QueuedConnection);
+      },
+      [this](const s21::LoadProgress &progress) { ShowLoadProgress(progress); },
+      [this, filename](const std::shared_ptr<s21::DrawSceneData> &scene,
+                       std::exception_ptr error) {
+        FinishLoading(filename, scene, error);
+      });
+}
+
+void MainWindow::ShowLoadProgress(const s21::LoadProgress &progress) {
+  switch (progress.stage) {
+    case s21::LoadProgress::Stage::kParsing:
+      loadProgress_->setRange(0, 100);
+      loadProgress_->setValue(progress.bytes_total
+                                  ? static_cast<int>(progress.bytes_parsed *
+                                                     100 / progress.bytes_total)
+                                  : 0);
+      loadProgress_->setFormat(tr("Parsing %p%"));
+      break;
+    case s21::LoadProgress::Stage::kNormalizing:
+      loadProgress_->setRange(0, 0);
+      loadProgress_->setFormat(tr("Normalizing"));
+      break;
+    case s21::LoadProgress::Stage::kBuildingEdges:
+      loadProgress_->setRange(0, 0);
+      loadProgress_->setFormat(tr("Building edges"));
+      break;
+  }
+}
+
+void MainWindow::ShowUploadStats(qint64 bytes) {
+  QString text = tr("GPU upload: %1 KB (total %2 MB)")
+                     .arg(bytes / 1024)
+                     .arg(renderWindow_->TotalUploadBytes() / (1024 * 1024));
+  const double progress = renderWindow_->UploadProgress();
+  if (progress < 1.0) {
+    text += tr(", streaming %1%").arg(static_cast<int>(progress * 100));
+  }
+  uploadInfo_->setText(text);
+
+  const FrameScheduler::Stats &stats = frameScheduler_->GetStats();
+  QString tooltip = tr("Events: %1\nScheduled frames: %2\n"
+                       "Coalesced updates: %3\nFrames rendered: %4")
+                        .arg(stats.events)
+                        .arg(stats.frames)
+                        .arg(stats.coalesced)
+                        .arg(renderWindow_->FramesRendered());
+  if (renderWindow_->IsQuantized()) {
+    tooltip += tr("\n16-bit positions, max error: %1")
+                   .arg(renderWindow_->QuantizationError(), 0, 'g', 3);
+  }
+  if (renderWindow_->LodCount() > 1) {
+    tooltip += tr("\nLevel of detail: %1 of %2 (%3 triangles)")
+                   .arg(renderWindow_->CurrentLod())
+                   .arg(renderWindow_->LodCount() - 1)
+                   .arg(renderWindow_->LodTriangles());
+  }
+  uploadInfo_->setToolTip(tooltip);
+}
+
+void MainWindow::SaveFrameTimings() {
+  const QString fname = QFileDialog::getSaveFileName(
+      this, tr("Save frame timings"), "frame_timings.csv", "CSV (*.csv)");
+  if (fname.isEmpty()) return;
+
+  if (!renderWindow_->Profiler().Dump(fname)) {
+    QMessageBox::warning(this, tr("Unable to save file"),
+                         tr("Cannot write %1").arg(fname));
+  }
+}
+
+void MainWindow::FinishLoading(const QString &fname,
+                               const std::shared_ptr<s21::DrawSceneData> &scene,
+                               std::exception_ptr error) {
+  loadProgress_->hide();
+  cancelLoadButton_->hide();
+
   try {
-    auto scene = controller_->LoadScene(fname.toUtf8().data());
-    renderWindow_->SetScene(scene);
+    if (error) std::rethrow_exception(error);
+    ResetCoords();
+    renderWindow_->SetScene(scene, s21::SceneChange::kGeometry);
     renderWindow_->Repaint();
     filenameInfo_->setText(fname);
     sceneInfoWindow_->SetText(QString::fromStdString(scene->info));
-  } catch (const s21::MeshLoadException &e) {
+  } catch (const s21::LoadCancelledException &) {
+    // The previous scene stays on screen.
+  } catch (const std::exception &e) {
     QMessageBox::warning(this, tr("Unable to open file"), e.what());
   }
 }
@@ -424,17 +599,15 @@ void MainWindow::SaveCycledGif(QString &fname) {
   renderWindow_->ChangeAspectRatio(false);
 
   for (int i = 1; i <= 25; ++i) {
-    controller_->SetScaleX(scaleX.first += scaleX.second);
-
-    controller_->SetRotationX(rotateX.first += rotateX.second);
-    controller_->SetRotationY(rotateY.first += rotateY.second);
-    controller_->SetRotationZ(rotateZ.first += rotateZ.second);
-
-    controller_->SetLocationX(locationX.first += locationX.second);
-    controller_->SetLocationY(locationY.first += locationY.second);
-    controller_->SetLocationZ(locationZ.first += locationZ.second);
-
-    renderWindow_->update();
+    s21::TransformValues frame;
+    frame.scale = scaleX.first += scaleX.second;
+    frame.rotation_x = rotateX.first += rotateX.second;
+    frame.rotation_y = rotateY.first += rotateY.second;
+    frame.rotation_z = rotateZ.first += rotateZ.second;
+    frame.location_x = locationX.first += locationX.second;
+    frame.location_y = locationY.first += locationY.second;
+    frame.location_z = locationZ.first += locationZ.second;
+    controller_->ApplyTransform(frame);
 
     renderWindow_->ChangeAspectRatio(true);
     screens_[i] = renderWindow_->grab();
@@ -479,6 +652,7 @@ void MainWindow::RestoreUserSettings() {
 void MainWindow::SaveUserSettings() { userSetting_->SaveRenderSettings(); }
 
 void MainWindow::closeEvent(QCloseEvent *event) {
+  controller_->CancelLoad();
   userSetting_->SaveRenderSettings();
   QMainWindow::closeEvent(event);
 }
@@ -498,4 +672,7 @@ void MainWindow::SetVisualParameters() {
 
   (userSetting_->IsParallelProjection()) ? parallelProj_->setChecked(true)
                                          : perspectiveProj_->setChecked(true);
+  quantizedPositions_->setChecked(userSetting_->IsQuantizedPositions());
+  spatialOrder_->setChecked(userSetting_->IsSpatialOrder());
+  timingOverlay_->setChecked(userSetting_->IsTimingOverlay());
 }
\ No newline at end of file
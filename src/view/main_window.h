@@ -1,14 +1,18 @@
 #pragma once
 
+#include <QCheckBox>
 #include <QDockWidget>
+#include <QFileDialog>
 #include <QGroupBox>
 #include <QImage>
 #include <QLayout>
 #include <QMainWindow>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QProgressBar>
 #include <QRadioButton>
 #include <QSettings>
+#include <QSignalBlocker>
 #include <QStatusBar>
 #include <QString>
 #include <QTimer>
@@ -18,26 +22,13 @@
 #include "control_window.h"
 #include "controller.h"
 #include "elem_box.h"
+#include "frame_scheduler.h"
 #include "gif/gif.h"
 #include "info_window.h"
 #include "sliders_box.h"
 #include "user_setting.h"
 #include "viewport3D.h"
 
-/**
- * @enum TransformType
- * @brief Enum representing different types of transformations.
- */
-enum class TransformType {
-  LocationX,  ///< Transformation along the X-axis
-  LocationY,  ///< Transformation along the Y-axis
-  LocationZ,  ///< Transformation along the Z-axis
-  RotationX,  ///< Rotation around the X-axis
-  RotationY,  ///< Rotation around the Y-axis
-  RotationZ,  ///< Rotation around the Z-axis
-  Scale       ///< Scaling transformation
-};
-
 /**
  * @class MainWindow
  * @brief The main application window for the 3D viewer.
@@ -63,10 +54,11 @@ class MainWindow : public QMainWindow {
   /**
    * @brief Slot to handle transformations.
    *
-   * @param type The type of transformation.
-   * @param value The value for the transformation.
+   * Schedules the slider values to be applied with the next frame, so
+   * several changes within a frame cost one transformation. The sliders
+   * are read then, so the changed value is not passed.
    */
-  void slotTransform(TransformType type, int value);
+  void slotTransform();
 
   /**
    * @brief Slot to handle changes in vertices type.
@@ -154,8 +146,16 @@ class MainWindow : public QMainWindow {
       *restoreElemsButton_, *sceneInfoButton_;  ///< Buttons for various actions
   QRadioButton *perspectiveProj_,
       *parallelProj_;  ///< Radio buttons for projection type
+  QCheckBox *quantizedPositions_;  ///< Uploads 16-bit positions to the GPU
+  QCheckBox *spatialOrder_;        ///< Sorts vertices of opened files
+  QCheckBox *timingOverlay_;       ///< Draws frame timings over the scene
   InfoWindow
       *sceneInfoWindow_;  ///< Info window for displaying scene information
+  QProgressBar *loadProgress_;      ///< Progress of a running scene load
+  QPushButton *cancelLoadButton_;   ///< Cancels a running scene load
+  QLabel *uploadInfo_;              ///< GPU upload of the last frame
+  QPushButton *saveTimingsButton_;  ///< Writes the frame timings to a file
+  FrameScheduler *frameScheduler_;  ///< Merges view changes per frame
 
   // Controller
   std::shared_ptr<s21::Controller>
@@ -197,12 +197,46 @@ class MainWindow : public QMainWindow {
   void RestoreUserSettings();
 
   /**
-   * @brief Loads a scene from a specified file.
+   * @brief Starts loading a scene from a specified file.
+   *
+   * The file is loaded in the background; the current scene stays
+   * interactive until the new one is shown.
    *
    * @param fname The name of the file to load the scene from.
    */
   void LoadScene(QString &fname);
 
+  /**
+   * @brief Shows the progress of a running scene load.
+   *
+   * @param progress The latest progress report.
+   */
+  void ShowLoadProgress(const s21::LoadProgress &progress);
+
+  /**
+   * @brief Shows how much geometry the last frame uploaded to the GPU.
+   *
+   * @param bytes Bytes uploaded for the frame.
+   */
+  void ShowUploadStats(qint64 bytes);
+
+  /**
+   * @brief Asks for a file and writes the frame timings of the viewport to
+   * it.
+   */
+  void SaveFrameTimings();
+
+  /**
+   * @brief Shows a loaded scene, or the error that stopped loading it.
+   *
+   * @param fname The name of the loaded file.
+   * @param scene The loaded scene, null on error.
+   * @param error The error, null on success.
+   */
+  void FinishLoading(const QString &fname,
+                     const std::shared_ptr<s21::DrawSceneData> &scene,
+                     std::exception_ptr error);
+
   /**
    * @brief Saves the current viewport as an image.
    *
@@ -234,6 +268,31 @@ class MainWindow : public QMainWindow {
    */
   void ResetCoords();
 
+  /**
+   * @brief Collects the values of all transformation sliders.
+   *
+   * @return The slider values as one set of transformation values.
+   */
+  s21::TransformValues SliderTransform() const;
+
+  /**
+   * @brief Shifts a sliders box by a mouse drag and schedules the result.
+   *
+   * The sliders are moved without emitting their own signals, so the whole
+   * transformation is committed with a single controller call.
+   *
+   * @param box The sliders box to shift.
+   * @param shift The change of the first and second slider.
+   */
+  void DragTransform(SlidersBox *box, std::pair<int, int> shift);
+
+  /**
+   * @brief Applies the changes collected by the frame scheduler.
+   *
+   * @param changes A combination of FrameScheduler::Change flags.
+   */
+  void ApplyFrame(int changes);
+
   /**
    * @brief Creates the status bar for the application.
    */
@@ -0,0 +1,115 @@
+#include "scene_shaders.h"
+
+bool SceneShaders::Build(QOpenGLShaderProgram *program) {
+  // Vertex shader source code
+  const char *vertexShaderSource = R"(
+      #version 330 core
+      layout (location = 0) in vec3 aPos;
+
+      uniform mat4 projectionMatrix;
+      uniform mat4 viewMatrix;
+      uniform mat4 modelMatrix;
+      // Decodes quantized positions; (1, 1, 1) and 0 for float ones
+      uniform vec3 positionStep;
+      uniform vec3 positionOffset;
+      uniform float pointSize;
+
+      // Position in normalized device coordinates. A line gets the flat
+      // copy from one end and interpolates the other linearly on screen,
+      // so their difference runs along the line.
+      flat out vec2 lineStart;
+      noperspective out vec2 screenPos;
+
+      void main() {
+          vec3 pos = aPos * positionStep + positionOffset;
+          gl_Position = projectionMatrix * viewMatrix * modelMatrix * vec4(pos, 1.0);
+          screenPos = gl_Position.xy / gl_Position.w;
+          lineStart = screenPos;
+          gl_PointSize = pointSize;
+      }
+    )";
+
+  // Fragment shader source code
+  const char *fragmentShaderSource = R"(
+      #version 330 core
+      out vec4 FragColor;
+
+      uniform int renderMode; // 0 for edges, 1 for vertices
+      uniform vec4 edgeColor;
+      uniform vec4 vertexColor;
+      uniform bool dashed;
+      uniform float dashLength; // Of each dash and gap, in pixels
+      uniform vec2 viewportSize; // In pixels
+      uniform bool roundPoints;
+
+      flat in vec2 lineStart;
+      noperspective in vec2 screenPos;
+
+      void main() {
+          if (renderMode == 0) {
+              if (dashed) {
+                  float dist = length((screenPos - lineStart) * 0.5 * viewportSize);
+                  if (mod(dist, 2.0 * dashLength) >= dashLength) discard;
+              }
+              FragColor = edgeColor;
+          } else {
+              if (roundPoints) {
+                  vec2 offset = gl_PointCoord * 2.0 - 1.0;
+                  if (dot(offset, offset) > 1.0) discard;
+              }
+              FragColor = vertexColor;
+          }
+      }
+    )";
+
+  return program->addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                          vertexShaderSource) &&
+         program->addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                          fragmentShaderSource) &&
+         program->link();
+}
+
+void SceneShaders::SetEdgeStyle(QOpenGLShaderProgram *program,
+                                const UserSetting &setting,
+                                const QSizeF &viewport) {
+  program->setUniformValue("renderMode", 0);  // Edges mode
+  const QColor color = setting.GetEdgesColor();
+  program->setUniformValue("edgeColor", color.redF(), color.greenF(),
+                           color.blueF(), 1.0f);
+  program->setUniformValue(
+      "dashed", static_cast<GLint>(setting.GetEdgesType() == "dashed"));
+  program->setUniformValue("dashLength", kDashPixels);
+  program->setUniformValue("viewportSize",
+                           QVector2D(viewport.width(), viewport.height()));
+}
+
+void SceneShaders::SetVertexStyle(QOpenGLShaderProgram *program,
+                                  const UserSetting &setting) {
+  program->setUniformValue("renderMode", 1);  // Vertices mode
+  const QColor color = setting.GetVerticesColor();
+  program->setUniformValue("vertexColor", color.redF(), color.greenF(),
+                           color.blueF(), 1.0f);
+  program->setUniformValue("pointSize",
+                           static_cast<GLfloat>(setting.GetVerticesSize()));
+  program->setUniformValue(
+      "roundPoints", static_cast<GLint>(setting.GetVerticesType() == "circle"));
+}
+
+QMatrix4x4 SceneShaders::Projection(bool parallel, float aspect) {
+  QMatrix4x4 projection;
+  if (parallel) {
+    // Orthographic projection parameters
+    float size = 1.0f;
+    projection.ortho(-size * aspect, size * aspect, -size, size, 1.0f, 100.0f);
+  } else {
+    // Perspective projection parameters
+    projection.perspective(45.0f, aspect, 1.0f, 100.0f);
+  }
+  return projection;
+}
+
+QMatrix4x4 SceneShaders::Camera() {
+  QMatrix4x4 view;
+  view.translate(0.0f, 0.0f, -2.0f);
+  return view;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QMatrix4x4>
+#include <QOpenGLShaderProgram>
+#include <QSizeF>
+
+#include "user_setting.h"
+
+#ifndef GL_PROGRAM_POINT_SIZE
+#define GL_PROGRAM_POINT_SIZE 0x8642
+#endif
+
+/**
+ * @class SceneShaders
+ * @brief The shader program and camera that draw a scene.
+ *
+ * Shared by the interactive viewport and the offscreen thumbnail renderer,
+ * so a thumbnail shows a model the way the viewer does.
+ *
+ * Round vertices and dashed edges are drawn by the fragment shader instead
+ * of point smoothing and line stipple, which core profiles lack and software
+ * rasterizers handle slowly: a round point discards the fragments outside
+ * its circle, and a dashed line discards the gaps by their distance from an
+ * end of the line. Points take their size from the shader, so the context
+ * needs GL_PROGRAM_POINT_SIZE enabled.
+ */
+class SceneShaders {
+ public:
+  /**
+   * @brief Compiles and links the scene shaders into a program.
+   *
+   * The program takes positions at attribute location 0, the uniforms
+   * projectionMatrix, viewMatrix, modelMatrix, positionStep and
+   * positionOffset, and the style set by SetEdgeStyle() or SetVertexStyle().
+   *
+   * @param program Program to add the shaders to; its context must be
+   * current.
+   * @return False if compiling or linking failed; the program's log tells
+   * why.
+   */
+  static bool Build(QOpenGLShaderProgram *program);
+
+  /**
+   * @brief Sets up the program for drawing edges in the style of the
+   * settings.
+   * @param program The bound program.
+   * @param setting Edge type and color.
+   * @param viewport Size of the viewport in pixels, for dash lengths.
+   */
+  static void SetEdgeStyle(QOpenGLShaderProgram *program,
+                           const UserSetting &setting, const QSizeF &viewport);
+
+  /**
+   * @brief Sets up the program for drawing vertices in the style of the
+   * settings.
+   * @param program The bound program.
+   * @param setting Vertex type, color and size.
+   */
+  static void SetVertexStyle(QOpenGLShaderProgram *program,
+                             const UserSetting &setting);
+
+  /**
+   * @brief Returns the projection of the viewer.
+   * @param parallel True for the orthographic projection, false for the
+   * perspective one.
+   * @param aspect Width of the image divided by its height.
+   * @return The projection matrix.
+   */
+  static QMatrix4x4 Projection(bool parallel, float aspect);
+
+  /**
+   * @brief Returns the camera of the viewer.
+   * @return The view matrix, looking at the origin from a distance of 2.
+   */
+  static QMatrix4x4 Camera();
+
+ private:
+  /// Length of each dash and each gap of a dashed edge, in pixels
+  static constexpr GLfloat kDashPixels = 8.0f;
+};
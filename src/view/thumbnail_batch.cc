@@ -0,0 +1,317 @@
+#include "thumbnail_batch.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "scene_queue.h"
+#include "thumbnail_renderer.h"
+
+namespace {
+
+/**
+ * @brief Applies the style options to the settings.
+ * @param parser The parsed command line.
+ * @param setting Settings to change.
+ * @param error Receives the first invalid value.
+ * @return False if a value is invalid.
+ */
+bool ApplyStyle(const QCommandLineParser &parser, UserSetting &setting,
+                QString &error) {
+  if (parser.isSet("projection")) {
+    const QString projection = parser.value("projection");
+    if (projection != "parallel" && projection != "perspective") {
+      error = "Unknown projection: " + projection;
+      return false;
+    }
+    setting.SetProjection(projection == "parallel");
+  }
+  if (parser.isSet("edges")) {
+    const QString type = parser.value("edges");
+    if (type != "line" && type != "dashed" && type != "none") {
+      error = "Unknown edge type: " + type;
+      return false;
+    }
+    setting.SetEdgesType(type);
+  }
+  if (parser.isSet("vertices")) {
+    const QString type = parser.value("vertices");
+    if (type != "circle" && type != "square" && type != "none") {
+      error = "Unknown vertex type: " + type;
+      return false;
+    }
+    setting.SetVerticesType(type);
+  }
+
+  // Colors are any name QColor accepts, such as "white" or "#ff8000"
+  const char *colorOptions[] = {"edges-color", "vertices-color", "background"};
+  for (const char *option : colorOptions) {
+    if (!parser.isSet(option)) continue;
+    const QColor color(parser.value(option));
+    if (!color.isValid()) {
+      error = "Unknown color: " + parser.value(option);
+      return false;
+    }
+    if (std::strcmp(option, "edges-color") == 0) {
+      setting.SetEdgesColor(color);
+    } else if (std::strcmp(option, "vertices-color") == 0) {
+      setting.SetVerticesColor(color);
+    } else {
+      setting.SetBackgroundColor(color);
+    }
+  }
+
+  const char *sizeOptions[] = {"edges-size", "vertices-size"};
+  for (const char *option : sizeOptions) {
+    if (!parser.isSet(option)) continue;
+    bool ok = false;
+    const int size = parser.value(option).toInt(&ok);
+    if (!ok || size <= 0) {
+      error = "Invalid size: " + parser.value(option);
+      return false;
+    }
+    if (std::strcmp(option, "edges-size") == 0) {
+      setting.SetEdgesSize(size);
+    } else {
+      setting.SetVerticesSize(size);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Collects the files of the command line and of the list file.
+ * @param parser The parsed command line.
+ * @param paths Receives the files in order.
+ * @param error Receives why the list file cannot be read.
+ * @return False if the list file cannot be read.
+ */
+bool CollectFiles(const QCommandLineParser &parser,
+                  std::vector<std::string> &paths, QString &error) {
+  for (const QString &file : parser.positionalArguments()) {
+    paths.push_back(file.toStdString());
+  }
+  if (!parser.isSet("list")) return true;
+
+  QFile list(parser.value("list"));
+  if (!list.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    error = "Cannot read " + list.fileName();
+    return false;
+  }
+  // One file per line; empty lines and lines starting with # are skipped
+  QTextStream in(&list);
+  while (!in.atEnd()) {
+    const QString line = in.readLine().trimmed();
+    if (!line.isEmpty() && !line.startsWith('#')) {
+      paths.push_back(line.toStdString());
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Returns the base name of a model file, without `.gz` and the
+ * extension.
+ * @param path The model file.
+ * @return "part" for "dir/part.obj" and "dir/part.obj.gz".
+ */
+QString ModelName(const QString &path) {
+  QString name = QFileInfo(path).fileName();
+  if (name.endsWith(".gz", Qt::CaseInsensitive)) name.chop(3);
+  return QFileInfo(name).completeBaseName();
+}
+
+/**
+ * @brief Chooses an image file name for every model, without duplicates.
+ *
+ * Models whose names clash get the name of their directory appended, and
+ * those still clashing their position in the list, so no image overwrites
+ * another. Names are compared ignoring case, for case-insensitive file
+ * systems.
+ *
+ * @param paths The model files in order.
+ * @return The image names, in the same order.
+ */
+std::vector<QString> ImageNames(const std::vector<std::string> &paths) {
+  std::vector<QString> names;
+  for (const std::string &path : paths) {
+    names.push_back(ModelName(QString::fromStdString(path)));
+  }
+  const auto countNames = [&names]() {
+    std::unordered_map<std::string, int> counts;
+    for (const QString &name : names) ++counts[name.toLower().toStdString()];
+    return counts;
+  };
+
+  auto counts = countNames();
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (counts[names[i].toLower().toStdString()] > 1) {
+      const QString dir =
+          QFileInfo(QString::fromStdString(paths[i])).absoluteDir().dirName();
+      names[i] += '_' + dir;
+    }
+  }
+  counts = countNames();
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (counts[names[i].toLower().toStdString()] > 1) {
+      names[i] += '_' + QString::number(i + 1);
+    }
+  }
+  for (QString &name : names) name += ".png";
+  return names;
+}
+
+/**
+ * @brief Prints the draw time of a scene for every edge and vertex type.
+ * @param renderer Initialized renderer drawing with the settings.
+ * @param setting Settings of the renderer; the types are restored.
+ * @param scene The scene.
+ * @param frames Number of timed frames per combination.
+ * @param out Stream receiving one line per combination.
+ */
+void PrintStyleTimings(ThumbnailRenderer &renderer, UserSetting &setting,
+                       const s21::DrawSceneData &scene, int frames,
+                       QTextStream &out) {
+  const QString edgesType = setting.GetEdgesType();
+  const QString verticesType = setting.GetVerticesType();
+  for (const char *edges : {"line", "dashed", "none"}) {
+    for (const char *vertices : {"square", "circle", "none"}) {
+      setting.SetEdgesType(edges);
+      setting.SetVerticesType(vertices);
+      const double ms = renderer.TimeDraw(scene, frames);
+      out << "  edges " << QString(edges).leftJustified(7) << "vertices "
+          << QString(vertices).leftJustified(7) << ms << " ms/frame\n";
+    }
+  }
+  out.flush();
+  setting.SetEdgesType(edgesType);
+  setting.SetVerticesType(verticesType);
+}
+
+}  // namespace
+
+bool ThumbnailBatch::IsRequested(int argc, char *argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--thumbnails") == 0) return true;
+  }
+  return false;
+}
+
+int ThumbnailBatch::Run(const QStringList &arguments) {
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "Renders a preview image of every OBJ file without opening a window.");
+  parser.addHelpOption();
+  const int defaultJobs = std::max(1, QThread::idealThreadCount() - 1);
+  parser.addOptions({
+      {"thumbnails", "Render thumbnails instead of starting the viewer."},
+      {{"o", "output"}, "Directory for the images.", "dir", "."},
+      {{"s", "size"}, "Image size in pixels.", "WxH", "512x512"},
+      {{"l", "list"}, "File listing models, one per line.", "file"},
+      {{"j", "jobs"}, "Threads parsing the next models.", "n",
+       QString::number(defaultJobs)},
+      {"projection", "parallel or perspective.", "type"},
+      {"edges", "line, dashed or none.", "type"},
+      {"edges-color", "Edge color.", "color"},
+      {"edges-size", "Edge width in pixels.", "px"},
+      {"vertices", "circle, square or none.", "type"},
+      {"vertices-color", "Vertex color.", "color"},
+      {"vertices-size", "Vertex size in pixels.", "px"},
+      {"background", "Background color.", "color"},
+      {"benchmark",
+       "Time this many frames of every edge and vertex type instead of "
+       "writing images.",
+       "frames"},
+  });
+  parser.addPositionalArgument("files", "OBJ files to render.", "[files...]");
+  parser.process(arguments);
+
+  QTextStream out(stdout);
+  QTextStream err(stderr);
+
+  const QRegularExpressionMatch size =
+      QRegularExpression("^(\\d+)x(\\d+)$").match(parser.value("size"));
+  const int jobs = parser.value("jobs").toInt();
+  const int benchmarkFrames =
+      parser.isSet("benchmark") ? parser.value("benchmark").toInt() : 0;
+  if (!size.hasMatch() || size.captured(1).toInt() <= 0 ||
+      size.captured(2).toInt() <= 0 || jobs <= 0 ||
+      (parser.isSet("benchmark") && benchmarkFrames <= 0)) {
+    err << "Invalid size, number of jobs or number of frames\n";
+    return 1;
+  }
+
+  // The saved viewer settings are the defaults of the style
+  auto setting = std::make_shared<UserSetting>();
+  QString error;
+  std::vector<std::string> paths;
+  if (!ApplyStyle(parser, *setting, error) ||
+      !CollectFiles(parser, paths, error)) {
+    err << error << '\n';
+    return 1;
+  }
+  const QDir output(parser.value("output"));
+  if (!output.mkpath(".")) {
+    err << "Cannot create " << output.path() << '\n';
+    return 1;
+  }
+
+  ThumbnailRenderer renderer(
+      setting, QSize(size.captured(1).toInt(), size.captured(2).toInt()));
+  if (!renderer.Initialize()) {
+    err << renderer.Error() << '\n';
+    return 1;
+  }
+
+  // While a model renders, each worker parses one of the next ones
+  QElapsedTimer timer;
+  timer.start();
+  const std::vector<QString> imageNames = ImageNames(paths);
+  s21::SceneQueue queue(std::move(paths), jobs, jobs);
+  const size_t total = queue.size();
+  size_t rendered = 0;
+  size_t index = 0;
+  s21::SceneQueue::Item item;
+  while (queue.Next(item)) {
+    const QString image = output.filePath(imageNames[index++]);
+    const QString path = QString::fromStdString(item.path);
+    try {
+      if (item.error) std::rethrow_exception(item.error);
+      if (benchmarkFrames > 0) {
+        out << path << '\n';
+        PrintStyleTimings(renderer, *setting, *item.data, benchmarkFrames,
+                          out);
+      } else {
+        if (!renderer.Render(*item.data).save(image)) {
+          throw std::runtime_error("cannot write " + image.toStdString());
+        }
+        out << path << " -> " << image << '\n';
+        out.flush();
+      }
+      ++rendered;
+    } catch (const std::exception &e) {
+      err << path << ": " << e.what() << '\n';
+    }
+    // Frees the model before waiting for the next one
+    item = s21::SceneQueue::Item();
+  }
+
+  const double seconds = timer.nsecsElapsed() / 1e9;
+  out << "Rendered " << rendered << " of " << total << " models in "
+      << seconds << " s, "
+      << (seconds > 0.0 ? rendered * 60.0 / seconds : 0.0)
+      << " models/min\n";
+  return rendered == total ? 0 : 1;
+}
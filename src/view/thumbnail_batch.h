@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QStringList>
+
+/**
+ * @class ThumbnailBatch
+ * @brief Command line mode rendering preview images of many OBJ files.
+ *
+ * Started as `3DViewer --thumbnails [options] files...`. Files are listed
+ * on the command line or, one per line, in a list file. Worker threads parse
+ * the next files while the current one is drawn by a ThumbnailRenderer, and
+ * each image is written as `<output>/<name>.png`, where the name is that of
+ * the model without `.gz` and the extension. Models with the same name get
+ * their directory, and if needed their position in the list, appended.
+ * The projection and style default to the saved viewer settings and can be
+ * overridden by options; `--help` lists them. At the end the throughput is
+ * reported in models per minute.
+ *
+ * With `--benchmark <frames>` no images are written; instead every model is
+ * drawn with each combination of edge and vertex type and the time per
+ * frame is printed, to compare the costs of the styles.
+ */
+class ThumbnailBatch {
+ public:
+  /**
+   * @brief Checks whether the command line asks for batch thumbnails.
+   * @param argc Number of arguments.
+   * @param argv The arguments.
+   * @return True if one of them is `--thumbnails`.
+   */
+  static bool IsRequested(int argc, char *argv[]);
+
+  /**
+   * @brief Renders the thumbnails the command line asks for.
+   *
+   * A QGuiApplication must exist. Unknown options print an error and exit
+   * the application; invalid values are reported and return 1.
+   *
+   * @param arguments The command line, including the program name.
+   * @return 0 if every file was rendered, 1 otherwise.
+   */
+  static int Run(const QStringList &arguments);
+};
@@ -0,0 +1,165 @@
+#include "thumbnail_renderer.h"
+
+#include <QElapsedTimer>
+#include <limits>
+#include <stdexcept>
+
+#include "scene_shaders.h"
+
+ThumbnailRenderer::ThumbnailRenderer(std::shared_ptr<UserSetting> setting,
+                                     QSize size)
+    : setting_(std::move(setting)), size_(size) {}
+
+ThumbnailRenderer::~ThumbnailRenderer() {
+  if (!context_.makeCurrent(&surface_)) return;
+  vbo_.destroy();
+  ebo_.destroy();
+  vao_.destroy();
+  program_.reset();
+  fbo_.reset();
+  context_.doneCurrent();
+}
+
+bool ThumbnailRenderer::Initialize() {
+  surface_.setFormat(QSurfaceFormat::defaultFormat());
+  surface_.create();
+  context_.setFormat(surface_.format());
+  if (!context_.create() || !context_.makeCurrent(&surface_)) {
+    error_ = "Cannot create an OpenGL context";
+    return false;
+  }
+  initializeOpenGLFunctions();
+  // Vertex sizes are set by the shaders
+  glEnable(GL_PROGRAM_POINT_SIZE);
+
+  QOpenGLFramebufferObjectFormat format;
+  format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+  format.setSamples(kSamples);
+  fbo_ = std::make_unique<QOpenGLFramebufferObject>(size_, format);
+  if (!fbo_->isValid()) {
+    error_ = "Cannot create a framebuffer of the requested size";
+    return false;
+  }
+
+  program_ = std::make_unique<QOpenGLShaderProgram>();
+  if (!SceneShaders::Build(program_.get())) {
+    error_ = "Shader program failed to compile or link: " + program_->log();
+    return false;
+  }
+
+  vao_.create();
+  vbo_.create();
+  ebo_.create();
+  error_.clear();
+  return true;
+}
+
+QImage ThumbnailRenderer::Render(const s21::DrawSceneData &scene) {
+  context_.makeCurrent(&surface_);
+  fbo_->bind();
+  glViewport(0, 0, size_.width(), size_.height());
+  const QColor background = setting_->GetBackgroundColor();
+  glClearColor(background.redF(), background.greenF(), background.blueF(),
+               1.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  if (!scene.vertices.empty()) {
+    Upload(scene);
+    Draw(scene);
+  }
+
+  // Resolves the samples and reads the pixels back
+  QImage image = fbo_->toImage();
+  fbo_->release();
+  return image;
+}
+
+double ThumbnailRenderer::TimeDraw(const s21::DrawSceneData &scene,
+                                   int frames) {
+  if (scene.vertices.empty() || frames <= 0) return 0.0;
+  context_.makeCurrent(&surface_);
+  fbo_->bind();
+  glViewport(0, 0, size_.width(), size_.height());
+  Upload(scene);
+
+  // The first frame also pays for compiling the state, so it is not timed
+  QElapsedTimer timer;
+  for (int frame = -1; frame < frames; ++frame) {
+    if (frame == 0) {
+      glFinish();
+      timer.start();
+    }
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    Draw(scene);
+  }
+  glFinish();
+  const double ms = timer.nsecsElapsed() / 1e6 / frames;
+  fbo_->release();
+  return ms;
+}
+
+void ThumbnailRenderer::Upload(const s21::DrawSceneData &scene) {
+  // QOpenGLBuffer takes int sizes
+  const size_t vertexBytes = scene.vertices.size() * sizeof(s21::Vec3f);
+  const size_t indexBytes = scene.index_data.size() * sizeof(uint16_t);
+  constexpr size_t kMaxBytes = std::numeric_limits<int>::max();
+  if (vertexBytes > kMaxBytes || indexBytes > kMaxBytes) {
+    throw std::length_error("model needs a GPU buffer of 2 GB or more");
+  }
+
+  // Each scene is uploaded once, so the stores are simply replaced
+  vao_.bind();
+  vbo_.bind();
+  vbo_.allocate(scene.vertices.data(), static_cast<int>(vertexBytes));
+  program_->enableAttributeArray(0);
+  ebo_.bind();
+  ebo_.allocate(scene.index_data.data(), static_cast<int>(indexBytes));
+  vao_.release();
+  vbo_.release();
+  ebo_.release();
+}
+
+void ThumbnailRenderer::Draw(const s21::DrawSceneData &scene) {
+  glEnable(GL_DEPTH_TEST);
+  program_->bind();
+  program_->setUniformValue(
+      "projectionMatrix",
+      SceneShaders::Projection(setting_->IsParallelProjection(),
+                               static_cast<float>(size_.width()) /
+                                   size_.height()));
+  program_->setUniformValue("viewMatrix", SceneShaders::Camera());
+  program_->setUniformValue("modelMatrix", QMatrix4x4());
+  program_->setUniformValue("positionStep", QVector3D(1.0f, 1.0f, 1.0f));
+  program_->setUniformValue("positionOffset", QVector3D());
+  vao_.bind();
+  vbo_.bind();
+
+  if (setting_->GetEdgesType() != "none" && scene.edge_count > 0) {
+    SceneShaders::SetEdgeStyle(program_.get(), *setting_, QSizeF(size_));
+    glLineWidth(setting_->GetEdgesSize());
+
+    // Batch indices are relative to a base vertex, applied by offsetting
+    // the position attribute, as in Viewport3D
+    for (const s21::EdgeBatch &batch : scene.edge_batches) {
+      glVertexAttribPointer(
+          0, 3, GL_FLOAT, GL_FALSE, sizeof(s21::Vec3f),
+          reinterpret_cast<const void *>(batch.base_vertex *
+                                         sizeof(s21::Vec3f)));
+      glDrawElements(GL_LINES, static_cast<GLsizei>(batch.count),
+                     batch.wide ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT,
+                     reinterpret_cast<const void *>(batch.offset));
+    }
+  }
+
+  if (setting_->GetVerticesType() != "none") {
+    SceneShaders::SetVertexStyle(program_.get(), *setting_);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(s21::Vec3f),
+                          nullptr);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(scene.vertices.size()));
+  }
+
+  vbo_.release();
+  vao_.release();
+  program_->release();
+  glDisable(GL_DEPTH_TEST);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QSize>
+#include <memory>
+
+#include "scene.h"
+#include "user_setting.h"
+
+/**
+ * @class ThumbnailRenderer
+ * @brief Renders scenes into images without a window.
+ *
+ * The renderer owns an OpenGL context on an offscreen surface and draws into
+ * a multisampled framebuffer object with the shaders, camera and style of
+ * the viewer. It needs no display, so it also runs with
+ * QT_QPA_PLATFORM=offscreen and a software rasterizer such as Mesa's
+ * llvmpipe. Scenes are drawn as loaded, without a model transformation.
+ */
+class ThumbnailRenderer : protected QOpenGLFunctions {
+ public:
+  /**
+   * @brief Constructs a renderer; Initialize() creates its context.
+   * @param setting Projection and style of the images.
+   * @param size Size of the images in pixels.
+   */
+  ThumbnailRenderer(std::shared_ptr<UserSetting> setting, QSize size);
+
+  /**
+   * @brief Releases the OpenGL resources.
+   */
+  ~ThumbnailRenderer();
+
+  ThumbnailRenderer(const ThumbnailRenderer &) = delete;
+  ThumbnailRenderer &operator=(const ThumbnailRenderer &) = delete;
+
+  /**
+   * @brief Creates the context, the framebuffer and the shaders.
+   * @return False if OpenGL is not available or the shaders do not build;
+   * Error() then tells why.
+   */
+  bool Initialize();
+
+  /**
+   * @brief Returns why Initialize() failed.
+   * @return A description of the failure; empty after success.
+   */
+  const QString &Error() const { return error_; }
+
+  /**
+   * @brief Draws a scene.
+   * @param scene The scene; Initialize() must have succeeded.
+   * @return The image, of the size given to the constructor.
+   * @throws std::length_error if a buffer of the scene exceeds 2 GB.
+   */
+  QImage Render(const s21::DrawSceneData &scene);
+
+  /**
+   * @brief Measures how long drawing a scene takes with the current style.
+   *
+   * The scene is uploaded once and drawn repeatedly, waiting for the GPU
+   * to finish, so the time covers the draw calls and the rasterization
+   * but not the upload.
+   *
+   * @param scene The scene; Initialize() must have succeeded.
+   * @param frames Number of timed frames, after one untimed frame.
+   * @return Milliseconds per frame; 0 for an empty scene.
+   * @throws std::length_error if a buffer of the scene exceeds 2 GB.
+   */
+  double TimeDraw(const s21::DrawSceneData &scene, int frames);
+
+ private:
+  /// Projection and style of the images
+  std::shared_ptr<UserSetting> setting_;
+  /// Image size in pixels
+  QSize size_;
+  /// Samples per pixel of the framebuffer
+  static constexpr int kSamples = 4;
+
+  QOffscreenSurface surface_;  ///< Surface the context is made current on
+  QOpenGLContext context_;     ///< Context owning all resources below
+  /// Framebuffer the images are drawn into
+  std::unique_ptr<QOpenGLFramebufferObject> fbo_;
+  /// The scene shaders
+  std::unique_ptr<QOpenGLShaderProgram> program_;
+  QOpenGLVertexArrayObject vao_;                    ///< Attribute setup
+  QOpenGLBuffer vbo_{QOpenGLBuffer::VertexBuffer};  ///< Positions
+  QOpenGLBuffer ebo_{QOpenGLBuffer::IndexBuffer};   ///< Edge indices
+  QString error_;                                   ///< Why setup failed
+
+  /**
+   * @brief Uploads the positions and edge indices of a scene.
+   * @param scene The scene.
+   */
+  void Upload(const s21::DrawSceneData &scene);
+
+  /**
+   * @brief Draws the uploaded scene with the style of the settings.
+   * @param scene The scene last uploaded.
+   */
+  void Draw(const s21::DrawSceneData &scene);
+};
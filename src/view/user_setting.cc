@@ -18,6 +18,9 @@ void UserSetting::SaveRenderSettings() {
   settings.setValue("backgroundColor", backgroundColor_);
 
   settings.setValue("isParallelProjection", isParallelProjection_);
+  settings.setValue("isQuantizedPositions", isQuantizedPositions_);
+  settings.setValue("isSpatialOrder", isSpatialOrder_);
+  settings.setValue("isTimingOverlay", isTimingOverlay_);
 
   settings.endGroup();
 }
@@ -40,6 +43,10 @@ void UserSetting::ReadRenderSettings() {
       settings.value("backgroundColor", QColor(Qt::black)).value<QColor>();
 
   isParallelProjection_ = settings.value("isParallelProjection", true).toBool();
+  isQuantizedPositions_ =
+      settings.value("isQuantizedPositions", false).toBool();
+  isSpatialOrder_ = settings.value("isSpatialOrder", false).toBool();
+  isTimingOverlay_ = settings.value("isTimingOverlay", false).toBool();
 
   settings.endGroup();
 }
@@ -56,4 +63,7 @@ void UserSetting::ResetRenderSettings() {
   backgroundColor_ = QColor(Qt::black);
 
   isParallelProjection_ = true;
+  isQuantizedPositions_ = false;
+  isSpatialOrder_ = false;
+  isTimingOverlay_ = false;
 }
\ No newline at end of file
@@ -10,7 +10,7 @@
  *
  * This class provides methods to save, read, and remove user settings for
  * rendering parameters such as vertices and edges properties, background color,
- * and projection type.
+ * projection type, vertex upload format, vertex order and the timing overlay.
  */
 class UserSetting {
  public:
@@ -25,7 +25,7 @@ class UserSetting {
    * @brief Saves the current render settings to a file.
    *
    * This method saves the vertices type, color, size, edges type, color, size,
-   * background color, and projection type to the settings file.
+   * background color, projection type and upload format to the settings file.
    */
   void SaveRenderSettings();
 
@@ -33,7 +33,8 @@ class UserSetting {
    * @brief Reads the render settings from a file.
    *
    * This method loads the vertices type, color, size, edges type, color, size,
-   * background color, and projection type from the settings file.
+   * background color, projection type and upload format from the settings
+   * file.
    */
   void ReadRenderSettings();
 
@@ -60,6 +61,51 @@ class UserSetting {
     isParallelProjection_ = isParallel;
   }
 
+  /**
+   * @brief Checks if positions are uploaded as 16-bit integers.
+   *
+   * @return True if the GPU gets quantized positions, false for floats.
+   */
+  inline bool IsQuantizedPositions() const { return isQuantizedPositions_; }
+
+  /**
+   * @brief Sets the vertex upload format.
+   *
+   * @param isQuantized True for 16-bit positions, false for floats.
+   */
+  inline void SetQuantizedPositions(bool isQuantized) {
+    isQuantizedPositions_ = isQuantized;
+  }
+
+  /**
+   * @brief Checks if opened files are sorted spatially.
+   *
+   * @return True if vertices are stored in Morton order, false for file
+   * order.
+   */
+  inline bool IsSpatialOrder() const { return isSpatialOrder_; }
+
+  /**
+   * @brief Sets the vertex order of opened files.
+   *
+   * @param isSpatial True for Morton order, false for file order.
+   */
+  inline void SetSpatialOrder(bool isSpatial) { isSpatialOrder_ = isSpatial; }
+
+  /**
+   * @brief Checks if frame timings are drawn over the scene.
+   *
+   * @return True if the timing overlay is shown.
+   */
+  inline bool IsTimingOverlay() const { return isTimingOverlay_; }
+
+  /**
+   * @brief Shows or hides the frame timings over the scene.
+   *
+   * @param isShown True to show the timing overlay.
+   */
+  inline void SetTimingOverlay(bool isShown) { isTimingOverlay_ = isShown; }
+
   /**
    * @brief Gets the background color.
    *
@@ -185,4 +231,7 @@ class UserSetting {
 
   bool
       isParallelProjection_;  ///< Flag indicating if the projection is parallel
+  bool isQuantizedPositions_;  ///< Flag for the 16-bit vertex upload
+  bool isSpatialOrder_;        ///< Flag for the spatial vertex order
+  bool isTimingOverlay_;       ///< Flag for the frame timing overlay
 };
\ No newline at end of file
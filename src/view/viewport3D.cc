@@ -1,41 +1,60 @@
 #include "viewport3D.h"
 
+#include <QFontDatabase>
+#include <QOpenGLContext>
+#include <QPainter>
+#include <algorithm>
+
+#include "math/quantized_positions.h"
+#include "scene_shaders.h"
+
 Viewport3D::Viewport3D(std::shared_ptr<UserSetting> setting, QWidget *parent)
     : QOpenGLWidget(parent), renderSetting_(setting) {}
 
-void Viewport3D::SetScene(std::shared_ptr<s21::DrawSceneData> sc) {
+Viewport3D::~Viewport3D() { CleanupGL(); }
+
+void Viewport3D::SetScene(std::shared_ptr<s21::DrawSceneData> sc,
+                          s21::SceneChange change) {
+  // The buffers hold the previous geometry; transforms and style changes
+  // reuse them as they are.
+  if (change == s21::SceneChange::kGeometry || sc != scene_) {
+    needBufferUpdate_ = true;
+  }
+  if (sc != scene_) {
+    lods_.reset();
+    lodLevel_ = 0;
+    uploadRejected_ = false;
+  }
   scene_ = std::move(sc);
-  needBufferUpdate_ = true;
+  if (change == s21::SceneChange::kTransform) UpdateModelMatrix();
   update();  // Request a repaint
 }
 
+void Viewport3D::SetLods(std::shared_ptr<const s21::LodChain> lods) {
+  if (!lods || lods->size() == 0 || (*lods)[0].data != scene_) return;
+  lods_ = std::move(lods);
+  update();
+}
+
+void Viewport3D::ReloadBuffers() {
+  needBufferUpdate_ = true;
+  uploadRejected_ = false;
+  update();
+}
+
 void Viewport3D::ChangeAspectRatio(bool isGif) {
   isGifRatio_ = isGif;
   Repaint();
 }
 
 void Viewport3D::UpdateModelMatrix() {
-  static float last_tx = 0, last_ty = 0, last_tz = 0;
-  static float last_rx = 0, last_ry = 0, last_rz = 0;
-  static float last_sx = 1, last_sy = 1, last_sz = 1;
-
-  auto [tx, ty, tz, rx, ry, rz, sx, sy, sz] =
-      s21::Controller::GetInstance()->GetSceneParameters();
+  const auto parameters = s21::Controller::GetInstance()->GetSceneParameters();
 
   // Only update the matrix if any parameter has changed
-  if (tx != last_tx || ty != last_ty || tz != last_tz || rx != last_rx ||
-      ry != last_ry || rz != last_rz || sx != last_sx || sy != last_sy ||
-      sz != last_sz) {
+  if (parameters != modelParameters_) {
     // Save current parameters for next comparison
-    last_tx = tx;
-    last_ty = ty;
-    last_tz = tz;
-    last_rx = rx;
-    last_ry = ry;
-    last_rz = rz;
-    last_sx = sx;
-    last_sy = sy;
-    last_sz = sz;
+    modelParameters_ = parameters;
+    auto [tx, ty, tz, rx, ry, rz, sx, sy, sz] = parameters;
 
     modelMatrix_.setToIdentity();
 
@@ -66,12 +85,19 @@ void Viewport3D::initializeGL() {
   initializeOpenGLFunctions();
   SetBackColor();
   glEnable(GL_DEPTH_TEST);
+  // Vertex sizes are set by the shaders
+  glEnable(GL_PROGRAM_POINT_SIZE);
   InitShaders();
 
   // Create VAO and VBO
   if (!vao_.isCreated()) vao_.create();
-  if (!vbo_.isCreated()) vbo_.create();
-  if (!ebo_.isCreated()) ebo_.create();
+  vertexStream_.Create();
+  indexStream_.Create();
+  profiler_.Initialize();
+
+  // The context is replaced when the widget moves to another window
+  connect(context(), &QOpenGLContext::aboutToBeDestroyed, this,
+          &Viewport3D::CleanupGL, Qt::UniqueConnection);
 }
 
 void Viewport3D::resizeGL(int w, int h) {
@@ -80,17 +106,38 @@ void Viewport3D::resizeGL(int w, int h) {
 }
 
 void Viewport3D::paintGL() {
+  profiler_.BeginFrame();
   SetBackColor();
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  frameUploadBytes_ = 0;
+  ++framesRendered_;
 
-  if (!scene_ || scene_->vertices.empty() || scene_->vertex_indices.empty())
+  // Scenes without edges, such as point clouds, still draw their vertices
+  if (!scene_ || scene_->vertices.empty()) {
+    profiler_.EndFrame();
+    DrawTimingOverlay();
     return;
+  }
 
   // Update buffers if needed
+  const bool levelChanged = SelectLod();
   if (needBufferUpdate_) {
     UpdateBuffers();
     needBufferUpdate_ = false;
   }
+  StreamBuffers();
+  totalUploadBytes_ += frameUploadBytes_;
+  Q_EMIT signalFrameUploaded(frameUploadBytes_);
+  // Keep frames coming until the scene is fully uploaded
+  const bool uploaded = UploadProgress() >= 1.0;
+  if (!uploaded) update();
+  profiler_.EndPhase(FrameProfiler::kBufferUpdate);
+
+  // Uploads are excluded, so switching levels does not count against the
+  // budget of the level switched to
+  QElapsedTimer drawTimer;
+  drawTimer.start();
+  const s21::DrawSceneData &drawn = DrawnScene();
 
   // Enable depth testing once
   glEnable(GL_DEPTH_TEST);
@@ -102,59 +149,53 @@ void Viewport3D::paintGL() {
   shaderProgram_->setUniformValue("projectionMatrix", projectionMatrix_);
   shaderProgram_->setUniformValue("viewMatrix", viewMatrix_);
   shaderProgram_->setUniformValue("modelMatrix", modelMatrix_);
+  shaderProgram_->setUniformValue("positionStep", positionStep_);
+  shaderProgram_->setUniformValue("positionOffset", positionOffset_);
 
   // Bind VAO once
   vao_.bind();
+  profiler_.EndPhase(FrameProfiler::kUniforms);
 
   // Draw edges if enabled
   if (renderSetting_->GetEdgesType() != "none" && indexCount_ > 0) {
-    shaderProgram_->setUniformValue("renderMode", 0);  // Edges mode
-    QColor edgeColor = renderSetting_->GetEdgesColor();
-    shaderProgram_->setUniformValue("edgeColor", edgeColor.redF(),
-                                    edgeColor.greenF(), edgeColor.blueF(),
-                                    1.0f);
-
-    if (renderSetting_->GetEdgesType() == "dashed") {
-      glEnable(GL_LINE_STIPPLE);
-      glLineStipple(1, 0x00FF);
-    }
-
+    // Dashes are measured in device pixels
+    SceneShaders::SetEdgeStyle(shaderProgram_, *renderSetting_,
+                               QSizeF(size()) * devicePixelRatioF());
     glLineWidth(renderSetting_->GetEdgesSize());
 
-    // Bind index buffer and draw elements
-    ebo_.bind();
-    glDrawElements(GL_LINES, indexCount_, GL_UNSIGNED_INT, nullptr);
-    ebo_.release();
-
-    // Disable stippling if it was enabled
-    if (renderSetting_->GetEdgesType() == "dashed") {
-      glDisable(GL_LINE_STIPPLE);
+    // Draw every batch with its index type. Batch indices are relative to
+    // a base vertex, applied by offsetting the position attribute. While
+    // streaming, only batches whose vertices and indices are all uploaded
+    // are drawn.
+    indexStream_.Buffer().bind();
+    vertexStream_.Buffer().bind();
+    for (const s21::EdgeBatch &batch : drawn.edge_batches) {
+      const size_t end =
+          batch.offset + batch.count * (batch.wide ? sizeof(uint32_t)
+                                                   : sizeof(uint16_t));
+      if (!vertexStream_.Done() ||
+          end > static_cast<size_t>(indexStream_.Uploaded())) {
+        break;
+      }
+      SetPositionAttribute(batch.base_vertex);
+      glDrawElements(GL_LINES, static_cast<GLsizei>(batch.count),
+                     batch.wide ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT,
+                     reinterpret_cast<const void *>(batch.offset));
     }
+    SetPositionAttribute(0);
+    vertexStream_.Buffer().release();
+    indexStream_.Buffer().release();
   }
+  profiler_.EndPhase(FrameProfiler::kEdges);
 
   // Draw vertices if enabled
   if (renderSetting_->GetVerticesType() != "none" && vertexCount_ > 0) {
-    shaderProgram_->setUniformValue("renderMode", 1);  // Vertices mode
-    QColor vertexColor = renderSetting_->GetVerticesColor();
-    shaderProgram_->setUniformValue("vertexColor", vertexColor.redF(),
-                                    vertexColor.greenF(), vertexColor.blueF(),
-                                    1.0f);
-
-    bool usePointSmooth = renderSetting_->GetVerticesType() == "circle";
-    if (usePointSmooth) {
-      glEnable(GL_POINT_SMOOTH);
-      glEnable(GL_BLEND);
-      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    }
-
-    glPointSize(renderSetting_->GetVerticesSize());
-    glDrawArrays(GL_POINTS, 0, vertexCount_);
-
-    if (usePointSmooth) {
-      glDisable(GL_BLEND);
-      glDisable(GL_POINT_SMOOTH);
-    }
+    SceneShaders::SetVertexStyle(shaderProgram_, *renderSetting_);
+    glDrawArrays(GL_POINTS, 0,
+                 static_cast<GLsizei>(vertexStream_.Uploaded() /
+                                      positionStride_));
   }
+  profiler_.EndPhase(FrameProfiler::kVertices);
 
   // Unbind VAO and shader program
   vao_.release();
@@ -162,6 +203,13 @@ void Viewport3D::paintGL() {
 
   // Disable depth testing after rendering
   glDisable(GL_DEPTH_TEST);
+  // Frames of a new or streaming level skip batches, so they are too short
+  // to tell what the level costs
+  frameBudget_.Update(drawTimer.nsecsElapsed() / 1e6,
+                      uploaded && !levelChanged);
+  profiler_.EndFrame();
+  // Painted after the frame is measured, so the overlay does not count
+  DrawTimingOverlay();
 }
 
 void Viewport3D::InitShaders() {
@@ -175,54 +223,47 @@ void Viewport3D::InitShaders() {
   }
 
   shaderProgram_ = new QOpenGLShaderProgram(this);
-
-  // Vertex shader source code
-  const char *vertexShaderSource = R"(
-      #version 330 core
-      layout (location = 0) in vec3 aPos;
-      
-      uniform mat4 projectionMatrix;
-      uniform mat4 viewMatrix;
-      uniform mat4 modelMatrix;
-      
-      void main() {
-          gl_Position = projectionMatrix * viewMatrix * modelMatrix * vec4(aPos, 1.0);
-      }
-    )";
-
-  // Fragment shader source code
-  const char *fragmentShaderSource = R"(
-      #version 330 core
-      out vec4 FragColor;
-      
-      uniform int renderMode; // 0 for edges, 1 for vertices
-      uniform vec4 edgeColor;
-      uniform vec4 vertexColor;
-      
-      void main() {
-          if (renderMode == 0) {
-              FragColor = edgeColor;
-          } else {
-              FragColor = vertexColor;
-          }
-      }
-    )";
-
-  if (!shaderProgram_->addShaderFromSourceCode(QOpenGLShader::Vertex,
-                                               vertexShaderSource) ||
-      !shaderProgram_->addShaderFromSourceCode(QOpenGLShader::Fragment,
-                                               fragmentShaderSource) ||
-      !shaderProgram_->link()) {
+  if (!SceneShaders::Build(shaderProgram_)) {
     qDebug() << "Shader program failed to compile or link:";
     qDebug() << shaderProgram_->log();
   }
 }
 
+const s21::DrawSceneData &Viewport3D::DrawnScene() const {
+  return lods_ ? *(*lods_)[lodLevel_].data : *scene_;
+}
+
+bool Viewport3D::SelectLod() {
+  size_t level = 0;
+  if (lods_ && lods_->size() > 1) {
+    // Depth of the model origin; 1 for the orthographic projection
+    const QVector4D origin =
+        projectionMatrix_ * viewMatrix_ * modelMatrix_ * QVector4D(0, 0, 0, 1);
+    float scale = 0.0f;
+    for (int k = 0; k < 3; ++k) {
+      scale = std::max(scale, modelMatrix_.column(k).toVector3D().length());
+    }
+    const float pixelsPerUnit = height() * devicePixelRatioF() * 0.5f *
+                                projectionMatrix_(1, 1) * scale /
+                                std::max(origin.w(), 1e-3f);
+    level = lods_->Select(pixelsPerUnit,
+                          kLodPixelError * frameBudget_.Scale(), lodLevel_);
+  }
+  if (level == lodLevel_) return false;
+  lodLevel_ = level;
+  needBufferUpdate_ = true;
+  return true;
+}
+
 void Viewport3D::UpdateBuffers() {
   if (!scene_ || scene_->vertices.empty()) return;
+  // The streams keep the level alive until it is uploaded
+  std::shared_ptr<const s21::DrawSceneData> owner =
+      lods_ ? (*lods_)[lodLevel_].data : scene_;
+  const s21::DrawSceneData &drawn = *owner;
 
-  vertexCount_ = scene_->vertices.size() / 3;
-  indexCount_ = scene_->vertex_indices.size();
+  vertexCount_ = drawn.vertices.size();
+  indexCount_ = drawn.edge_count * 2;
 
   if (vertexCount_ == 0) return;
 
@@ -234,65 +275,146 @@ void Viewport3D::UpdateBuffers() {
   // Bind VAO to store buffer configuration
   vao_.bind();
 
-  // Update vertex buffer - only reallocate if size changed
-  static size_t lastVertexSize = 0;
-  const size_t currentVertexSize = scene_->vertices.size() * sizeof(float);
+  // Positions are encoded while loading; scenes loaded before 16-bit
+  // positions were enabled have none and are drawn with floats
+  bool fits = false;
+  if (renderSetting_->IsQuantizedPositions() && drawn.quantized) {
+    const auto &quantized = drawn.quantized;
+    positionType_ = GL_SHORT;
+    positionStride_ = 3 * sizeof(int16_t);
+    const s21::Vec3f &step = quantized->Step();
+    const s21::Vec3f &offset = quantized->Offset();
+    positionStep_ = QVector3D(step.x, step.y, step.z);
+    positionOffset_ = QVector3D(offset.x, offset.y, offset.z);
+    quantizationError_ = quantized->MaxError();
+    fits = vertexStream_.Start(quantized->data(), quantized->bytes(),
+                               quantized);
+  } else {
+    positionType_ = GL_FLOAT;
+    positionStride_ = sizeof(s21::Vec3f);
+    positionStep_ = QVector3D(1.0f, 1.0f, 1.0f);
+    positionOffset_ = QVector3D();
+    quantizationError_ = 0.0f;
+    fits = vertexStream_.Start(drawn.vertices.data(),
+                               drawn.vertices.size() * sizeof(s21::Vec3f),
+                               owner);
+  }
 
-  vbo_.bind();
-  if (currentVertexSize != lastVertexSize) {
-    vbo_.allocate(scene_->vertices.data(), currentVertexSize);
-    lastVertexSize = currentVertexSize;
+  // Set vertex attribute pointer for position (location = 0); the format
+  // may have changed even if the size did not
+  vertexStream_.Buffer().bind();
+  shaderProgram_->enableAttributeArray(0);
+  SetPositionAttribute(0);
+  vertexStream_.Buffer().release();
 
-    // Set vertex attribute pointer for position (location = 0)
-    shaderProgram_->enableAttributeArray(0);
-    shaderProgram_->setAttributeBuffer(0, GL_FLOAT, 0, 3, 0);
+  if (indexCount_ > 0) {
+    fits = indexStream_.Start(drawn.index_data.data(),
+                              drawn.index_data.size() * sizeof(uint16_t),
+                              owner) &&
+           fits;
   } else {
-    // Just update the data without reallocating
-    vbo_.write(0, scene_->vertices.data(), currentVertexSize);
+    indexStream_.Clear();
   }
-  vbo_.release();
 
-  // Update index buffer if indices are available - only reallocate if size
-  // changed
-  if (indexCount_ > 0) {
-    static size_t lastIndexSize = 0;
-    const size_t currentIndexSize =
-        scene_->vertex_indices.size() * sizeof(unsigned int);
-
-    ebo_.bind();
-    if (currentIndexSize != lastIndexSize) {
-      ebo_.allocate(scene_->vertex_indices.data(), currentIndexSize);
-      lastIndexSize = currentIndexSize;
-    } else {
-      // Just update the data without reallocating
-      ebo_.write(0, scene_->vertex_indices.data(), currentIndexSize);
+  // Release VAO
+  vao_.release();
+
+  if (!fits) {
+    // Nothing is drawn rather than a truncated buffer
+    vertexStream_.Clear();
+    indexStream_.Clear();
+    vertexCount_ = 0;
+    indexCount_ = 0;
+    if (!uploadRejected_) {
+      uploadRejected_ = true;
+      Q_EMIT signalUploadRejected(
+          tr("The model needs a GPU buffer larger than %1 MB and cannot be "
+             "drawn.")
+              .arg(BufferStream::kMaxBytes >> 20));
     }
-    ebo_.release();
   }
+}
 
-  // Release VAO
+void Viewport3D::StreamBuffers() {
+  if (vertexStream_.Done() && indexStream_.Done()) return;
+
+  vao_.bind();
+  // Vertices go first: an edge can be drawn only once both ends are in
+  qint64 budget = kUploadSliceBytes;
+  budget -= vertexStream_.Upload(budget);
+  vertexStream_.Buffer().release();
+  if (vertexStream_.Done() && budget > 0) {
+    budget -= indexStream_.Upload(budget);
+    indexStream_.Buffer().release();
+  }
   vao_.release();
+  frameUploadBytes_ += kUploadSliceBytes - budget;
+}
+
+double Viewport3D::UploadProgress() const {
+  const qint64 total = vertexStream_.Size() + indexStream_.Size();
+  if (total == 0) return 1.0;
+  return static_cast<double>(vertexStream_.Uploaded() +
+                             indexStream_.Uploaded()) /
+         total;
+}
+
+void Viewport3D::DrawTimingOverlay() {
+  if (!renderSetting_->IsTimingOverlay()) return;
+
+  const QString text = profiler_.Summary();
+  QPainter painter(this);
+  painter.setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  const QRect textRect = painter.fontMetrics().boundingRect(
+      rect(), Qt::AlignLeft | Qt::AlignTop, text);
+  const QRect box = textRect.translated(10, 10).adjusted(-6, -6, 6, 6);
+  painter.fillRect(box, QColor(0, 0, 0, 160));
+  painter.setPen(Qt::white);
+  painter.drawText(box.adjusted(6, 6, -6, -6), Qt::AlignLeft | Qt::AlignTop,
+                   text);
+}
+
+void Viewport3D::CleanupGL() {
+  // Nothing was created without a context
+  if (!shaderProgram_) return;
+
+  makeCurrent();
+  vertexStream_.Destroy();
+  indexStream_.Destroy();
+  vao_.destroy();
+  profiler_.Release();
+  delete shaderProgram_;
+  shaderProgram_ = nullptr;
+  doneCurrent();
+  // The data is uploaded again once a new context is initialized
+  needBufferUpdate_ = true;
+}
+
+void Viewport3D::SetPositionAttribute(size_t baseVertex) {
+  // Integer positions are not normalized; positionStep scales them
+  glVertexAttribPointer(
+      0, 3, positionType_, GL_FALSE, positionStride_,
+      reinterpret_cast<const void *>(baseVertex * positionStride_));
 }
 
 void Viewport3D::UpdateProjectionMatrix() {
-  projectionMatrix_.setToIdentity();
+  const bool parallel = renderSetting_->IsParallelProjection();
+  if (projectionValid_ && projectionSize_ == size() &&
+      projectionGifRatio_ == isGifRatio_ && projectionParallel_ == parallel) {
+    UpdateModelMatrix();
+    return;
+  }
+  projectionValid_ = true;
+  projectionSize_ = size();
+  projectionGifRatio_ = isGifRatio_;
+  projectionParallel_ = parallel;
 
   float aspect = static_cast<float>(width()) /
                  (isGifRatio_ ? (width() * 3 / 4) : height());
-
-  if (renderSetting_->IsParallelProjection()) {
-    // Orthographic projection parameters
-    float size = 1.0f;
-    projectionMatrix_.ortho(-size * aspect, size * aspect, -size, size, 1.0f,
-                            100.0f);
-  } else {
-    // Perspective projection parameters
-    projectionMatrix_.perspective(45.0f, aspect, 1.0f, 100.0f);
-  }
+  projectionMatrix_ = SceneShaders::Projection(parallel, aspect);
 
   // Set the view matrix (camera transformation)
-  viewMatrix_.setToIdentity();
-  viewMatrix_.translate(0.0f, 0.0f, -2.0f);
+  viewMatrix_ = SceneShaders::Camera();
 
   // Update the model matrix
   UpdateModelMatrix();
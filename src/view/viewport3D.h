@@ -1,14 +1,20 @@
 #pragma once
 
+#include <QElapsedTimer>
 #include <QOpenGLBuffer>
 #include <QOpenGLFunctions>
 #include <QOpenGLShaderProgram>
 #include <QOpenGLVertexArrayObject>
 #include <QOpenGLWidget>
+#include <QVector3D>
 #include <memory>
+#include <tuple>
 
 #include "Logger.h"
+#include "buffer_stream.h"
 #include "controller.h"
+#include "frame_profiler.h"
+#include "lod/lod_chain.h"
 #include "scene.h"
 #include "user_setting.h"
 
@@ -31,6 +37,21 @@ class Viewport3D : public QOpenGLWidget, protected QOpenGLFunctions {
    */
   void signalChangeSize(const int w, const int h);
 
+  /**
+   * @brief Signal emitted after each drawn frame.
+   * @param bytes Bytes of vertex and index data uploaded for the frame.
+   */
+  void signalFrameUploaded(qint64 bytes);
+
+  /**
+   * @brief Signal emitted when the scene is too large for a GPU buffer.
+   *
+   * Emitted while painting, once per scene; the scene is then not drawn.
+   *
+   * @param message Description of the problem for the user.
+   */
+  void signalUploadRejected(const QString &message);
+
  public:
   /**
    * @brief Constructs a new Viewport3D widget.
@@ -40,14 +61,42 @@ class Viewport3D : public QOpenGLWidget, protected QOpenGLFunctions {
   explicit Viewport3D(std::shared_ptr<UserSetting> setting,
                       QWidget *parent = nullptr);
 
+  /**
+   * @brief Releases the OpenGL resources of the widget.
+   */
+  ~Viewport3D() override;
+
   /**
    * @brief Sets the scene to be rendered.
    *
    * This function updates the internal scene data and requests a repaint.
+   * GPU buffers are refreshed only for geometry changes or a new scene;
+   * transformations just update the model matrix.
    *
    * @param sc Shared pointer to the new scene data.
+   * @param change What changed since the previous call.
    */
-  void SetScene(std::shared_ptr<s21::DrawSceneData> sc);
+  void SetScene(std::shared_ptr<s21::DrawSceneData> sc,
+                s21::SceneChange change = s21::SceneChange::kGeometry);
+
+  /**
+   * @brief Sets the levels of detail of the current scene.
+   *
+   * From the next frame on, each frame draws the coarsest level whose error
+   * projects to at most kLodPixelError pixels, loosened while frames exceed
+   * kFrameBudgetMs. A chain of another scene is ignored; a new scene drops
+   * the chain.
+   *
+   * @param lods The chain; level 0 must be the current scene.
+   */
+  void SetLods(std::shared_ptr<const s21::LodChain> lods);
+
+  /**
+   * @brief Uploads the current scene again on the next frame.
+   *
+   * Used after the vertex upload format has been changed in the settings.
+   */
+  void ReloadBuffers();
 
   /**
    * @brief Change projection matrix before and after grabbing the screen.
@@ -69,10 +118,75 @@ class Viewport3D : public QOpenGLWidget, protected QOpenGLFunctions {
   /**
    * @brief Repaints the viewport.
    *
-   * This function updates the projection matrix and requests a repaint.
+   * This function updates the projection matrix if the size, aspect mode or
+   * projection type changed, and requests a repaint.
    */
   void Repaint();
 
+  /**
+   * @brief Returns the bytes uploaded to the GPU for the last drawn frame.
+   * @return Vertex and index bytes written by that frame.
+   */
+  qint64 FrameUploadBytes() const { return frameUploadBytes_; }
+
+  /**
+   * @brief Returns how much of the current scene is on the GPU.
+   * @return Uploaded part of the vertex and index data, from 0 to 1.
+   */
+  double UploadProgress() const;
+
+  /**
+   * @brief Returns the bytes uploaded to the GPU since the widget was made.
+   * @return Vertex and index bytes written by all frames.
+   */
+  qint64 TotalUploadBytes() const { return totalUploadBytes_; }
+
+  /**
+   * @brief Returns the largest position error of the vertex buffer.
+   * @return The largest coordinate error of quantized positions, in model
+   * units; 0 for float positions.
+   */
+  float QuantizationError() const { return quantizationError_; }
+
+  /**
+   * @brief Tells whether the vertex buffer holds 16-bit positions.
+   * @return True if the settings ask for them and the scene was loaded
+   * with them.
+   */
+  bool IsQuantized() const { return positionType_ == GL_SHORT; }
+
+  /**
+   * @brief Returns the number of frames drawn since the widget was made.
+   * @return Number of paintGL() calls.
+   */
+  qint64 FramesRendered() const { return framesRendered_; }
+
+  /**
+   * @brief Returns the frame timings of the widget.
+   * @return The profiler measuring every paintGL() call.
+   */
+  const FrameProfiler &Profiler() const { return profiler_; }
+
+  /**
+   * @brief Returns the number of levels of detail of the scene.
+   * @return Levels including the full scene; 0 before they are ready.
+   */
+  size_t LodCount() const { return lods_ ? lods_->size() : 0; }
+
+  /**
+   * @brief Returns the level of detail drawn by the last frame.
+   * @return The level; 0 is the full scene.
+   */
+  size_t CurrentLod() const { return lodLevel_; }
+
+  /**
+   * @brief Returns the triangles of the level drawn by the last frame.
+   * @return Triangle count of that level; 0 before the levels are ready.
+   */
+  size_t LodTriangles() const {
+    return lods_ ? (*lods_)[lodLevel_].triangle_count : 0;
+  }
+
  protected:
   /**
    * @brief Sets the background color for the OpenGL context.
@@ -109,16 +223,31 @@ class Viewport3D : public QOpenGLWidget, protected QOpenGLFunctions {
  private:
   /// Shared pointer to user settings for rendering
   std::shared_ptr<UserSetting> renderSetting_;
+  /// Largest projected error of a level of detail, in pixels
+  static constexpr float kLodPixelError = 1.0f;
+  /// Drawing time per frame before coarser levels are used, in milliseconds
+  static constexpr double kFrameBudgetMs = 1000.0 / 30.0;
+  /// Largest upload per frame while a scene streams in, in bytes
+  static constexpr qint64 kUploadSliceBytes = qint64{32} << 20;
+
   /// Shared pointer to the scene data to be rendered
   std::shared_ptr<s21::DrawSceneData> scene_;
+  /// Levels of detail of the scene; null until they are ready
+  std::shared_ptr<const s21::LodChain> lods_;
+  /// Level of detail in the buffers
+  size_t lodLevel_ = 0;
+  /// Loosens the level of detail while frames are slow
+  s21::FrameBudget frameBudget_{kFrameBudgetMs};
+  /// CPU and GPU time of the frames
+  FrameProfiler profiler_;
 
   // Modern OpenGL members
   /// Vertex Array Object for storing vertex attribute configuration
   QOpenGLVertexArrayObject vao_;
-  /// Vertex Buffer Object for vertex data
-  QOpenGLBuffer vbo_{QOpenGLBuffer::VertexBuffer};
-  /// Element Buffer Object for index data
-  QOpenGLBuffer ebo_{QOpenGLBuffer::IndexBuffer};
+  /// Vertex Buffer Object for vertex data, filled across frames
+  BufferStream vertexStream_{QOpenGLBuffer::VertexBuffer};
+  /// Element Buffer Object for index data, filled after the vertices
+  BufferStream indexStream_{QOpenGLBuffer::IndexBuffer};
   /// Shader program used for rendering
   QOpenGLShaderProgram *shaderProgram_ = nullptr;
 
@@ -128,15 +257,44 @@ class Viewport3D : public QOpenGLWidget, protected QOpenGLFunctions {
   QMatrix4x4 viewMatrix_;
   /// Model transformation matrix
   QMatrix4x4 modelMatrix_;
+  /// Scene parameters modelMatrix_ was built from
+  std::tuple<float, float, float, float, float, float, float, float, float>
+      modelParameters_{0, 0, 0, 0, 0, 0, 1, 1, 1};
 
   /// Flag indicating if the buffer data needs to be updated
   bool needBufferUpdate_ = false;
   /// Number of vertices in the current scene
   int vertexCount_ = 0;
-  /// Number of indices in the current scene
+  /// Number of edge indices in the current scene, over all batches
   int indexCount_ = 0;
   /// Condition to make projection matrix for a 4:3 aspect ratio
   bool isGifRatio_ = false;
+  /// Bytes uploaded to the GPU while drawing the last frame
+  qint64 frameUploadBytes_ = 0;
+  /// Whether signalUploadRejected() was emitted for the current scene
+  bool uploadRejected_ = false;
+  /// Bytes uploaded to the GPU over all frames
+  qint64 totalUploadBytes_ = 0;
+  /// Frames drawn so far
+  qint64 framesRendered_ = 0;
+  /// Component type of the position attribute, GL_FLOAT or GL_SHORT
+  GLenum positionType_ = GL_FLOAT;
+  /// Bytes per position in the vertex buffer
+  GLsizei positionStride_ = sizeof(s21::Vec3f);
+  /// Decoded size of one unit of a stored coordinate, per axis
+  QVector3D positionStep_{1.0f, 1.0f, 1.0f};
+  /// Position a stored zero decodes to
+  QVector3D positionOffset_;
+  /// Largest coordinate error of the uploaded positions
+  float quantizationError_ = 0.0f;
+  /// Whether projectionMatrix_ matches the state below
+  bool projectionValid_ = false;
+  /// Widget size the projection was computed for
+  QSize projectionSize_;
+  /// Aspect mode the projection was computed for
+  bool projectionGifRatio_ = false;
+  /// Projection type the projection was computed for
+  bool projectionParallel_ = false;
 
   /**
    * @brief Initializes the shader program.
@@ -147,18 +305,76 @@ class Viewport3D : public QOpenGLWidget, protected QOpenGLFunctions {
   void InitShaders();
 
   /**
-   * @brief Updates the OpenGL buffer objects with the current scene data.
+   * @brief Returns the data of the level of detail to draw.
+   * @return The level lodLevel_, or the scene without levels.
+   */
+  const s21::DrawSceneData &DrawnScene() const;
+
+  /**
+   * @brief Picks the level of detail for the next frame.
    *
-   * Allocates and uploads vertex and index data to the GPU.
+   * The error of a level is projected at the model origin, using the
+   * largest scale of the model matrix. The level drawn now is kept while
+   * its error stays near the limit, see LodChain::Select(). Changing the
+   * level schedules a buffer update.
+   *
+   * @return Whether the level changed.
+   */
+  bool SelectLod();
+
+  /**
+   * @brief Starts streaming the current scene data to the GPU.
+   *
+   * Hands vertex and index data of the selected level of detail to the
+   * buffer streams, which upload it from this frame on. Positions are
+   * uploaded as floats, or as 16-bit integers that the vertex shader decodes
+   * if the settings ask for quantized positions, halving the vertex buffer.
+   * The integers are encoded by the loader, see DrawSceneData::quantized, so
+   * nothing is converted here.
    */
   void UpdateBuffers();
 
+  /**
+   * @brief Uploads the next slice of the streamed scene data.
+   *
+   * Writes at most kUploadSliceBytes, vertices before indices, and adds the
+   * written size to the frame's upload counter. Until the upload is done,
+   * frames draw the vertices already uploaded and the edge batches whose
+   * indices are complete.
+   */
+  void StreamBuffers();
+
+  /**
+   * @brief Draws the frame timings over the scene if the settings ask for
+   * them.
+   */
+  void DrawTimingOverlay();
+
+  /**
+   * @brief Releases buffers, vertex array, shaders and timer queries of the
+   * context.
+   *
+   * Called before the context is destroyed, for example when the widget
+   * moves to another window; the next initializeGL() creates them again and
+   * the scene is uploaded anew.
+   */
+  void CleanupGL();
+
+  /**
+   * @brief Points the position attribute at the vertex buffer.
+   * @param baseVertex Index of the position the attribute starts at.
+   *
+   * The vertex buffer must be bound.
+   */
+  void SetPositionAttribute(size_t baseVertex);
+
   /**
    * @brief Updates the projection matrix based on the current widget
    * dimensions.
    *
    * Chooses between orthographic and perspective projections based on user
-   * settings.
+   * settings. The matrices are kept if the widget size, aspect mode and
+   * projection type are those they were computed for.
    */
   void UpdateProjectionMatrix();
 };